@@ -8,13 +8,26 @@ struct cmd_arguments
 {
     std::filesystem::path alignment_short_reads_file_path{""};
     std::filesystem::path alignment_long_reads_file_path{""};
+    std::vector<std::filesystem::path> sample_short_reads_file_paths{};
+    std::vector<std::filesystem::path> sample_long_reads_file_paths{};
+    std::filesystem::path genome_file_path{""};
+    std::filesystem::path exclude_file_path{""};
     std::filesystem::path output_file_path{};
-    std::vector<detection_methods> methods{cigar_string, split_read, read_pairs, read_depth};   // default: all methods
+    std::vector<detection_methods> methods{cigar_string, split_read, read_pairs, read_depth};   // default: all methods except soft_clips
     clustering_methods clustering_method{simple_clustering};                                    // default: simple clustering method
     refinement_methods refinement_method{no_refinement};                                        // default: no refinement
     uint64_t min_var_length = 30;
     uint64_t max_var_length = 1000000;
     uint64_t max_tol_inserted_length = 5;
+    uint64_t max_consensus_members = 0;
+    uint64_t max_insert_size = 1000;
+    uint64_t warm_up_pairs = 10000;
+    uint32_t max_depth = 1000;
+    uint16_t threads = 1;
+    uint32_t read_ahead_blocks = 0;
+    uint32_t read_ahead_block_size = 4096;
+    bool genotype = false;
+    std::filesystem::path timings_file_path{};
 };
 
 void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments & args);
@@ -25,9 +38,13 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
  * \param[in] args - command line arguments:\n
  *                   **args.alignment_short_reads_file_path** - short reads input file, path to the sam/bam file\n
  *                   **args.alignment_long_reads_file_path** - long reads input file, path to the sam/bam file\n
+ *                   **args.sample_short_reads_file_paths** - short reads input files of further samples, one per sample\n
+ *                   **args.sample_long_reads_file_paths** - long reads input files of further samples, one per sample\n
+ *                   **args.genome_file_path** - reference genome, path to the FASTA file - *default: REF is N*\n
+ *                   **args.exclude_file_path** - regions excluded from the variant calling, path to the BED file - *default: none*\n
  *                   **args.output_file_path** output file - path for the VCF file - *default: standard output*\n
  *                   **args.methods** - list of methods for detecting junctions
- *                      (1: cigar_string, 2: split_read, 3: read_pairs, 4: read_depth) - *default: all methods*\n
+ *                      (1: cigar_string, 2: split_read, 3: read_pairs, 4: read_depth, 5: soft_clips) - *default: all methods except soft_clips*\n
  *                   **args.clustering_method** - method for clustering junctions
  *                      (0: simple_clustering,
  *                       1: hierarchical_clustering,
@@ -39,12 +56,28 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
  *                       2: sVirl_refinement_method) - *default: no refinement*\n
  *                   **args.min_var_length** - minimum length of variants to detect - *default: 30 bp*\n
  *                   **args.max_var_length** - maximum length of variants to detect - *default: 1,000,000 bp*\n
- *                   **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*
+ *                   **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*\n
+ *                   **args.max_consensus_members** - maximum number of inserted sequences aligned for the consensus of an insertion, 0 for no consensus - *default: 0*\n
+ *                   **args.max_insert_size** - maximum insert size of the read pairs of a read group during its warm-up - *default: 1000 bp*\n
+ *                   **args.warm_up_pairs** - number of proper read pairs of a read group before its maximum insert size is learned - *default: 10,000*\n
+ *                   **args.max_depth** - read depth above which the alignments are downsampled, 0 for no downsampling - *default: 1000*\n
+ *                   **args.threads** - number of threads for the detection, the clustering, the refinement, the insertion consensus and the output - *default: 1*\n
+ *                   **args.read_ahead_blocks** - number of blocks of each alignment file that are read ahead, 0 for no read-ahead - *default: 0*\n
+ *                   **args.read_ahead_block_size** - size of the blocks that are read ahead in KiB - *default: 4096 KiB*\n
+ *                   **args.genotype** - whether to count the reads supporting the reference and output genotypes - *default: false*\n
+ *                   **args.timings_file_path** - path for the TSV file with the wall time of each stage - *default: none*
  *
  *
  * \details Detects novel junctions from read alignment records using different detection methods.
+ *          Alignments starting in excluded regions are skipped and junctions with a breakend in them are dropped.
+ *          With several samples, the alignment files of the samples are read in parallel and their junctions are
+ *          clustered jointly, so every variant is reported with the reads supporting it in each sample.
  *          The junctions are clustered using one of several clustering methods.
- *          Then, the junction clusters are refined using one of several refinement methods.
+ *          Then, the junction clusters are refined using one of several refinement methods. The sViper refinement
+ *          method realigns the reads at the breakpoints against the reference genome, the sVirl refinement method
+ *          assembles them and compares the contigs with the reference genome. Both require the reference genome.
+ *          If enabled, the consensus of the inserted sequences of each insertion is computed for the ALT column and
+ *          the reads spanning the breakpoints without supporting the variant are counted for the genotypes.
  *          Finally, the refined junction clusters are categorized into different variant classes
  *          and output in VCF format.
  */
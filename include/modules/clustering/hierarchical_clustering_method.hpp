@@ -36,9 +36,16 @@ int junction_distance(Junction const & lhs, Junction const & rhs);
 
 /*! \brief Cluster junctions by an hierarchical clustering method.
  *         The returned clusters and the junctions in each returned cluster are sorted.
+ *         The distance matrix, dendrogram and labels of a partition are taken from an arena that is reset for the
+ *         next partition, so the heap is only used again when a partition is larger than all previous ones. Only
+ *         these buffers are arena-backed: the junctions, their breakends and the returned clusters use the heap.
+ *         The partitions are clustered in parallel by a WorkStealingScheduler, largest first, and every worker has its
+ *         own arena. The result does not depend on the number of threads.
  *
  * \param[in] junctions - a vector of junctions (needs to be sorted)
  * \param[in] clustering_cutoff - distance cutoff for clustering
+ * \param[in] threads - number of threads (default 1)
  */
 std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> const & junctions,
-                                                    double clustering_cutoff);
+                                                    double clustering_cutoff,
+                                                    uint16_t const threads = 1);
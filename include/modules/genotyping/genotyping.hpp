@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+
+#include "structures/cluster.hpp"   // for class Cluster
+
+/*! \brief A breakpoint of a deletion or insertion at which the reads that support the reference are counted.
+ *
+ * \param cluster_id    - index of the cluster in the vector of clusters
+ * \param ref_name      - reference/chromosome name
+ * \param position      - 0-based position of the base after the breakpoint
+ */
+struct GenotypingSite
+{
+    size_t cluster_id{};
+    std::string ref_name{};
+    int32_t position{};
+};
+
+/*! \brief Returns the breakpoints of the deletion and insertion clusters: both breakpoints of a deletion and the
+ *         single breakpoint of an insertion.
+ *
+ * \param[in] clusters          - junction clusters
+ * \param[in] min_var_length    - minimum length of variants
+ * \param[in] max_var_length    - maximum length of variants
+ */
+std::vector<GenotypingSite> extract_genotyping_sites(std::vector<Cluster> const & clusters,
+                                                     uint64_t const min_var_length,
+                                                     uint64_t const max_var_length);
+
+/*! \brief Counts the reads that span each site without supporting a variant in a single pass over a coordinate-sorted
+ *         alignment file.
+ *
+ * \param[in]       alignment_file_path - path to the sorted sam/bam file of the reads
+ * \param[in, out]  sites               - genotyping sites, they are sorted like the alignment file
+ * \param[in]       min_var_length      - minimum length of a deletion or insertion in a read to count as variant
+ * \param[in]       min_overhang        - minimum number of aligned reference bases on both sides of the site
+ *
+ * \returns The number of reads supporting the reference for each site (in the order of the sorted sites).
+ *
+ * \details A read supports the reference at a site if its primary alignment covers at least `min_overhang` bases on
+ *          both sides of the site and has no deletion or insertion of at least `min_var_length` bases within this
+ *          distance. Reads that support the variant end at the site in a clip or have such an indel, so they are not
+ *          counted.
+ *
+ *          Only the fields that are needed for this are read and each record is decoded once for all sites it
+ *          overlaps: its large indels are collected once and checked against every site in its range. Sites are only
+ *          looked up while they can still be spanned, so the pass is linear in the number of alignments and sites.
+ */
+std::vector<size_t> count_reference_support(std::filesystem::path const & alignment_file_path,
+                                            std::vector<GenotypingSite> & sites,
+                                            uint64_t const min_var_length,
+                                            int32_t const min_overhang);
+
+/*! \brief Counts the reads supporting the reference for all deletion and insertion clusters in every sample and
+ *         stores them in the clusters.
+ *
+ * \param[in, out]  clusters            - junction clusters
+ * \param[in]       alignment_file_paths - paths to the sorted sam/bam files of the reads, one per sample
+ * \param[in]       min_var_length      - minimum length of variants
+ * \param[in]       max_var_length      - maximum length of variants
+ * \param[in]       threads             - number of threads, the samples are counted in parallel
+ * \param[in]       min_overhang        - minimum number of aligned reference bases on both sides of a breakpoint
+ *
+ * \details The reference support of a deletion is the larger count of its two breakpoints, so that reads spanning
+ *          both breakpoints are only counted once.
+ */
+void genotype_clusters(std::vector<Cluster> & clusters,
+                       std::vector<std::filesystem::path> const & alignment_file_paths,
+                       uint64_t const min_var_length,
+                       uint64_t const max_var_length,
+                       uint16_t const threads,
+                       int32_t const min_overhang = 20);
+
+/*! \brief Returns the VCF genotype of a variant from the numbers of reads supporting the reference and the variant.
+ *
+ * \param[in] reference_support - number of reads supporting the reference
+ * \param[in] variant_support   - number of reads supporting the variant
+ *
+ * \details The genotype is homozygous reference (0/0) for a variant allele fraction below 0.2, homozygous variant (1/1)
+ *          for at least 0.8 and heterozygous (0/1) in between. Without reads, the genotype is unknown (./.).
+ */
+std::string genotype(size_t const reference_support, size_t const variant_support);
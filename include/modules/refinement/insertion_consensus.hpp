@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+#include "structures/cluster.hpp"   // for class Cluster
+
+/*! \brief Returns the consensus of the inserted sequences of an insertion.
+ *
+ * \param[in] inserted_sequences    - inserted sequences of the members of an insertion cluster
+ * \param[in] max_members           - maximum number of inserted sequences that are aligned
+ *
+ * \details Up to `max_members` non-empty sequences whose lengths are closest to the median length are selected. The
+ *          sequence of median length is the backbone, all others are aligned to it with a banded global alignment.
+ *          From the pileup on the backbone, a base is kept if most sequences contain it and the most frequent inserted
+ *          sequence between two backbone bases is added if most sequences contain an insertion there. The consensus of
+ *          this first round is the backbone of a second round, which removes the errors of the first backbone.
+ *
+ *          The band covers the difference of the lengths plus a tenth of the backbone length, so the runtime is linear
+ *          in the length of the insertion for a bounded error rate.
+ */
+seqan3::dna5_vector insertion_consensus(std::vector<seqan3::dna5_vector> inserted_sequences, size_t const max_members);
+
+/*! \brief Computes the consensus of the inserted sequences of all insertion clusters in parallel and stores it as their
+ *         refined inserted sequence.
+ *
+ * \param[in, out]  clusters        - junction clusters
+ * \param[in]       min_var_length  - minimum length of insertions
+ * \param[in]       max_members     - maximum number of inserted sequences that are aligned per cluster
+ * \param[in]       threads         - number of threads
+ *
+ * \details Insertion clusters are clusters with adjacent forward mates and an inserted sequence of at least
+ *          `min_var_length` bases. Clusters whose inserted sequence was already found by a refinement method keep it.
+ *          Every thread takes the next cluster, so large clusters do not hold up the other threads.
+ */
+void compute_insertion_consensus(std::vector<Cluster> & clusters,
+                                 uint64_t const min_var_length,
+                                 size_t const max_members,
+                                 uint16_t const threads);
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <functional>   // for std::function
+#include <vector>
+
+#include <seqan3/alphabet/cigar/cigar.hpp>
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+
+#include "structures/cluster.hpp"           // for class Cluster
+#include "structures/indexed_fasta.hpp"     // for class IndexedFasta
+
+/*! \brief The reference sequence around the breakpoints of a junction cluster.
+ *
+ * \param cluster_id        - index of the cluster in the vector of clusters
+ * \param ref_name          - reference/chromosome name
+ * \param start             - 0-based start position of the window on the reference
+ * \param is_insertion      - whether the cluster is an insertion (otherwise it is a deletion)
+ * \param expected_length   - length of the variant before the refinement
+ * \param sequence          - reference sequence of the window
+ */
+struct RefinementWindow
+{
+    size_t cluster_id{};
+    std::string ref_name{};
+    int32_t start{};
+    bool is_insertion{};
+    int32_t expected_length{};
+    seqan3::dna5_vector sequence{};
+
+    //!\brief Returns the 0-based end position (exclusive) of the window on the reference.
+    int32_t end() const
+    {
+        return start + static_cast<int32_t>(sequence.size());
+    }
+};
+
+/*! \brief The part of a read that covers (a part of) a refinement window.
+ *
+ * \param window_id - index of the refinement window
+ * \param sequence  - the bases of the read that are aligned to the window, including soft clipped bases
+ */
+struct ReadSegment
+{
+    size_t window_id{};
+    seqan3::dna5_vector sequence{};
+};
+
+/*! \brief Returns the part of a read that is aligned to the reference interval [begin, end), extended into the soft
+ *         clipped bases at both ends, as a pair of query positions. If the alignment does not overlap the interval,
+ *         both positions are equal.
+ *
+ * \param[in] pos   - POS field of the SAM/BAM file
+ * \param[in] cigar - CIGAR field of the SAM/BAM file
+ * \param[in] begin - 0-based start position of the reference interval
+ * \param[in] end   - 0-based end position (exclusive) of the reference interval
+ */
+std::pair<int32_t, int32_t> query_interval(int32_t const pos,
+                                           std::vector<seqan3::cigar> const & cigar,
+                                           int32_t const begin,
+                                           int32_t const end);
+
+/*! \brief Extracts the reference windows around the deletion and insertion clusters.
+ *
+ * \param[in] clusters          - junction clusters
+ * \param[in] reference         - reference genome
+ * \param[in] min_var_length    - minimum length of variants to refine
+ * \param[in] max_var_length    - maximum length of variants to refine, bounds the size of the windows
+ * \param[in] flank_length      - number of bases on both sides of the variant that belong to the window
+ *
+ * \details Clusters whose sequence is not part of the reference are skipped.
+ */
+std::vector<RefinementWindow> extract_refinement_windows(std::vector<Cluster> const & clusters,
+                                                         IndexedFasta const & reference,
+                                                         uint64_t const min_var_length,
+                                                         int32_t const max_var_length,
+                                                         int32_t const flank_length);
+
+/*! \brief Collects the segments of the reads that overlap the refinement windows in a single pass over a
+ *         coordinate-sorted alignment file.
+ *
+ * \param[in]       alignment_file_path     - path to the sorted sam/bam file of the reads
+ * \param[in, out]  windows                 - refinement windows, they are sorted like the alignment file and windows
+ *                                            on sequences that are not part of the alignment file are removed
+ * \param[in]       max_reads_per_window    - maximum number of read segments per window
+ * \param[in]       min_segment_length      - minimum length of a read segment
+ * \param[in]       add_read_segment        - called for every read segment, in the order of the alignment file
+ *
+ * \details Only primary alignments are used, filtered like in the detection (unmapped, duplicates and alignments with
+ *          low mapping quality are skipped). Windows are only looked up while the stream is at most the length of the
+ *          longest window behind their start, so the pass is linear in the number of alignments.
+ */
+void collect_read_segments(std::filesystem::path const & alignment_file_path,
+                           std::vector<RefinementWindow> & windows,
+                           size_t const max_reads_per_window,
+                           uint64_t const min_segment_length,
+                           std::function<void(ReadSegment &&)> const & add_read_segment);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+
+#include "modules/refinement/refinement_windows.hpp"    // for struct RefinementWindow and ReadSegment
+#include "structures/cluster.hpp"                       // for class Cluster
+#include "structures/indexed_fasta.hpp"                 // for class IndexedFasta
+
+/*! \brief The variant found by realigning a read segment against its refinement window.
+ *
+ * \param window_id - index of the refinement window
+ * \param position  - 0-based reference position of the first deleted base or of the base after the inserted sequence
+ * \param length    - number of deleted or inserted bases
+ */
+struct RealignedBreakpoint
+{
+    size_t window_id{};
+    int32_t position{};
+    int32_t length{};
+};
+
+/*! \brief Realigns a batch of read segments against their refinement windows and returns the variants found.
+ *
+ * \param[in]       windows         - refinement windows
+ * \param[in, out]  read_segments   - read segments to realign, they are sorted by length
+ * \param[in]       threads         - number of threads for the alignments
+ *
+ * \details All read segments are aligned in one call of seqan3::align_pairwise with inter-sequence vectorisation,
+ *          i.e. the alignments are computed in parallel in the lanes of SIMD registers, and the chunks of alignments are
+ *          distributed over a thread pool. The read segments are sorted by the lengths of their sequences beforehand,
+ *          so that the alignments that share the SIMD registers are of similar size.
+ *
+ *          The read segment is aligned globally and the reference window with free end gaps. The longest gap in the
+ *          read (for deletions) or in the reference (for insertions) is reported if its length is at least half and at
+ *          most twice the expected length of the variant.
+ */
+std::vector<RealignedBreakpoint> realign_read_segments(std::vector<RefinementWindow> const & windows,
+                                                       std::vector<ReadSegment> & read_segments,
+                                                       uint16_t const threads);
+
+/*! \brief Refines the breakpoints of deletion and insertion clusters by realigning the reads at their breakpoints
+ *         against the reference (similar to sViper).
+ *
+ * \param[in, out]  clusters                - junction clusters, refined clusters get refined mates
+ * \param[in]       alignment_file_path     - path to the sorted sam/bam file of the reads
+ * \param[in]       reference               - reference genome
+ * \param[in]       threads                 - number of threads for the alignments
+ * \param[in]       min_var_length          - minimum length of variants to refine
+ * \param[in]       max_var_length          - maximum length of variants to refine, bounds the size of the alignments
+ * \param[in]       flank_length            - number of bases on both sides of the variant that are realigned
+ * \param[in]       max_reads_per_cluster   - maximum number of reads that are realigned for a cluster
+ * \param[in]       min_support             - minimum number of reads that have to confirm the variant
+ * \param[in]       batch_size              - number of read segments that are realigned at once
+ *
+ * \details For every deletion or insertion cluster, a window of the reference around the variant is extracted (see
+ *          extract_refinement_windows()). In a single pass over the coordinate-sorted alignment file, the segments of
+ *          the reads that overlap a window are collected (see collect_read_segments()) and realigned in large batches
+ *          (see realign_read_segments()). The refined breakends of a cluster are the median position and length of the
+ *          variants found in its reads.
+ */
+void sViper_refinement_method(std::vector<Cluster> & clusters,
+                              std::filesystem::path const & alignment_file_path,
+                              IndexedFasta const & reference,
+                              uint16_t const threads,
+                              uint64_t const min_var_length,
+                              int32_t const max_var_length = 2000,
+                              int32_t const flank_length = 200,
+                              size_t const max_reads_per_cluster = 30,
+                              size_t const min_support = 2,
+                              size_t const batch_size = 4096);
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <optional>     // for std::optional
+#include <vector>
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+#include <seqan3/std/span>          // for std::span
+
+#include "modules/refinement/refinement_windows.hpp"    // for struct RefinementWindow and ReadSegment
+#include "structures/arena.hpp"                         // for class Arena
+#include "structures/cluster.hpp"                       // for class Cluster
+#include "structures/indexed_fasta.hpp"                 // for class IndexedFasta
+
+/*! \brief A variant found by the local assembly of the reads of a refinement window.
+ *
+ * \param position          - 0-based reference position of the first deleted base or of the base after the inserted
+ *                            sequence
+ * \param deleted_length    - number of deleted reference bases
+ * \param inserted_sequence - sequence inserted instead of the deleted bases
+ */
+struct AssembledVariant
+{
+    int32_t position{};
+    int32_t deleted_length{};
+    seqan3::dna5_vector inserted_sequence{};
+};
+
+/*! \brief Assembles the read segments of a refinement window with a de Bruijn graph and compares the contig with the
+ *         reference.
+ *
+ * \details The k-mers of the read segments are counted in an open addressing hash table, which is the de Bruijn graph:
+ *          the successors of a k-mer are looked up by appending each base. The contig starts at the first k-mer of the
+ *          reference window that occurs at least `min_kmer_count` times in the reads and is extended by the most
+ *          frequent successor until there is none or the contig runs into a cycle.
+ *
+ *          The left breakpoint is the end of the common prefix of the contig and the reference. The right breakpoint is
+ *          found from the last k-mer of the contig that occurs exactly once in the reference window, extended to the
+ *          left as long as contig and reference match.
+ *
+ *          All memory of the graph is taken from an arena that is reset for every window, so one assembler per thread
+ *          can assemble any number of windows without allocating from the heap once the arena is large enough.
+ */
+class LocalAssembler
+{
+private:
+    //!\brief An entry of the k-mer hash table.
+    struct KmerEntry
+    {
+        uint64_t kmer;
+        uint32_t count;
+        uint32_t value;
+    };
+
+    //!\brief An open addressing hash table of k-mers with a power of two size, its memory is taken from the arena.
+    using KmerTable = std::vector<KmerEntry, ArenaAllocator<KmerEntry>>;
+
+    //!\brief Returns the entry of the k-mer or the empty entry where it would be inserted (linear probing).
+    static KmerEntry & find_slot(KmerTable & table, uint64_t const kmer);
+
+    uint8_t k;
+    uint32_t min_kmer_count;
+    uint64_t kmer_mask;
+    Arena arena{};
+
+public:
+    /*! \brief Construct a local assembler.
+     *
+     * \param[in] k                 - length of the k-mers, at most 31
+     * \param[in] min_kmer_count    - minimum number of occurrences of a k-mer in the reads to be part of the contig
+     */
+    LocalAssembler(uint8_t const k = 25, uint32_t const min_kmer_count = 2);
+
+    /*! \brief Assembles the read segments of a window and returns the variant that the contig shows, if any.
+     *
+     * \param[in] window        - refinement window
+     * \param[in] read_segments - read segments of the window
+     */
+    std::optional<AssembledVariant> assemble(RefinementWindow const & window,
+                                             std::span<ReadSegment const> const read_segments);
+
+    //!\brief Returns the number of bytes that the arena of the assembler holds.
+    size_t get_arena_capacity() const
+    {
+        return arena.capacity();
+    }
+};
+
+/*! \brief Refines the breakpoints and inserted sequences of deletion and insertion clusters by the local assembly of
+ *         the reads at their breakpoints (similar to sVirl).
+ *
+ * \param[in, out]  clusters                - junction clusters, refined clusters get refined mates and inserted
+ *                                            sequences
+ * \param[in]       alignment_file_path     - path to the sorted sam/bam file of the reads
+ * \param[in]       reference               - reference genome
+ * \param[in]       threads                 - number of threads for the assembly
+ * \param[in]       min_var_length          - minimum length of variants to refine
+ * \param[in]       max_var_length          - maximum length of variants to refine, bounds the size of the graphs
+ * \param[in]       flank_length            - number of bases on both sides of the variant that are assembled
+ * \param[in]       max_reads_per_cluster   - maximum number of reads that are assembled for a cluster
+ *
+ * \details The read segments of all windows are collected in a single pass over the alignment file (see
+ *          collect_read_segments()). Then, the windows are assembled in parallel, every thread takes the next window
+ *          and uses its own LocalAssembler. The variant of a contig refines its cluster if it has the type of the
+ *          cluster and at least half and at most twice its length.
+ */
+void sVirl_refinement_method(std::vector<Cluster> & clusters,
+                             std::filesystem::path const & alignment_file_path,
+                             IndexedFasta const & reference,
+                             uint16_t const threads,
+                             uint64_t const min_var_length,
+                             int32_t const max_var_length = 2000,
+                             int32_t const flank_length = 200,
+                             size_t const max_reads_per_cluster = 30);
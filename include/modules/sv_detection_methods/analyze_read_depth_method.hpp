@@ -0,0 +1,115 @@
+#pragma once
+
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+#include "structures/junction.hpp"          // for class Junction
+#include "structures/quantile_sketch.hpp"   // for class QuantileSketch
+
+/*! \brief Detects junctions from changes of the read depth in a single pass over a coordinate-sorted alignment file.
+ *
+ * \details The reference is divided into bins of `bin_size` bases and the depth of a bin is the number of aligned bases
+ *          in it, i.e. the sum of the overlaps with the reference spans [start, end) of all alignments. An alignment is
+ *          added in constant time to two difference arrays over the bins: one counts the alignments that cover a
+ *          bin completely, the other corrects the bins with the start and the end of the alignment by the bases
+ *          outside of the alignment:
+ *
+ *              coverage_differences[bin(start)] += 1       partial_bin_corrections[bin(start)] -= start % bin_size
+ *              coverage_differences[bin(end)]   -= 1       partial_bin_corrections[bin(end)]   += end % bin_size
+ *
+ *          The depth of bin i is then bin_size * prefix_sum(coverage_differences)[i] + partial_bin_corrections[i].
+ *
+ *          Because the alignments are sorted by their start, no later alignment changes a bin before the start of the
+ *          current one. The difference arrays only hold the window of bins from there to the end of the longest
+ *          pending alignment. Finished bins are resolved in chunks and appended to the depths of the chromosome, so
+ *          that the memory is bounded by the chromosome length divided by the bin size. The resolved bins are not
+ *          erased from the front of the difference arrays one chunk at a time. The window only moves forward, and the
+ *          arrays are compacted once the resolved bins outnumber the pending ones, so every bin is moved at most once
+ *          on average.
+ *
+ *          The prefix sum over a chunk is a sequential std::partial_sum, only the computation of the depths from it is
+ *          a loop that the compiler can vectorize.
+ *
+ *          When a chromosome is finished, its bins are compared to the median depth of the chromosome. Runs of at least
+ *          `min_segment_bins` bins with a depth below `loss_ratio` * median are reported as deletions. Runs at the ends
+ *          of the chromosome and chromosomes with a median depth below `min_median_depth` are skipped. Gains of depth
+ *          are not reported, as the output has no record for tandem duplications.
+ */
+class ReadDepthDetector
+{
+private:
+    //!\brief Minimum number of finished bins that are resolved at once.
+    static constexpr size_t flush_chunk_size{1024};
+
+    int32_t bin_size;
+    size_t min_segment_bins;
+    double loss_ratio;
+    double min_median_depth;
+
+    int32_t ref_id{-1};
+    std::string ref_name{};
+    //!\brief Index of the first bin of the window on the chromosome.
+    size_t window_start{0};
+    //!\brief Index of the first bin of the window in the difference arrays, the entries before it are resolved.
+    size_t window_offset{0};
+    std::vector<int32_t> coverage_differences{};
+    std::vector<int32_t> partial_bin_corrections{};
+    //!\brief Number of alignments that cover the bin before the window completely.
+    int32_t covering_alignments{0};
+    //!\brief Depths of all finished bins of the current chromosome.
+    std::vector<uint32_t> bin_depths{};
+    QuantileSketch depth_distribution{};
+
+    //!\brief Resolves the depth of the first `number_of_bins` bins of the window and removes them from the window.
+    void flush_bins(size_t const number_of_bins);
+
+    //!\brief Resolves all bins of the current chromosome and reports its depth changes.
+    void finish_chromosome(std::vector<Junction> & junctions);
+
+public:
+    /*! \brief Construct a read depth detector.
+     *
+     * \param[in] bin_size          - number of bases per bin
+     * \param[in] min_segment_bins  - minimum number of consecutive bins of a depth change
+     * \param[in] loss_ratio        - bins with a depth below loss_ratio * median are candidates for deletions
+     * \param[in] min_median_depth  - minimum median read depth of a chromosome to call depth changes
+     */
+    ReadDepthDetector(int32_t const bin_size = 100,
+                      size_t const min_segment_bins = 3,
+                      double const loss_ratio = 0.65,
+                      double const min_median_depth = 5.0) :
+        bin_size{bin_size},
+        min_segment_bins{min_segment_bins},
+        loss_ratio{loss_ratio},
+        min_median_depth{min_median_depth}
+    {}
+
+    /*! \brief Process the next alignment. The alignments have to be added in coordinate order.
+     *
+     * \param[in]       ref_id      - RNAME field of the SAM/BAM file as index of the reference
+     * \param[in]       ref_name    - RNAME field of the SAM/BAM file
+     * \param[in]       start       - start position of the alignment on the reference (0-based)
+     * \param[in]       end         - end position of the alignment on the reference (exclusive)
+     * \param[in, out]  junctions   - vector for storing junctions, filled when a chromosome is finished
+     */
+    void add_alignment(int32_t const ref_id,
+                       std::string const & ref_name,
+                       int32_t const start,
+                       int32_t const end,
+                       std::vector<Junction> & junctions);
+
+    /*! \brief Reports the depth changes of the last chromosome. Call this after the last alignment.
+     *
+     * \param[in, out]  junctions   - vector for storing junctions
+     */
+    void finish(std::vector<Junction> & junctions)
+    {
+        finish_chromosome(junctions);
+    }
+
+    //!\brief Returns the depths (aligned bases per bin) of the resolved bins of the current chromosome.
+    std::vector<uint32_t> const & get_bin_depths() const
+    {
+        return bin_depths;
+    }
+};
@@ -1,3 +1,166 @@
 #pragma once
 
-void analyze_read_pair();
+#include <functional>       // for std::greater
+#include <queue>            // for std::priority_queue
+#include <tuple>            // for std::tie
+#include <unordered_map>    // for std::unordered_map
+
+#include "structures/aligned_segment.hpp"   // for struct AlignedSegment
+#include "structures/junction.hpp"          // for class Junction
+#include "structures/quantile_sketch.hpp"   // for class QuantileSketch
+
+/*! \brief The settings of the insert size learning of a ReadPairDetector.
+ *
+ * \param default_max_insert_size   - maximum insert size of read groups that are still in their warm-up
+ * \param warm_up_pairs             - number of pairs per read group before the learned maximum is used
+ */
+struct ReadPairOptions
+{
+    uint64_t default_max_insert_size = 1000;
+    uint64_t warm_up_pairs = 10'000;
+};
+
+/*! \brief Detects junctions from discordant read pairs in a single pass over a coordinate-sorted alignment file.
+ *
+ * \details The first read of a pair that is seen in the file is kept in a cache of pending mates keyed by its read
+ *          name, if its own fields and the mate fields (RNEXT, PNEXT, flag 0x20) indicate a discordant pair. When the
+ *          mate arrives, both are compared and a junction is emitted for pairs with
+ *          - mates on different chromosomes,
+ *          - an abnormal orientation (both mates on the same strand, or the reverse mate in front of the forward one),
+ *          - a distance larger than the maximum insert size of the read group.
+ *
+ *          Like the segments of a split read, the junction connects the end of the leftmost read with the start of
+ *          the reverse complemented mate.
+ *
+ *          Pairs that look concordant from the first read are never cached. Cached reads are evicted as soon as the
+ *          stream has passed the position of their mate (e.g. because the mate was filtered), and the cache never
+ *          holds more than `max_cache_size` reads, so that the memory stays bounded for high coverage files.
+ *
+ *          When the alignments are downsampled, the caller decides once per pair by the read that is seen first (see
+ *          has_pending_mate()): a dropped first read is not cached, and the junction of a pair gets the sampling rate
+ *          of its cached read, whatever the depth at the mate.
+ *
+ *          The maximum insert size is learned per read group (RG tag) from the template lengths of proper
+ *          forward-reverse pairs (flag 0x2) on the same chromosome, which are added to a QuantileSketch. After
+ *          `warm_up_pairs` pairs of a read group, the maximum insert size is the upper Tukey fence Q3 + 3 * IQR of its
+ *          distribution and it is updated while streaming. Before, the given default is used.
+ */
+class ReadPairDetector
+{
+private:
+    //!\brief A read waiting for its mate.
+    struct PendingMate
+    {
+        AlignedSegment segment;
+        int32_t ref_id;
+        double sampling_rate;
+    };
+
+    //!\brief The expected mate position of a cached read, ordered for eviction.
+    struct EvictionEntry
+    {
+        int32_t mate_ref_id;
+        int32_t mate_pos;
+        std::string read_name;
+
+        bool operator>(EvictionEntry const & other) const
+        {
+            return std::tie(mate_ref_id, mate_pos) > std::tie(other.mate_ref_id, other.mate_pos);
+        }
+    };
+
+    //!\brief The insert size distribution of a read group.
+    struct ReadGroupStatistics
+    {
+        QuantileSketch insert_sizes{};
+        uint64_t max_insert_size;
+    };
+
+    uint64_t default_max_insert_size;
+    uint64_t warm_up_pairs;
+    size_t max_cache_size;
+    std::unordered_map<std::string, ReadGroupStatistics> read_groups{};
+    std::unordered_map<std::string, PendingMate> pending_mates{};
+    std::priority_queue<EvictionEntry, std::vector<EvictionEntry>, std::greater<EvictionEntry>> eviction_queue{};
+    size_t number_of_evicted_reads{0};
+    size_t number_of_dropped_reads{0};
+
+    //!\brief Removes all cached reads whose mate position lies before the given position.
+    void evict_passed_mates(int32_t const ref_id, int32_t const pos);
+
+    //!\brief Adds a template length to the distribution of the read group and updates its maximum insert size.
+    void add_insert_size(ReadGroupStatistics & statistics, uint64_t const template_length);
+
+public:
+    /*! \brief Construct a read pair detector.
+     *
+     * \param[in] default_max_insert_size   - maximum insert size of read groups that are still in their warm-up
+     * \param[in] warm_up_pairs             - number of pairs per read group before the learned maximum is used
+     * \param[in] max_cache_size            - maximum number of reads waiting for their mate
+     */
+    ReadPairDetector(uint64_t const default_max_insert_size,
+                     uint64_t const warm_up_pairs = 10'000,
+                     size_t const max_cache_size = 1'000'000) :
+        default_max_insert_size{default_max_insert_size},
+        warm_up_pairs{warm_up_pairs},
+        max_cache_size{max_cache_size}
+    {}
+
+    /*! \brief Process the next primary alignment of a read pair. The alignments have to be added in coordinate order.
+     *
+     * \param[in]       read_name   - QNAME field of the SAM/BAM file
+     * \param[in]       read_group  - RG tag of the read, empty if there is none
+     * \param[in]       segment     - alignment of the read
+     * \param[in]       ref_id      - RNAME field of the SAM/BAM file as index of the reference
+     * \param[in]       mate_ref_id - RNEXT field of the SAM/BAM file as index of the reference
+     * \param[in]       mate_pos    - PNEXT field of the SAM/BAM file
+     * \param[in]       mate_orientation - orientation of the mate (flag 0x20)
+     * \param[in]       template_length  - TLEN field of the SAM/BAM file
+     * \param[in]       is_proper_pair   - whether the aligner flagged the pair as properly aligned (flag 0x2), only
+     *                                     proper pairs are used to learn the insert sizes
+     * \param[in, out]  junctions   - vector for storing junctions
+     * \param[in]       sampling_rate    - sampling rate of the read if it is the first one of its pair, stored in the
+     *                                     junction of the pair
+     */
+    void add_alignment(std::string const & read_name,
+                       std::string const & read_group,
+                       AlignedSegment const & segment,
+                       int32_t const ref_id,
+                       int32_t const mate_ref_id,
+                       int32_t const mate_pos,
+                       strand const mate_orientation,
+                       int32_t const template_length,
+                       bool const is_proper_pair,
+                       std::vector<Junction> & junctions,
+                       double const sampling_rate = 1.0);
+
+    //!\brief Returns whether the mate of the read is cached, i.e. whether the read is the second one of its pair.
+    bool has_pending_mate(std::string const & read_name) const
+    {
+        return pending_mates.find(read_name) != pending_mates.end();
+    }
+
+    //!\brief Returns the maximum insert size that is currently used for the read group.
+    uint64_t get_max_insert_size(std::string const & read_group) const;
+
+    //!\brief Returns the insert size distribution of the read group, or nullptr if it was not seen yet.
+    QuantileSketch const * get_insert_sizes(std::string const & read_group) const;
+
+    //!\brief Returns the number of reads waiting for their mate.
+    size_t get_cache_size() const
+    {
+        return pending_mates.size();
+    }
+
+    //!\brief Returns the number of reads that were evicted because their mate was not found at the expected position.
+    size_t get_number_of_evicted_reads() const
+    {
+        return number_of_evicted_reads;
+    }
+
+    //!\brief Returns the number of reads that were not cached because the cache was full.
+    size_t get_number_of_dropped_reads() const
+    {
+        return number_of_dropped_reads;
+    }
+};
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <string_view>
+
+#include <seqan3/std/span>
+
 #include "structures/aligned_segment.hpp"   // for struct AlignedSegment
 
 /*! \brief Splits a string by a given delimiter and stores substrings in a given container.
@@ -25,22 +29,24 @@ void split_string(std::string const & str, Container & cont, char const delim =
  *          Each element (in parentheses) represents one alignment segment of the chimeric alignment formatted as
  *          a colon-delimited list.
  *          We add all segments to our candidate list `aligned_segments` and examine them in the following function
- *          `analyze_aligned_segments()`.
+ *          `analyze_aligned_segments()`. Elements with a wrong format are reported and skipped.
+ *
+ *          The tag is parsed in a single pass without copying its fields.
  *
  *          For more information about this tag, see the
  *          [Map Optional Fields Specification](https://samtools.github.io/hts-specs/SAMtags.pdf)
  *          (last access 09.04.2021).
  */
-void retrieve_aligned_segments(std::string const & sa_string, std::vector<AlignedSegment> & aligned_segments);
+void retrieve_aligned_segments(std::string_view const sa_string, std::vector<AlignedSegment> & aligned_segments);
 
 /*! \brief Build junctions out of aligned_segments.
  *
- * \param[in]       aligned_segments    - vector of [aligned_segments](\ref AlignedSegment)
+ * \param[in]       aligned_segments    - [aligned_segments](\ref AlignedSegment) sorted by their query position
  * \param[in, out]  junctions           - vector for storing junctions
  * \param[in, out]  query_sequence      - SEQ field of the SAM/BAM file
  * \param[in]       read_name           - QNAME field of the SAM/BAM file
  */
-void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segments,
+void analyze_aligned_segments(std::span<AlignedSegment const> const aligned_segments,
                               std::vector<Junction> & junctions,
                               seqan3::dna5_vector const & query_sequence,
                               std::string const & read_name);
@@ -58,6 +64,9 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
  * \param[in]       seq         - SEQ field of the SAM/BAM file
  * \param[in]       sa_tag      - SA tag, one tag from the read of the SAM/BAM file
  * \param[in, out]  junctions   - vector for storing junctions
+ *
+ * \details The aligned segments are stored in a thread local buffer that is reused for all reads, so that no memory is
+ *          allocated once the buffer has grown to the largest number of segments per read.
  */
 void analyze_sa_tag(std::string const & query_name,
                     seqan3::sam_flag const & flag,
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <deque>            // for std::deque
+#include <functional>       // for std::greater
+#include <queue>            // for std::priority_queue
+
+#include "structures/aligned_segment.hpp"   // for struct AlignedSegment
+#include "structures/junction.hpp"          // for class Junction
+
+/*! \brief Detects junctions from piles of soft clipped reads in a single pass over a coordinate-sorted alignment file.
+ *
+ * \details Reads that are not split-aligned still show a breakpoint as a soft clip: the reads to the left of a
+ *          breakpoint are clipped at their end (right clip), the reads to the right of it are clipped at their start
+ *          (left clip). The clip positions of all alignments with at least `min_clip_length` clipped bases are streamed
+ *          into one pileup per side, which collects clip positions that are at most `cluster_distance` bases apart. A
+ *          pileup is closed as soon as the stream has passed it. If it is supported by at least `min_support` reads,
+ *          its mean position becomes a breakpoint candidate.
+ *
+ *          Left clips arrive sorted with the alignment starts. Right clips are kept in a min-heap until the stream has
+ *          passed them, because no later alignment ends before its own start.
+ *
+ *          A junction is reported for two candidates with clips on different sides that are between `min_var_length`
+ *          and `max_pair_distance` bases apart:
+ *          - a right clip followed by a left clip is a deletion,
+ *          - a left clip followed by a right clip is a tandem duplication.
+ *          Each candidate is paired with the closest unpaired candidate before it. Candidates are forgotten when the
+ *          stream is more than `max_pair_distance` bases ahead, so the memory only depends on the depth and the window
+ *          and not on the length of the chromosome.
+ */
+class SoftClipDetector
+{
+private:
+    //!\brief The clip positions of one side that are at most cluster_distance bases apart.
+    struct ClipPileup
+    {
+        bool is_left_clip;
+        int32_t last_position{};
+        int64_t position_sum{};
+        uint32_t support{};
+    };
+
+    //!\brief A pileup with enough support, waiting to be paired.
+    struct ClipCandidate
+    {
+        int32_t position;
+        bool is_left_clip;
+        bool is_paired;
+    };
+
+    int32_t min_clip_length;
+    uint32_t min_support;
+    int32_t cluster_distance;
+    int32_t min_var_length;
+    int32_t max_pair_distance;
+
+    int32_t ref_id{-1};
+    std::string ref_name{};
+    //!\brief Reused for computing the soft clips of each alignment without allocation.
+    AlignedSegment segment{};
+    std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>> right_clips{};
+    ClipPileup left_pileup{true};
+    ClipPileup right_pileup{false};
+    std::deque<ClipCandidate> candidates{};
+
+    //!\brief Adds a final clip position to the pileup of its side.
+    void add_to_pileup(ClipPileup & pileup, int32_t const position, std::vector<Junction> & junctions);
+
+    //!\brief Closes all pileups that end before the given position.
+    void process_clips_before(int32_t const position, std::vector<Junction> & junctions);
+
+    //!\brief Turns a pileup into a candidate and pairs it with an earlier candidate.
+    void close_pileup(ClipPileup & pileup, std::vector<Junction> & junctions);
+
+public:
+    /*! \brief Construct a soft clip detector.
+     *
+     * \param[in] min_var_length    - minimum length of variants to detect
+     * \param[in] min_clip_length   - minimum number of soft clipped bases of an alignment
+     * \param[in] min_support       - minimum number of clipped reads of a breakpoint candidate
+     * \param[in] cluster_distance  - maximum distance between the clip positions of a breakpoint candidate
+     * \param[in] max_pair_distance - maximum distance between two paired breakpoint candidates
+     */
+    SoftClipDetector(int32_t const min_var_length,
+                     int32_t const min_clip_length = 10,
+                     uint32_t const min_support = 3,
+                     int32_t const cluster_distance = 10,
+                     int32_t const max_pair_distance = 10'000) :
+        min_clip_length{min_clip_length},
+        min_support{min_support},
+        cluster_distance{cluster_distance},
+        min_var_length{min_var_length},
+        max_pair_distance{max_pair_distance}
+    {}
+
+    /*! \brief Process the next alignment. The alignments have to be added in coordinate order.
+     *
+     * \param[in]       ref_id      - RNAME field of the SAM/BAM file as index of the reference
+     * \param[in]       ref_name    - RNAME field of the SAM/BAM file
+     * \param[in]       pos         - POS field of the SAM/BAM file
+     * \param[in]       cigar       - CIGAR field of the SAM/BAM file
+     * \param[in, out]  junctions   - vector for storing junctions
+     */
+    void add_alignment(int32_t const ref_id,
+                       std::string const & ref_name,
+                       int32_t const pos,
+                       std::vector<seqan3::cigar> const & cigar,
+                       std::vector<Junction> & junctions);
+
+    /*! \brief Reports the remaining junctions of the last chromosome. Call this after the last alignment.
+     *
+     * \param[in, out]  junctions   - vector for storing junctions
+     */
+    void finish(std::vector<Junction> & junctions);
+};
@@ -7,33 +7,102 @@
 /*! \brief Read segment aligned to the reference genome (part of chimeric/split-aligned read). Contains information
  *        parsed from the SA tag of an alignment in the SAM/BAM file.
  *
- * \param orientation   - mapping orientation (reverse or forward strand)
- * \param ref_name      - reference/chromosome name
- * \param pos           - start position of the alignment
- * \param mapq          - mapping quality
- * \param cig           - cigar string of the alignment
+ * \param orientation       - mapping orientation (reverse or forward strand)
+ * \param ref_name          - reference/chromosome name
+ * \param pos               - start position of the alignment
+ * \param mapq              - mapping quality
+ * \param reference_end     - end position of the alignment on the reference
+ * \param query_length      - length of the read including soft clips
+ * \param left_soft_clip    - soft clipped bases at the start of the alignment
+ * \param right_soft_clip   - soft clipped bases at the end of the alignment
+ * \param cigar_hash        - hash of the elements of the CIGAR string
+ *
+ * \details The CIGAR string is not stored. Its reference span, query length and soft clips are computed in a single
+ *          pass when it is assigned, so that the getters, which are called repeatedly while sorting and analysing the
+ *          segments of a read, are constant time. A hash of its elements is kept for the comparison of segments.
  */
 struct AlignedSegment
 {
-    strand orientation;
-    std::string ref_name;
-    int32_t pos;
-    int32_t mapq;
-    std::vector<seqan3::cigar> cig;
+    //!\brief The FNV-1a offset basis, the hash of an empty CIGAR string.
+    static constexpr uint64_t cigar_hash_basis{14695981039346656037u};
+
+    std::string ref_name{};
+    int32_t pos{};
+    int32_t mapq{};
+    int32_t reference_end{};
+    int32_t query_length{};
+    int32_t left_soft_clip{};
+    int32_t right_soft_clip{};
+    uint64_t cigar_hash{cigar_hash_basis};
+    strand orientation{strand::forward};
+
+    AlignedSegment() = default;
+
+    /*! \brief Construct an aligned segment from the fields of an alignment.
+     *
+     * \param[in] orientation   - mapping orientation (reverse or forward strand)
+     * \param[in] ref_name      - reference/chromosome name
+     * \param[in] pos           - start position of the alignment
+     * \param[in] mapq          - mapping quality
+     * \param[in] cigar         - cigar string of the alignment
+     */
+    AlignedSegment(strand const orientation,
+                   std::string ref_name,
+                   int32_t const pos,
+                   int32_t const mapq,
+                   std::vector<seqan3::cigar> const & cigar);
 
-    int32_t get_reference_start() const;
+    /*! \brief Compute the reference end, query length and soft clips from a CIGAR string. The start position `pos`
+     *         has to be set before.
+     *
+     * \param[in] cigar - cigar string of the alignment
+     */
+    void assign_cigar(std::vector<seqan3::cigar> const & cigar);
 
-    int32_t get_reference_end() const;
+    //!\brief Reset the CIGAR dependent members to an empty CIGAR string, before calling add_cigar_element().
+    void clear_cigar();
 
-    int32_t get_left_soft_clip() const;
+    /*! \brief Add the next element of a CIGAR string, e.g. while parsing a CIGAR string.
+     *
+     * \param[in] length    - length of the CIGAR element
+     * \param[in] operation - CIGAR operation as character
+     */
+    void add_cigar_element(uint32_t const length, char const operation);
 
-    int32_t get_right_soft_clip() const;
+    int32_t get_reference_start() const
+    {
+        return pos;
+    }
 
-    int32_t get_query_start() const;
+    int32_t get_reference_end() const
+    {
+        return reference_end;
+    }
 
-    int32_t get_query_length() const;
+    int32_t get_left_soft_clip() const
+    {
+        return left_soft_clip;
+    }
 
-    int32_t get_query_end() const;
+    int32_t get_right_soft_clip() const
+    {
+        return right_soft_clip;
+    }
+
+    int32_t get_query_start() const
+    {
+        return orientation == strand::forward ? left_soft_clip : right_soft_clip;
+    }
+
+    int32_t get_query_length() const
+    {
+        return query_length;
+    }
+
+    int32_t get_query_end() const
+    {
+        return query_length - (orientation == strand::forward ? right_soft_clip : left_soft_clip);
+    }
 };
 
 template <typename stream_t>
@@ -56,7 +125,12 @@ inline constexpr stream_t operator<<(stream_t && stream, AlignedSegment const &
  */
 bool operator<(AlignedSegment const & lhs, AlignedSegment const & rhs);
 
-/*! \brief An aligned segment is equal to another, if all their members are equal.
+/*! \brief An aligned segment is equal to another, if all their members are equal, i.e. if they have the same position,
+ *         reference span, query length, soft clips and CIGAR hash.
+ *
+ * \details The CIGAR string is not stored, so the equality of the CIGAR strings is only probabilistic: two segments
+ *          with the same spans and clips but different CIGAR strings compare equal if their 64-bit FNV-1a hashes
+ *          collide. The operator is meant for tests, the detection never compares segments.
  *
  * \param lhs - left side aligned segment
  * \param rhs - right side aligned segment
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>  // for std::byte, std::size_t
+#include <memory>   // for std::unique_ptr
+#include <vector>   // for std::vector
+
+/*! \brief A monotonic memory arena. Allocations move a pointer forward in large blocks of memory and are only freed
+ *         all at once by reset().
+ *
+ * \details reset() keeps the blocks, so an arena that is reset after each unit of work (e.g. after each cluster) stops
+ *          allocating from the heap as soon as its blocks are large enough for the largest unit. If a block is full, the
+ *          next one is twice as large.
+ *
+ *          The arena is not thread-safe. Every thread uses its own arena.
+ */
+class Arena
+{
+private:
+    //!\brief A block of memory owned by the arena.
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks{};
+    size_t current_block{0};
+    size_t offset{0};
+    size_t initial_block_size;
+
+    //!\brief Continues with the next block that is large enough, allocating a new one if there is none.
+    void * allocate_in_next_block(size_t const bytes);
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    Arena(Arena const &)               = delete;   //!< Deleted, the allocated memory is owned.
+    Arena & operator=(Arena const &)   = delete;   //!< Deleted, the allocated memory is owned.
+    Arena(Arena &&)                    = default;  //!< Defaulted.
+    Arena & operator=(Arena &&)        = default;  //!< Defaulted.
+    ~Arena()                           = default;  //!< Defaulted.
+
+    /*! \brief Construct an empty arena.
+     *
+     * \param[in] initial_block_size - size of the first block in bytes, it is allocated with the first allocation
+     */
+    Arena(size_t const initial_block_size = 1 << 16) : initial_block_size{initial_block_size}
+    {}
+    //!\}
+
+    /*! \brief Returns uninitialised memory of the given size. It stays valid until reset() is called.
+     *
+     * \param[in] bytes     - number of bytes
+     * \param[in] alignment - alignment of the memory, at most alignof(std::max_align_t)
+     */
+    void * allocate(size_t const bytes, size_t const alignment)
+    {
+        if (current_block < blocks.size())
+        {
+            size_t const aligned_offset = (offset + alignment - 1) & ~(alignment - 1);
+            if (aligned_offset + bytes <= blocks[current_block].size)
+            {
+                offset = aligned_offset + bytes;
+                return blocks[current_block].data.get() + aligned_offset;
+            }
+        }
+        return allocate_in_next_block(bytes);
+    }
+
+    //!\brief Frees all allocations at once. The blocks are kept for the next allocations.
+    void reset()
+    {
+        current_block = 0;
+        offset = 0;
+    }
+
+    //!\brief Returns the number of bytes of all blocks.
+    size_t capacity() const;
+};
+
+/*! \brief An allocator for standard containers that takes its memory from an arena. Deallocation does nothing, the
+ *         memory is freed by resetting the arena.
+ *
+ * \tparam value_t - type of the allocated objects
+ */
+template <typename value_t>
+class ArenaAllocator
+{
+private:
+    template <typename other_value_t>
+    friend class ArenaAllocator;
+
+    Arena * arena;
+
+public:
+    using value_type = value_t;
+
+    //!\brief Construct an allocator that uses the given arena.
+    ArenaAllocator(Arena & arena) noexcept : arena{&arena}
+    {}
+
+    //!\brief Construct an allocator from an allocator of another type, both use the same arena.
+    template <typename other_value_t>
+    ArenaAllocator(ArenaAllocator<other_value_t> const & other) noexcept : arena{other.arena}
+    {}
+
+    value_t * allocate(size_t const n)
+    {
+        return static_cast<value_t *>(arena->allocate(n * sizeof(value_t), alignof(value_t)));
+    }
+
+    void deallocate(value_t *, size_t) noexcept
+    {}
+
+    template <typename other_value_t>
+    bool operator==(ArenaAllocator<other_value_t> const & other) const noexcept
+    {
+        return arena == other.arena;
+    }
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>   // for std::condition_variable
+#include <cstddef>              // for std::size_t
+#include <deque>                // for std::deque
+#include <mutex>                // for std::mutex, std::unique_lock
+#include <optional>             // for std::optional
+
+/*! \brief A queue with a fixed capacity between the stages of a pipeline. Producers block while it is full and
+ *         consumers block while it is empty, so a fast stage cannot run ahead of a slow one by more than the capacity.
+ *
+ * \tparam value_t - type of the elements, usually a batch of work items
+ *
+ * \details The queue is closed by the producer after its last element. Consumers then receive the remaining elements
+ *          and afterwards std::nullopt. The queue is safe for any number of producers and consumers. The elements
+ *          should be batches, so that the lock is taken once per batch and not per work item.
+ */
+template <typename value_t>
+class BoundedQueue
+{
+private:
+    std::deque<value_t> elements{};
+    size_t capacity;
+    bool closed{false};
+    std::mutex mutex{};
+    std::condition_variable not_full{};
+    std::condition_variable not_empty{};
+
+public:
+    /*! \brief Construct an empty queue.
+     *
+     * \param[in] capacity - maximum number of elements in the queue, at least 1
+     */
+    BoundedQueue(size_t const capacity) : capacity{capacity > 0 ? capacity : 1}
+    {}
+
+    /*! \brief Appends an element, waits while the queue is full. Returns false without appending if the queue was
+     *         closed.
+     */
+    bool push(value_t element)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        not_full.wait(lock, [this] () { return closed || elements.size() < capacity; });
+        if (closed)
+            return false;
+        elements.push_back(std::move(element));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    //!\brief Removes the first element, waits while the queue is empty. Returns std::nullopt once closed and empty.
+    std::optional<value_t> pop()
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        not_empty.wait(lock, [this] () { return closed || !elements.empty(); });
+        if (elements.empty())
+            return std::nullopt;
+        std::optional<value_t> element{std::move(elements.front())};
+        elements.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        return element;
+    }
+
+    //!\brief Closes the queue: no further elements are accepted and all waiting threads are woken up.
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            closed = true;
+        }
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "structures/junction.hpp"  // for class Junction
@@ -8,6 +10,9 @@ class Cluster
 {
 private:
     std::vector<Junction> members{};
+    std::optional<std::pair<Breakend, Breakend>> refined_mates{};
+    std::optional<seqan3::dna5_vector> refined_inserted_sequence{};
+    std::vector<size_t> reference_support{};
 
 public:
     /*!\name Constructors, destructor and assignment
@@ -26,26 +31,65 @@ public:
     }
     //!\}
 
-    //! \brief Returns the number of members in the cluster.
+    //! \brief Returns the number of reads in the cluster, the summed weights of its members.
     size_t get_cluster_size() const;
 
     /*! \brief Returns the average first mate of all cluster members.
     *          All cluster members are required to have identical sequence names and orientations for their first mate.
-    *          To produce the average, the average first mate's position of all cluster members is computed.
+    *          To produce the average, the average first mate's position of all reads of the cluster members is computed.
     */
     Breakend get_average_mate1() const;
 
     /*! \brief Returns the average second mate of all cluster members.
     *          All cluster members are required to have identical sequence names and orientations for their second mate.
-    *          To produce the average, the average second mate's position of all cluster members is computed.
+    *          To produce the average, the average second mate's position of all reads of the cluster members is computed.
     */
     Breakend get_average_mate2() const;
 
-    //! \brief Returns the average length of the inserted sequences of all cluster members.
+    //! \brief Returns the average length of the inserted sequences of all reads of the cluster members.
     int32_t get_average_inserted_sequence_size() const;
 
     //! \brief Returns the members of the cluster.
     std::vector<Junction> get_members() const;
+
+    /*! \brief Stores the breakends found by a refinement method, e.g. by realigning the reads at the breakpoints.
+    *          They replace the average mates in the output.
+    */
+    void set_refined_mates(Breakend mate1, Breakend mate2);
+
+    //! \brief Returns whether the breakends of the cluster were refined.
+    bool is_refined() const;
+
+    //! \brief Returns the refined first mate, if the cluster was refined, or the average first mate otherwise.
+    Breakend get_refined_mate1() const;
+
+    //! \brief Returns the refined second mate, if the cluster was refined, or the average second mate otherwise.
+    Breakend get_refined_mate2() const;
+
+    //! \brief Stores the inserted sequence found by a refinement method, e.g. by assembling the reads.
+    void set_refined_inserted_sequence(seqan3::dna5_vector inserted_sequence);
+
+    //! \brief Returns the refined inserted sequence, if a refinement method found it.
+    std::optional<seqan3::dna5_vector> const & get_refined_inserted_sequence() const;
+
+    /*! \brief Returns the length of the refined inserted sequence, if a refinement method found it, or the average
+    *          length of the inserted sequences of all cluster members otherwise.
+    */
+    int32_t get_refined_inserted_sequence_size() const;
+
+    /*! \brief Returns the number of reads supporting the variant, i.e. the weights of the members, rescaled by their
+    *          sampling rates, so that each member of a downsampled region counts for the reads it stands for.
+    */
+    size_t get_estimated_support() const;
+
+    //! \brief Returns the number of reads supporting the variant in each sample, rescaled like get_estimated_support().
+    std::vector<size_t> get_variant_support(size_t const number_of_samples) const;
+
+    //! \brief Stores the number of reads of each sample that span the breakpoints without supporting the variant.
+    void set_reference_support(std::vector<size_t> number_of_reads);
+
+    //! \brief Returns the number of reads supporting the reference for each sample, empty if it was not genotyped.
+    std::vector<size_t> const & get_reference_support() const;
 };
 
 template <typename stream_t>
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>      // for uint32_t, uint64_t
+#include <functional>   // for std::greater
+#include <queue>        // for std::priority_queue
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+/*! \brief Downsamples the alignments of a coordinate-sorted file where the read depth exceeds a cap, so that a single
+ *         locus with a thousandfold coverage does not create a huge partition of junctions.
+ *
+ * \details The depth at the start of an alignment is the number of alignments that cover this position, including the
+ *          alignments that were dropped. Up to the cap, every alignment is kept. Above it, an alignment is kept with a
+ *          sampling rate of `max_depth / depth`, if the hash of its read name, mapped to [0, 1), is smaller than the
+ *          rate. The choice is deterministic, independent of the order of the threads, and keeps all segments of a
+ *          split read in regions of similar depth. Read pairs are decided by their first read only (see
+ *          ReadPairDetector), as their mates may lie in regions of a very different depth.
+ *
+ *          The sampling rate of a kept alignment is stored in its junctions, so that their support can be rescaled
+ *          (see Cluster::get_variant_support()).
+ */
+class DepthCappedSampler
+{
+private:
+    uint32_t max_depth;
+    int32_t current_ref_id{-1};
+    //!\brief The end positions of the alignments covering the current position, the smallest on top.
+    std::priority_queue<int32_t, std::vector<int32_t>, std::greater<int32_t>> alignment_ends{};
+
+public:
+    /*! \brief Construct a sampler.
+     *
+     * \param[in] max_depth - read depth above which alignments are downsampled, 0 for no downsampling
+     */
+    DepthCappedSampler(uint32_t const max_depth) : max_depth{max_depth}
+    {}
+
+    /*! \brief Decides whether the next alignment is kept. The alignments have to be added in coordinate order.
+     *
+     * \param[in] read_name - QNAME field of the SAM/BAM file
+     * \param[in] ref_id    - RNAME field of the SAM/BAM file as index of the reference
+     * \param[in] start     - start position of the alignment on the reference (0-based)
+     * \param[in] end       - end position of the alignment on the reference (exclusive)
+     *
+     * \returns The sampling rate in (0, 1] if the alignment is kept, 1 where the depth is below the cap, or 0 if the
+     *          alignment is dropped.
+     */
+    double sample(std::string const & read_name, int32_t const ref_id, int32_t const start, int32_t const end);
+};
+
+/*! \brief Maps a read name to [0, 1) with the 64 bit FNV-1a hash and the finalizer of MurmurHash3, which are the same
+ *         on every platform.
+ */
+double read_name_fraction(std::string const & read_name);
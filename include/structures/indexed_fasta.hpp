@@ -0,0 +1,125 @@
+#pragma once
+
+#include <optional>         // for std::optional
+#include <stdexcept>        // for std::out_of_range
+#include <string>           // for std::string
+#include <string_view>      // for std::string_view
+#include <unordered_map>    // for std::unordered_map
+#include <vector>           // for std::vector
+
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+#include <seqan3/std/ranges>        // for std::views::iota, std::views::transform
+
+/*! \brief A line of a FASTA index (.fai), as written by `samtools faidx`.
+ *
+ * \param name          - name of the sequence
+ * \param length        - number of bases of the sequence
+ * \param offset        - byte offset of the first base in the FASTA file
+ * \param line_bases    - number of bases per line
+ * \param line_width    - number of bytes per line, including the line break
+ */
+struct FastaIndexEntry
+{
+    std::string name{};
+    uint64_t length{};
+    uint64_t offset{};
+    uint64_t line_bases{};
+    uint64_t line_width{};
+};
+
+/*! \brief Random access to the sequences of a memory-mapped FASTA file.
+ *
+ * \details The FASTA file is mapped read-only into memory and only the pages that are accessed are loaded by the
+ *          operating system, so that whole chromosomes are never copied into RAM. The positions of the bases are
+ *          computed from the FASTA index (.fai) next to the file. If there is no index, it is computed once from the
+ *          mapped file.
+ *
+ *          All member functions are const and do not modify any state, so one instance can be shared by many threads.
+ */
+class IndexedFasta
+{
+private:
+    char const * data{nullptr};
+    size_t file_size{0};
+    std::vector<FastaIndexEntry> index_entries{};
+    std::unordered_map<std::string, size_t> name_to_id{};
+
+    //!\brief Reads the index entries from a .fai file.
+    void read_index(std::filesystem::path const & index_path);
+
+    //!\brief Computes the index entries from the mapped FASTA file.
+    void compute_index();
+
+    //!\brief Throws std::out_of_range if the sequence or range does not exist.
+    FastaIndexEntry const & checked_entry(size_t const id, uint64_t const begin, uint64_t const end) const;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    IndexedFasta(IndexedFasta const &)               = delete;  //!< Deleted, the mapping is owned.
+    IndexedFasta & operator=(IndexedFasta const &)   = delete;  //!< Deleted, the mapping is owned.
+    IndexedFasta(IndexedFasta && other) noexcept;               //!< Takes over the mapping.
+    IndexedFasta & operator=(IndexedFasta && other) noexcept;   //!< Takes over the mapping.
+    ~IndexedFasta();                                            //!< Unmaps the file.
+
+    /*! \brief Map a FASTA file into memory.
+     *
+     * \param[in] fasta_path - path to the FASTA file, its index is expected at `fasta_path` + ".fai"
+     *
+     * \throws std::runtime_error if the file cannot be mapped or does not match its index.
+     */
+    IndexedFasta(std::filesystem::path const & fasta_path);
+    //!\}
+
+    //!\brief Returns the number of sequences.
+    size_t size() const
+    {
+        return index_entries.size();
+    }
+
+    //!\brief Returns the index entry of the sequence with the given ID, i.e. its rank in the FASTA file.
+    FastaIndexEntry const & get_entry(size_t const id) const
+    {
+        return index_entries.at(id);
+    }
+
+    //!\brief Returns the ID of the sequence with the given name, if the FASTA file contains it.
+    std::optional<size_t> get_id(std::string const & name) const;
+
+    /*! \brief Returns a base of a sequence.
+     *
+     * \param[in] id        - ID of the sequence
+     * \param[in] position  - 0-based position in the sequence
+     *
+     * \throws std::out_of_range if the sequence or position does not exist.
+     */
+    char base(size_t const id, uint64_t const position) const
+    {
+        FastaIndexEntry const & entry = checked_entry(id, position, position + 1);
+        return data[entry.offset + position / entry.line_bases * entry.line_width + position % entry.line_bases];
+    }
+
+    /*! \brief Returns a view of the bases [begin, end) of a sequence. The bases are not copied, the view reads them
+     *         from the mapped file and skips the line breaks.
+     *
+     * \param[in] id    - ID of the sequence
+     * \param[in] begin - 0-based start position
+     * \param[in] end   - 0-based end position (exclusive)
+     *
+     * \throws std::out_of_range if the sequence or range does not exist.
+     *
+     * \details The view is a random access range of char and stays valid as long as this object exists.
+     */
+    auto sequence(size_t const id, uint64_t const begin, uint64_t const end) const
+    {
+        FastaIndexEntry const & entry = checked_entry(id, begin, end);
+        char const * const sequence_data = data + entry.offset;
+        uint64_t const line_bases = entry.line_bases;
+        uint64_t const line_width = entry.line_width;
+        return std::views::iota(begin, end) | std::views::transform([=] (uint64_t const position)
+        {
+            return sequence_data[position / line_bases * line_width + position % line_bases];
+        });
+    }
+};
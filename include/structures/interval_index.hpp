@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>           // for std::string
+#include <unordered_map>    // for std::unordered_map
+#include <utility>          // for std::pair
+#include <vector>           // for std::vector
+
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+
+#include "structures/breakend.hpp"  // for class Breakend
+
+/*! \brief An interval on a reference sequence, e.g. a line of a BED file.
+ *
+ * \param seq_name  - name of the reference sequence
+ * \param begin     - 0-based first position of the interval
+ * \param end       - 0-based position after the interval
+ */
+struct GenomicInterval
+{
+    std::string seq_name{};
+    int32_t begin{};
+    int32_t end{};
+};
+
+/*! \brief Answers whether a position lies in one of a set of genomic intervals, e.g. the regions excluded from the
+ *         variant calling with `--exclude`.
+ *
+ * \details The intervals of each reference sequence are sorted and overlapping or adjacent intervals are merged, so a
+ *          position is looked up with a binary search on the intervals of its sequence.
+ *
+ *          All member functions are const and do not modify any state, so one instance can be shared by many threads.
+ */
+class IntervalIndex
+{
+private:
+    //!\brief The disjoint intervals [begin, end) of each reference sequence, sorted by position.
+    std::unordered_map<std::string, std::vector<std::pair<int32_t, int32_t>>> intervals{};
+
+public:
+    //!\brief Construct an empty index, which contains no position.
+    IntervalIndex() = default;
+
+    /*! \brief Construct an index of the given intervals.
+     *
+     * \param[in] intervals - intervals in any order, empty intervals are ignored
+     */
+    IntervalIndex(std::vector<GenomicInterval> const & intervals);
+
+    /*! \brief Construct an index of the intervals of a BED file.
+     *
+     * \param[in] bed_file_path - path to the BED file, only its first three columns are used
+     *
+     * \throws std::runtime_error if the file cannot be read or a line has a wrong format.
+     *
+     * \details Empty lines, comments and track and browser lines are skipped.
+     */
+    IntervalIndex(std::filesystem::path const & bed_file_path);
+
+    //!\brief Returns whether the index contains no intervals.
+    bool empty() const
+    {
+        return intervals.empty();
+    }
+
+    //!\brief Returns whether the 0-based position of the reference sequence lies in one of the intervals.
+    bool contains(std::string const & seq_name, int32_t const position) const;
+
+    //!\brief Returns whether the breakend lies in one of the intervals.
+    bool contains(Breakend const & breakend) const
+    {
+        return contains(breakend.seq_name, breakend.position);
+    }
+};
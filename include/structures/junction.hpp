@@ -5,6 +5,9 @@
 #include <seqan3/alphabet/views/complement.hpp>
 #include <seqan3/utility/views/to.hpp>
 
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+
 #include "structures/breakend.hpp"
 
 class Junction
@@ -14,6 +17,10 @@ private:
     Breakend mate2{};
     seqan3::dna5_vector inserted_sequence{};
     std::string read_name{};
+    //!\brief The names of the reads of identical junctions that were merged into this one (see merge()).
+    std::vector<std::string> merged_read_names{};
+    size_t sample_id{0};
+    double sampling_rate{1.0};
 
 public:
     /*!\name Constructors, destructor and assignment
@@ -62,6 +69,32 @@ public:
 
     //! \brief Returns the name of the read giving rise to this junction.
     std::string get_read_name() const;
+
+    //! \brief Stores the index of the sample whose read gives rise to this junction.
+    void set_sample_id(size_t const id);
+
+    //! \brief Returns the index of the sample whose read gives rise to this junction, 0 for a single sample.
+    size_t get_sample_id() const;
+
+    //! \brief Stores the fraction of the reads that were kept by the downsampling where this junction was found.
+    void set_sampling_rate(double const rate);
+
+    //! \brief Returns the fraction of the reads that were kept where this junction was found, 1 without downsampling.
+    double get_sampling_rate() const;
+
+    //! \brief Returns the number of reads giving rise to this junction, more than 1 if identical junctions were merged.
+    size_t get_weight() const;
+
+    //! \brief Returns the names of all reads giving rise to this junction, the first one is get_read_name().
+    std::vector<std::string> get_read_names() const;
+
+    /*! \brief Returns whether another junction can be merged into this one: both are equal (see operator==()), of the
+    *          same sample and found at the same sampling rate, so that the merged junction is counted like both.
+    */
+    bool is_mergeable(Junction const & other) const;
+
+    //! \brief Adds the reads of a mergeable junction (see is_mergeable()) to this junction.
+    void merge(Junction const & other);
 };
 
 template <typename stream_t>
@@ -74,6 +107,16 @@ inline constexpr stream_t operator<<(stream_t && stream, Junction const & junc)
     return stream;
 }
 
+/*! \brief Sorts the junctions and merges each run of mergeable junctions (see Junction::is_mergeable()) into its first
+ *         junction, so that a junction found in many reads is stored, sorted and clustered once with its weight.
+ *
+ * \param[in, out] junctions - a vector of junctions, sorted and without mergeable junctions afterwards
+ *
+ * \details Equal junctions are ordered by sample and sampling rate, and otherwise keep their order, so the read names
+ *          of a merged junction are in the order of the input.
+ */
+void merge_identical_junctions(std::vector<Junction> & junctions);
+
 /*! \brief A junction is smaller than another, if their first mate, second mate, or inserted sequence (in this order)
  *         is smaller than the corresponding element of the other junction.
  *
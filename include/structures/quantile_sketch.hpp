@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*! \brief A streaming sketch of the distribution of positive integers (e.g. insert sizes) with a bounded relative error
+ *         of its quantiles.
+ *
+ * \details Values are counted in logarithmic buckets: bucket i holds the values in (gamma^(i-1), gamma^i] with
+ *          gamma = (1 + relative_accuracy) / (1 - relative_accuracy). A quantile is reported as the center of its
+ *          bucket and therefore has a relative error of at most `relative_accuracy`. The memory only depends on the
+ *          logarithm of the largest value, e.g. about 700 buckets for values up to 10^6 with 1% accuracy, and not on
+ *          the number of added values.
+ */
+class QuantileSketch
+{
+private:
+    double log_gamma;
+    std::vector<uint64_t> bucket_counts{};
+    uint64_t zero_count{0};
+    uint64_t count{0};
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    QuantileSketch(QuantileSketch const &)               = default; //!< Defaulted.
+    QuantileSketch(QuantileSketch &&)                    = default; //!< Defaulted.
+    QuantileSketch & operator=(QuantileSketch const &)   = default; //!< Defaulted.
+    QuantileSketch & operator=(QuantileSketch &&)        = default; //!< Defaulted.
+    ~QuantileSketch()                                    = default; //!< Defaulted.
+
+    /*! \brief Construct an empty sketch.
+     *
+     * \param[in] relative_accuracy - maximum relative error of the reported quantiles, in (0, 1)
+     */
+    QuantileSketch(double const relative_accuracy = 0.01);
+    //!\}
+
+    //! \brief Adds a value to the sketch.
+    void add(uint64_t const value);
+
+    /*! \brief Returns the approximate q-quantile of all added values, or 0 if the sketch is empty.
+     *
+     * \param[in] q - quantile in [0, 1], e.g. 0.5 for the median
+     */
+    uint64_t quantile(double const q) const;
+
+    //! \brief Returns the number of added values.
+    uint64_t size() const
+    {
+        return count;
+    }
+
+    //! \brief Returns the number of bytes used by the sketch.
+    size_t memory_usage() const
+    {
+        return sizeof(QuantileSketch) + bucket_counts.capacity() * sizeof(uint64_t);
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>       // for std::chrono::steady_clock
+#include <istream>      // for std::istream
+#include <streambuf>    // for std::streambuf
+#include <string>       // for std::string
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
+#include <seqan3/std/filesystem>    // for std::filesystem::path
+
+#include "structures/bounded_queue.hpp" // for class BoundedQueue
+
+/*! \brief The settings of the read-ahead of an input file.
+ *
+ * \param queue_depth   - number of blocks that are read ahead of the parser, 0 to read the file without read-ahead
+ * \param block_size    - number of bytes per block
+ */
+struct ReadAheadOptions
+{
+    size_t queue_depth = 0;
+    size_t block_size = 4 << 20;
+};
+
+/*! \brief A stream buffer that reads a file in large blocks on a prefetch thread, so that the parser does not wait for
+ *         every request on storage with a high latency, e.g. network-attached storage.
+ *
+ * \details The prefetch thread reads the blocks one after the other with `pread` and passes them through a
+ *          BoundedQueue with a capacity of `queue_depth` blocks. It also announces the blocks after the current one to
+ *          the kernel with `posix_fadvise`, so that their requests are issued while the current block is read. The time
+ *          the parser waits for blocks is measured.
+ *
+ *          A read error on the prefetch thread is thrown as std::runtime_error from underflow().
+ */
+class ReadAheadBuffer : public std::streambuf
+{
+private:
+    int file_descriptor{-1};
+    std::string file_name{};
+    ReadAheadOptions options{};
+    BoundedQueue<std::vector<char>> blocks;
+    //!\brief The block whose bytes are read by the parser.
+    std::vector<char> current_block{};
+    //!\brief The message of a read error on the prefetch thread, set before the queue is closed.
+    std::string error_message{};
+    std::chrono::steady_clock::duration wait_time{};
+    std::thread prefetcher{};
+
+    //!\brief Reads the blocks of the file into the queue, runs on the prefetch thread.
+    void prefetch_blocks();
+
+protected:
+    //!\brief Makes the next block the get area, waits for it if necessary.
+    int_type underflow() override;
+
+public:
+    /*!\name Constructors, destructor and assignment
+     * \{
+     */
+    ReadAheadBuffer(ReadAheadBuffer const &)                = delete;  //!< Deleted, the prefetch thread is owned.
+    ReadAheadBuffer(ReadAheadBuffer &&)                     = delete;  //!< Deleted, the prefetch thread is owned.
+    ReadAheadBuffer & operator=(ReadAheadBuffer const &)    = delete;  //!< Deleted, the prefetch thread is owned.
+    ReadAheadBuffer & operator=(ReadAheadBuffer &&)         = delete;  //!< Deleted, the prefetch thread is owned.
+
+    /*! \brief Opens a file and starts reading it ahead.
+     *
+     * \param[in] file_path - path to the file
+     * \param[in] options   - queue depth and block size, the queue depth is at least 1
+     *
+     * \throws std::runtime_error if the file cannot be opened.
+     */
+    ReadAheadBuffer(std::filesystem::path const & file_path, ReadAheadOptions const & options);
+
+    //!\brief Stops the prefetch thread and closes the file.
+    ~ReadAheadBuffer();
+    //!\}
+
+    //!\brief Returns the time the parser waited for blocks so far.
+    std::chrono::steady_clock::duration get_wait_time() const
+    {
+        return wait_time;
+    }
+};
+
+/*! \brief An input stream of a file that is read ahead by a ReadAheadBuffer, e.g. for seqan3::sam_file_input.
+ *
+ * \details Read errors are thrown from the reading functions instead of only setting the badbit, so that a parser
+ *          cannot mistake them for the end of the file.
+ */
+class ReadAheadStream : public std::istream
+{
+private:
+    ReadAheadBuffer buffer;
+
+public:
+    /*! \brief Opens a file and starts reading it ahead.
+     *
+     * \param[in] file_path - path to the file
+     * \param[in] options   - queue depth and block size
+     *
+     * \throws std::runtime_error if the file cannot be opened.
+     */
+    ReadAheadStream(std::filesystem::path const & file_path, ReadAheadOptions const & options) :
+        std::istream{nullptr},
+        buffer{file_path, options}
+    {
+        rdbuf(&buffer);
+        exceptions(std::ios::badbit);
+    }
+
+    //!\brief Returns the time the parser waited for blocks so far.
+    std::chrono::steady_clock::duration get_wait_time() const
+    {
+        return buffer.get_wait_time();
+    }
+};
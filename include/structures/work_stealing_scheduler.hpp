@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for uint16_t
+#include <functional>   // for std::function
+
+/*! \brief Runs a number of independent tasks of very different sizes on several threads. Every worker has its own
+ *         queue of tasks and idle workers steal from the others, so the wall time follows the total work rather than
+ *         the largest queue.
+ *
+ * \details The tasks are dealt to the workers round-robin in the given order, so tasks ordered by decreasing size are
+ *          spread evenly and every worker starts with its largest task. A worker takes the tasks of its own queue from
+ *          the front. If it is empty, the worker steals the back half of the fullest queue. The queues are only locked
+ *          to take or steal tasks, never while a task runs.
+ *
+ *          If a task throws, no further tasks are started and the first exception is rethrown by run() after all
+ *          running tasks finished.
+ */
+class WorkStealingScheduler
+{
+private:
+    uint16_t threads;
+
+public:
+    /*! \brief Construct a scheduler.
+     *
+     * \param[in] threads - number of threads including the calling thread, at least 1
+     */
+    WorkStealingScheduler(uint16_t const threads) : threads{threads > 0 ? threads : uint16_t{1}}
+    {}
+
+    /*! \brief Runs `task(task_id, worker_id)` for every task id in [0, number_of_tasks) and returns when all are done.
+     *
+     * \param[in] number_of_tasks - number of tasks
+     * \param[in] task            - function that runs a task, it may use per-worker state indexed by the worker id,
+     *                              which is smaller than get_threads()
+     */
+    void run(size_t const number_of_tasks, std::function<void(size_t, uint16_t)> const & task) const;
+
+    //!\brief Returns the number of threads including the calling thread.
+    uint16_t get_threads() const
+    {
+        return threads;
+    }
+};
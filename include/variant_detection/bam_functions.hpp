@@ -13,9 +13,9 @@
  * |    1 | 0x1   | template having multiple segments in sequencing                    | necessary for read pair method                     |
  * |    2 | 0x2   | each segment properly aligned according to the aligner             | aligned as expected, probably not containing SVs *)|
  * |    4 | 0x4   | segment unmapped                                                   | will be skipped                                    |
- * |    8 | 0x8   | next segment in the template unmapped                              | mate unmapped, maybe an insertion? *)              |
+ * |    8 | 0x8   | next segment in the template unmapped                              | mate unmapped, maybe an insertion? **)             |
  * |   16 | 0x10  | SEQ being reverse complemented                                     | important for split reads and paired-reads         |
- * |   32 | 0x20  | SEQ of the next segment in the template being reverse complemented | *)                                                 |
+ * |   32 | 0x20  | SEQ of the next segment in the template being reverse complemented | important for paired-reads                         |
  * |   64 | 0x40  | the first segment in the template                                  | *)                                                 |
  * |  128 | 0x80  | the last segment in the template                                   | *)                                                 |
  * |  256 | 0x100 | secondary alignment                                                | will be skipped                                    |
@@ -23,6 +23,7 @@
  * | 1024 | 0x400 | PCR or optical duplicate                                           | will be skipped                                    |
  * | 2048 | 0x800 | supplementary alignment                                            | will be skipped (primary alignments only)          |
  * *) not checked yet
+ * **) pairs with unmapped mates are skipped by the read pair method
  * \see [Map Format Specification](https://samtools.github.io/hts-specs/SAMv1.pdf#page=7)
  * (last access 09.04.2021).
  *
@@ -48,10 +49,10 @@ inline constexpr bool hasFlagMultiple(seqan3::sam_flag const & flag)
     return (static_cast<uint16_t>(flag) & BAM_FLAG_MULTIPLE) == BAM_FLAG_MULTIPLE;
 }
 
-// inline constexpr bool hasFlagProperMappedPairedReads(seqan3::sam_flag const & flag)
-// {
-//     return (static_cast<uint16_t>(flag) & BAM_FLAG_ALL_PROPER) == BAM_FLAG_ALL_PROPER;
-// }
+inline constexpr bool hasFlagAllProperlyAligned(seqan3::sam_flag const & flag)
+{
+    return (static_cast<uint16_t>(flag) & BAM_FLAG_ALL_PROPER) == BAM_FLAG_ALL_PROPER;
+}
 
 inline constexpr bool hasFlagUnmapped(seqan3::sam_flag const & flag)
 {
@@ -61,12 +62,21 @@ inline constexpr bool hasFlagUnmapped(seqan3::sam_flag const & flag)
 /*!\brief This flag is important for split reads and paired reads. For the latter, 0x10 and 0x20 are compared. Usually
  *        you would expect them to be different and if they are not it could be because of an inversion.
  */
-//TODO (irallia): Implement the use of this flag in the paired read method.
 inline constexpr bool hasFlagReverseComplement(seqan3::sam_flag const & flag)
 {
     return (static_cast<uint16_t>(flag) & BAM_FLAG_RC) == BAM_FLAG_RC;
 }
 
+inline constexpr bool hasFlagMateUnmapped(seqan3::sam_flag const & flag)
+{
+    return (static_cast<uint16_t>(flag) & BAM_FLAG_NEXT_UNMAPPED) == BAM_FLAG_NEXT_UNMAPPED;
+}
+
+inline constexpr bool hasFlagMateReverseComplement(seqan3::sam_flag const & flag)
+{
+    return (static_cast<uint16_t>(flag) & BAM_FLAG_NEXT_RC) == BAM_FLAG_NEXT_RC;
+}
+
 inline constexpr bool hasFlagSecondary(seqan3::sam_flag const & flag)
 {
     return (static_cast<uint16_t>(flag) & BAM_FLAG_SECONDARY) == BAM_FLAG_SECONDARY;
@@ -83,6 +93,22 @@ inline constexpr bool hasFlagDuplicate(seqan3::sam_flag const & flag)
 }
 
 
+//!\brief Returns the number of reference bases spanned by an alignment, i.e. the sum of its M, D, N, = and X operations.
+inline int32_t get_reference_length(std::vector<seqan3::cigar> const & cigar)
+{
+    int32_t reference_length = 0;
+    for (auto [element_length, element_operation] : cigar)
+    {
+        switch (element_operation.to_char())
+        {
+            case 'M': case '=': case 'X': case 'D': case 'N': reference_length += element_length; break;
+            default:                                          break;
+        }
+    }
+    return reference_length;
+}
+
+
  /*! \brief Updates the sequence lengths by `cigar_count` depending on the cigar operation `op`.
   * \param[in, out]  ref_length  The reference sequence's length.
   * \param[in, out]  seq_length  The query sequence's length.
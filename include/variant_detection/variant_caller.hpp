@@ -0,0 +1,129 @@
+#pragma once
+
+#include <functional>       // for std::function
+#include <string>           // for std::string
+#include <unordered_map>    // for std::unordered_map
+#include <vector>           // for std::vector
+
+#include "modules/sv_detection_methods/analyze_read_depth_method.hpp"   // for class ReadDepthDetector
+#include "modules/sv_detection_methods/analyze_soft_clip_method.hpp"    // for class SoftClipDetector
+#include "structures/cluster.hpp"                                       // for class Cluster
+#include "structures/depth_capped_sampler.hpp"                          // for class DepthCappedSampler
+#include "variant_detection/method_enums.hpp"                           // for enum detection_methods and
+                                                                        // clustering_methods
+#include "variant_detection/variant_detection.hpp"                      // for struct AlignmentRecord
+
+/*! \brief The settings of a VariantCaller.
+ *
+ * \param methods               - list of methods for detecting junctions, read pairs are not supported
+ * \param clustering_method     - method for clustering junctions (0: simple_clustering, 1: hierarchical_clustering)
+ * \param clustering_cutoff     - distance cutoff of the hierarchical clustering
+ * \param min_var_length        - minimum length of variants to detect
+ * \param max_consensus_members - maximum number of inserted sequences aligned for the consensus of an insertion, 0 for
+ *                                no consensus
+ * \param max_depth             - read depth above which the alignments are downsampled, 0 for no downsampling
+ * \param threads               - number of threads for the detection in batches, the clustering and the consensus
+ * \param closing_distance      - distance behind the current alignment after which a region is closed, it should
+ *                                exceed the length of the reads
+ */
+struct VariantCallerConfig
+{
+    std::vector<detection_methods> methods{cigar_string, split_read, read_depth};
+    clustering_methods clustering_method{simple_clustering};
+    double clustering_cutoff = 10.0;
+    uint64_t min_var_length = 30;
+    uint64_t max_consensus_members = 0;
+    uint32_t max_depth = 1000;
+    uint16_t threads = 1;
+    int32_t closing_distance = 100000;
+};
+
+/*! \brief Detects and clusters the junctions of long read alignments that are pushed by the caller, e.g. a program
+ *         that decodes the alignments itself or receives them from a stream. The clusters are passed to a callback as
+ *         soon as the region of their breakends is closed, so that the caller neither has to write an alignment file
+ *         nor to wait for the end of the input.
+ *
+ * \details The alignments have to be pushed in coordinate order: the references in any order, but each one in a single
+ *          block, and the alignments of a reference by increasing position. They are filtered like the alignments of a
+ *          long read file (see detect_junctions_in_long_reads_sam_file()), including the downsampling above
+ *          `max_depth`.
+ *
+ *          A breakend is closed once the alignments moved on to another reference or more than `closing_distance`
+ *          behind it, a breakend on a reference without alignments so far is open. The junctions whose breakends are
+ *          both closed are clustered, unless one of their neighbours within 50 bp of the first breakend is still open,
+ *          because it could belong to the same cluster. Such neighbourhoods are the partitions of the hierarchical
+ *          clustering (see partition_junctions()), so the clusters equal those of the whole input. Only a junction that
+ *          is detected after its neighbourhood was closed, e.g. a read depth change or a deletion with a breakend more
+ *          than `closing_distance` behind the reads, is clustered on its own with the next region.
+ *
+ *          The clusters of a region are passed to the callback in sorted order. finish() clusters the remaining
+ *          junctions.
+ */
+class VariantCaller
+{
+private:
+    VariantCallerConfig config;
+    std::function<void(Cluster)> callback;
+    ReadDepthDetector read_depth_detector{};
+    SoftClipDetector soft_clip_detector;
+    DepthCappedSampler sampler;
+    //!\brief The index of each reference, in the order of their first alignment.
+    std::unordered_map<std::string, int32_t> ref_ids{};
+    int32_t current_ref_id{-1};
+    int32_t current_pos{-1};
+    //!\brief Position of the current reference at which the regions were closed the last time.
+    int32_t last_closing_pos{-1};
+    //!\brief The junctions that were not yet clustered.
+    std::vector<Junction> open_junctions{};
+    bool finished{false};
+
+    //!\brief Returns whether no further junctions with this breakend are expected.
+    bool is_closed(Breakend const & breakend) const;
+
+    /*! \brief Checks that a batch of alignments follows the alignments accepted so far in coordinate order, without
+     *         changing the state of the caller.
+     *
+     * \throws std::runtime_error if the alignments are not in coordinate order.
+     */
+    void check_order(std::vector<AlignmentRecord> const & alignments) const;
+
+    /*! \brief Samples an alignment of a checked batch and returns the index of its reference, or -1 if it is
+     *         filtered out.
+     */
+    int32_t accept_alignment(AlignmentRecord & alignment);
+
+    //!\brief Clusters the closed junctions, or all junctions if `close_all` is true, and passes them to the callback.
+    void close_regions(bool const close_all);
+
+public:
+    /*! \brief Construct a caller.
+     *
+     * \param[in] config    - settings of the detection and the clustering
+     * \param[in] callback  - function that receives each cluster once its region is closed
+     */
+    VariantCaller(VariantCallerConfig config, std::function<void(Cluster)> callback);
+
+    /*! \brief Detects the junctions of the next alignment.
+     *
+     * \param[in] alignment - alignment, the next in coordinate order
+     *
+     * \throws std::runtime_error if the alignment is not in coordinate order or finish() was called. A rejected
+     *         alignment does not change the caller.
+     */
+    void push(AlignmentRecord alignment);
+
+    /*! \brief Detects the junctions of the next batch of alignments.
+     *
+     * \param[in] alignments - alignments in coordinate order, following the alignments pushed so far
+     *
+     * \throws std::runtime_error if the alignments are not in coordinate order or finish() was called. The order of
+     *         the whole batch is checked first, a rejected batch is not detected and does not change the caller.
+     *
+     * \details The CIGAR strings and SA tags of the batch are analysed by `config.threads` threads, the read depth and
+     *          soft clip methods run on the calling thread. Regions are only closed once per batch.
+     */
+    void push(std::vector<AlignmentRecord> alignments);
+
+    //!\brief Clusters all remaining junctions and passes them to the callback. No alignments can be pushed afterwards.
+    void finish();
+};
@@ -1,10 +1,19 @@
 #pragma once
 
 #include <seqan3/std/filesystem>    // for filesystem
+#include <string>
 #include <vector>
 
-#include "method_enums.hpp"         // for enum detection_methods, clustering_methods and refinement_methods
-#include "structures/junction.hpp"  // for class Junction
+#include <seqan3/alphabet/cigar/cigar.hpp>          // for seqan3::cigar
+#include <seqan3/alphabet/nucleotide/dna5.hpp>      // for seqan3::dna5_vector
+#include <seqan3/io/sam_file/sam_flag.hpp>          // for seqan3::sam_flag
+
+#include "iGenVar.hpp"                      // for cmd_arguments
+#include "modules/sv_detection_methods/analyze_read_pair_method.hpp" // for struct ReadPairOptions
+#include "method_enums.hpp"                 // for enum detection_methods, clustering_methods and refinement_methods
+#include "structures/interval_index.hpp"    // for class IntervalIndex
+#include "structures/junction.hpp"          // for class Junction
+#include "structures/read_ahead_stream.hpp" // for struct ReadAheadOptions
 
 /*! \brief Detects junctions between distant genomic positions by analyzing a short read alignment file (sam/bam). The
  *         detected junctions are stored in a vector.
@@ -14,18 +23,71 @@
  * \param[in]       methods - list of methods for detecting junctions (0: cigar_string,
  *                                                                     1: split_read,
  *                                                                     2: read_pairs,
- *                                                                     3: read_depth)
+ *                                                                     3: read_depth,
+ *                                                                     4: soft_clips)
  * \param[in]       min_var_length - minimum length of variants to detect (default 30 bp)
+ * \param[in]       excluded_regions - regions in which the alignments that start there are only used for the read depth
+ *                                     (default none)
+ * \param[in]       max_depth - read depth above which the read pairs are downsampled, 0 for none (default 0)
+ * \param[in]       read_ahead - read-ahead of the file, none by default (see ReadAheadStream)
+ * \param[in]       read_pairs - insert size learning of the read pair method (see ReadPairDetector)
  *
- * \details Detects junctions from the CIGAR strings and supplementary alignment tags of read alignment records.
+ * \details Detects junctions from discordant read pairs of read alignment records (see ReadPairDetector).
  *          We filter unmapped alignments, secondary alignments, duplicates and alignments with low mapping quality.
- *          Then, the CIGAR string of all remaining alignments is analyzed.
- *          For primary alignments, also the split read information is analyzed.
+ *          Then, the primary alignments of all remaining pairs with mapped mates are analyzed in a single pass.
+ *          In the same pass, the read depth of all remaining alignments is binned (see ReadDepthDetector) and their
+ *          soft clips are piled up (see SoftClipDetector). Where the depth of the read pairs exceeds `max_depth`, the
+ *          pairs are downsampled by a hash of their names (see DepthCappedSampler).
  */
 void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
                                               std::filesystem::path const & alignment_short_reads_file_path,
                                               std::vector<detection_methods> const & methods,
-                                              uint64_t const min_var_length);
+                                              uint64_t const min_var_length,
+                                              IntervalIndex const & excluded_regions = IntervalIndex{},
+                                              uint32_t const max_depth = 0,
+                                              ReadAheadOptions const & read_ahead = ReadAheadOptions{},
+                                              ReadPairOptions const & read_pairs = ReadPairOptions{});
+
+/*! \brief A filtered alignment of a long read whose CIGAR string and SA tag are analysed by
+ *         detect_junctions_in_alignment(). It owns its fields, so that it can be handed between threads or pushed into
+ *         a VariantCaller by a program that decodes the alignments itself.
+ *
+ * \param query_name    - QNAME field of the SAM/BAM file
+ * \param flag          - FLAG field of the SAM/BAM file
+ * \param ref_name      - RNAME field of the SAM/BAM file
+ * \param ref_pos       - POS field of the SAM/BAM file (0-based)
+ * \param mapq          - MAPQ field of the SAM/BAM file
+ * \param cigar         - CIGAR field of the SAM/BAM file
+ * \param seq           - SEQ field of the SAM/BAM file
+ * \param sa_tag        - SA tag of the SAM/BAM file, empty for supplementary alignments and alignments without one
+ * \param sampling_rate - fraction of the alignments kept by the downsampling at this position, stored in the junctions
+ */
+struct AlignmentRecord
+{
+    std::string query_name{};
+    seqan3::sam_flag flag{};
+    std::string ref_name{};
+    int32_t ref_pos{};
+    uint8_t mapq{};
+    std::vector<seqan3::cigar> cigar{};
+    seqan3::dna5_vector seq{};
+    std::string sa_tag{};
+    double sampling_rate{1.0};
+};
+
+/*! \brief Detects the junctions of a single long read alignment with the cigar string and split read methods. The
+ *         detected junctions are appended to a vector.
+ *
+ * \param[in]       alignment - filtered alignment, its CIGAR string may be modified
+ * \param[in]       methods - list of methods for detecting junctions, only 0: cigar_string and 1: split_read are
+ *                            used, the other methods need all alignments in order
+ * \param[in]       min_var_length - minimum length of variants to detect
+ * \param[in, out]  junctions - a vector of junctions, the new ones get the sampling rate of the alignment
+ */
+void detect_junctions_in_alignment(AlignmentRecord & alignment,
+                                   std::vector<detection_methods> const & methods,
+                                   uint64_t const min_var_length,
+                                   std::vector<Junction> & junctions);
 
 /*! \brief Detects junctions between distant genomic positions by analyzing a long read alignment file (sam/bam). The
  *         detected junctions are stored in a vector.
@@ -35,15 +97,121 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
  * \param[in]       methods - list of methods for detecting junctions (0: cigar_string,
  *                                                                     1: split_read,
  *                                                                     2: read_pairs,
- *                                                                     3: read_depth)
+ *                                                                     3: read_depth,
+ *                                                                     4: soft_clips)
  * \param[in]       min_var_length - minimum length of variants to detect (default 30 bp)
+ * \param[in]       threads - number of threads, one reads the file and the others detect junctions (default 1)
+ * \param[in]       excluded_regions - regions in which the alignments that start there are only used for the read depth
+ *                                     (default none)
+ * \param[in]       max_depth - read depth above which the alignments are downsampled, 0 for none (default 0)
+ * \param[in]       read_ahead - read-ahead of the file, none by default (see ReadAheadStream)
  *
  * \details Detects junctions from the CIGAR strings and supplementary alignment tags of read alignment records.
  *          We filter unmapped alignments, secondary alignments, duplicates and alignments with low mapping quality.
  *          Then, the CIGAR string of all remaining alignments is analyzed.
  *          For primary alignments, also the split read information is analyzed.
+ *          In the same pass, the read depth of all remaining alignments is binned (see ReadDepthDetector) and their
+ *          soft clips are piled up (see SoftClipDetector).
+ *
+ *          With more than one thread, reading and detection overlap: the calling thread decodes the records, runs the
+ *          read depth and soft clip methods, which need the alignments in order, and passes batches of alignments
+ *          through a BoundedQueue to the other threads, which analyze their CIGAR strings and SA tags. The junctions of
+ *          the batches are appended in the order of the batches, so the result does not depend on the scheduling.
+ *
+ *          The loop over the records is instantiated for each set of methods, which is chosen once per file. It only
+ *          contains the methods in use and decodes only the fields they need: the read names and sequences for the
+ *          cigar string and split read methods and the tags for the split read method. The junctions of an alignment
+ *          are detected in the order cigar string, split read, read depth and soft clips, independent of the order of
+ *          `methods`, and each method runs once even if it is listed more than once.
+ *
+ *          Alignments that start in an excluded region are skipped after their position is decoded. Only the read
+ *          depth method still counts them, so that the excluded regions do not look like deletions. Only the start is
+ *          tested: an alignment that starts before an excluded region and reaches into it is analyzed completely, and
+ *          its junctions with a breakend in the region are only dropped by detect_junctions_in_samples().
+ *
+ *          Where the read depth exceeds `max_depth`, the cigar string and split read methods only analyze a sample of
+ *          the alignments chosen by a hash of their read names (see DepthCappedSampler).
+ *
+ *          With a read-ahead, the file is read in large blocks on a prefetch thread in addition to `threads`, and the
+ *          time spent waiting for the blocks is reported at the end.
  */
 void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
                                              std::filesystem::path const & alignment_long_reads_file_path,
                                              std::vector<detection_methods> const & methods,
-                                             uint64_t const min_var_length);
+                                             uint64_t const min_var_length,
+                                             uint16_t const threads = 1,
+                                             IntervalIndex const & excluded_regions = IntervalIndex{},
+                                             uint32_t const max_depth = 0,
+                                             ReadAheadOptions const & read_ahead = ReadAheadOptions{});
+
+/*! \brief The alignment files of a sample, at least one of them is given.
+ *
+ * \param name                      - name of the sample in the vcf output file
+ * \param short_reads_file_path     - short reads input file, path to the sam/bam file
+ * \param long_reads_file_path      - long reads input file, path to the sam/bam file
+ */
+struct AlignmentSample
+{
+    std::string name{};
+    std::filesystem::path short_reads_file_path{};
+    std::filesystem::path long_reads_file_path{};
+
+    //!\brief Returns the file used to refine and genotype the sample: the long reads if given, else the short reads.
+    std::filesystem::path const & get_primary_file_path() const
+    {
+        return long_reads_file_path.empty() ? short_reads_file_path : long_reads_file_path;
+    }
+};
+
+/*! \brief Returns the samples given on the command line in the order of their sample ids.
+ *
+ * \param[in] args - command line arguments:\n
+ *                   **args.alignment_short_reads_file_path** and **args.alignment_long_reads_file_path** - first
+ *                      sample\n
+ *                   **args.sample_short_reads_file_paths** and **args.sample_long_reads_file_paths** - further
+ *                      samples, a short and a long reads file with the same stem form one sample
+ *
+ * \details Each sample is named after the stem of its primary file (see AlignmentSample::get_primary_file_path()).
+ *          The short and long reads files of a further sample are paired by their stem, e.g. short/HG002.bam and
+ *          long/HG002.bam form the sample HG002.
+ *
+ * \throws std::runtime_error if two samples would have the same name.
+ */
+std::vector<AlignmentSample> get_samples(cmd_arguments const & args);
+
+/*! \brief Detects the junctions of several samples in parallel. The junctions are tagged with the id of their sample
+ *         and stored in a vector.
+ *
+ * \param[in, out]  junctions       - a vector of junctions
+ * \param[in]       samples         - samples, their position is their sample id
+ * \param[in]       methods         - list of methods for detecting junctions
+ * \param[in]       min_var_length  - minimum length of variants to detect (default 30 bp)
+ * \param[in]       threads         - number of threads
+ * \param[in]       excluded_regions - regions whose alignments are only used for the read depth and in which no
+ *                                     breakends are reported (default none)
+ * \param[in]       max_depth       - read depth above which the alignments are downsampled, 0 for none (default 0)
+ * \param[in]       read_ahead      - read-ahead of each file, none by default (see ReadAheadStream)
+ * \param[in]       read_pairs      - insert size learning of the read pair method for the short reads files
+ *
+ * \details Every alignment file is read by one thread of a WorkStealingScheduler, the largest files first, so small
+ *          samples fill the gaps next to large ones. The junctions of each file are detected into their own vector and
+ *          appended in the order of the samples, so the result does not depend on the number of threads. Threads beyond
+ *          the number of files are shared out to detect the junctions of the long reads files (see
+ *          detect_junctions_in_long_reads_sam_file()).
+ *
+ *          Alignments that start in an excluded region are skipped (see detect_junctions_in_long_reads_sam_file()),
+ *          alignments that only reach into one are analyzed. Then, the junctions with a breakend in an excluded region
+ *          are dropped.
+ *
+ *          The identical junctions of a file are merged into one junction weighted by its reads (see
+ *          merge_identical_junctions()), so the junctions of each file are sorted.
+ */
+void detect_junctions_in_samples(std::vector<Junction> & junctions,
+                                 std::vector<AlignmentSample> const & samples,
+                                 std::vector<detection_methods> const & methods,
+                                 uint64_t const min_var_length,
+                                 uint16_t const threads,
+                                 IntervalIndex const & excluded_regions = IntervalIndex{},
+                                 uint32_t const max_depth = 0,
+                                 ReadAheadOptions const & read_ahead = ReadAheadOptions{},
+                                 ReadPairOptions const & read_pairs = ReadPairOptions{});
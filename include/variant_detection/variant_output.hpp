@@ -4,8 +4,9 @@
 
 #include <seqan3/std/filesystem>
 
-#include "iGenVar.hpp"              // for cmd_arguments
-#include "structures/cluster.hpp"   // for class Cluster
+#include "iGenVar.hpp"                      // for cmd_arguments
+#include "structures/cluster.hpp"           // for class Cluster
+#include "structures/indexed_fasta.hpp"     // for class IndexedFasta
 
 
 /*! \brief Detects genomic variants from junction clusters and prints them to output stream in VCF format.
@@ -14,15 +15,27 @@
  * \param[in]       args        - command line arguments:\n
  *                                **args.min_var_length** - minimum length of variants to detect - *default: 30 bp*\n
  *                                **args.max_var_length** - maximum length of variants to detect - *default: 1,000,000 bp*\n
- *                                **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*
+ *                                **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*\n
+ *                                **args.genotype** - whether to output the genotypes of the samples - *default: false*\n
+ *                                **args.threads** - number of threads that format the records - *default: 1*
  * \param[in, out]  out_stream  - output stream
+ * \param[in]       reference   - reference genome for the REF column, if it is a nullptr the REF column is N
  *
  * \details Extracts genomic variants from given junction clusters.
  *          The quality of an SV is estimated based on the size of the cluster (i.e. the number of reads supporting the SV).
+ *          The ALT column of an insertion contains the inserted sequence if it was refined or computed as consensus.
+ *          With several samples, each sample column holds the number of reads of the sample supporting the variant
+ *          (DV). With genotyping, the sample columns also hold the genotype (GT) and the number of reads supporting the
+ *          reference (DR).
+ *
+ *          With several threads, consecutive ranges of clusters are formatted in parallel into private buffers,
+ *          which are committed to the stream in the order of the ranges. The output is byte-identical to a single
+ *          thread.
  */
 void find_and_output_variants(std::vector<Cluster> const & clusters,
                               cmd_arguments const & args,
-                              std::ostream & out_stream);
+                              std::ostream & out_stream,
+                              IndexedFasta const * reference = nullptr);
 
 
 /*! \brief Detects genomic variants from junction clusters and prints them in output file in VCF format.
@@ -31,8 +44,11 @@ void find_and_output_variants(std::vector<Cluster> const & clusters,
  * \param[in] args              - command line arguments:\n
  *                                **args.min_var_length** - minimum length of variants to detect - *default: 30 bp*\n
  *                                **args.max_var_length** - maximum length of variants to detect - *default: 1,000,000 bp*\n
- *                                **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*
+ *                                **args.max_tol_inserted_length** - longest tolerated inserted sequence at non-INS SV types - *default: 5 bp*\n
+ *                                **args.genotype** - whether to output the genotypes of the samples - *default: false*\n
+ *                                **args.threads** - number of threads that format the records - *default: 1*
  * \param[in] output_file_path  - output file path
+ * \param[in] reference         - reference genome for the REF column, if it is a nullptr the REF column is N
  *
  * \details Extracts genomic variants from given junction clusters.
  *          The quality of an SV is estimated based on the size of the cluster (i.e. the number of reads supporting the SV).
@@ -40,4 +56,5 @@ void find_and_output_variants(std::vector<Cluster> const & clusters,
 //!\overload
 void find_and_output_variants(std::vector<Cluster> const & clusters,
                               cmd_arguments const & args,
-                              std::filesystem::path const & output_file_path);
+                              std::filesystem::path const & output_file_path,
+                              IndexedFasta const * reference = nullptr);
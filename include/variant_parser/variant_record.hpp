@@ -62,6 +62,27 @@ public:
         info.push_back(info_entry{info_key_i, number_i, type_i, description_i, source_i, version_i});
     }
 
+    /*! \brief Add header information for a given FORMAT field.
+     *
+     * \param[in] format_key_i  - the FORMAT key name
+     * \param[in] number_i      - the number of values this key can hold
+     * \param[in] type_i        - the type of values this key holds
+     * \param[in] description_i - the description of this FORMAT field
+     */
+    void add_format_info(std::string format_key_i, std::uint8_t number_i, std::string type_i, std::string description_i)
+    {
+        format.push_back(info_entry{format_key_i, number_i, type_i, description_i, "", ""});
+    }
+
+    /*! \brief Add a sample column. The records need one value for each sample, in the same order.
+     *
+     * \param[in] sample_i - the name of the sample
+     */
+    void add_sample(std::string sample_i)
+    {
+        samples.push_back(std::move(sample_i));
+    }
+
     /*! \brief Prints the VCF header to a given output.
      *
      * \tparam stream_type - a stream to print the output to
@@ -82,13 +103,27 @@ public:
                        << ",Description=\"" << i.description << "\",Source=\"" << i.source << "\",Version=\""
                        << i.version << "\">" << '\n';
         }
-        out_stream << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO" << '\n';
+        for (auto const & f : format)
+        {
+            out_stream << "##FORMAT=<ID=" << f.key << ",Number=" << std::to_string(f.number) << ",Type=" << f.type
+                       << ",Description=\"" << f.description << "\">" << '\n';
+        }
+        out_stream << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO";
+        if (!samples.empty())
+        {
+            out_stream << "\tFORMAT";
+            for (auto const & sample : samples)
+                out_stream << '\t' << sample;
+        }
+        out_stream << '\n';
     }
 
 private:
     std::string fileformat{"VCFv4.3"};
     std::string source{"iGenVarCaller"};
     std::vector<info_entry> info{};
+    std::vector<info_entry> format{};
+    std::vector<std::string> samples{};
 };
 
 /*
@@ -174,6 +209,24 @@ public:
         info.insert_or_assign(info_key, info_value);
     }
 
+    /*! \brief Set the FORMAT keys of the sample values for a variant, e.g. "GT:DR:DV".
+     *
+     * \param[in] format_i - the FORMAT value to use
+     */
+    void set_format(std::string format_i)
+    {
+        format = std::move(format_i);
+    }
+
+    /*! \brief Add the values of the next sample for a variant, e.g. "0/1:10:8".
+     *
+     * \param[in] sample_i - the sample values, in the order of the FORMAT keys
+     */
+    void add_sample(std::string sample_i)
+    {
+        samples.push_back(std::move(sample_i));
+    }
+
     /*! \brief Prints the variant to a given output in VCF format.
      *
      * \tparam stream_type - a stream to print the output to
@@ -203,7 +256,14 @@ public:
             }
             out_stream << (*it).first << "=" << (*it).second << ";";
         }
-        out_stream << (*last).first << "=" << (*last).second << '\n';
+        out_stream << (*last).first << "=" << (*last).second;
+        if (!format.empty())
+        {
+            out_stream << '\t' << format;
+            for (auto const & sample : samples)
+                out_stream << '\t' << sample;
+        }
+        out_stream << '\n';
     }
 
 private:
@@ -215,4 +275,6 @@ private:
     float qual{};
     std::string filter{"PASS"};
     std::map<std::string, std::string> info{};
+    std::string format{};
+    std::vector<std::string> samples{};
 };
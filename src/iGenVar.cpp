@@ -1,12 +1,27 @@
 #include "iGenVar.hpp"
 
+#include <chrono>                                            // for std::chrono::steady_clock
+#include <fstream>                                           // for std::ofstream
+#include <iomanip>                                           // for std::setprecision
+#include <optional>                                          // for std::optional
+#include <stdexcept>                                         // for std::runtime_error
+#include <string>                                            // for std::string
+#include <utility>                                           // for std::pair
+
 #include <seqan3/core/debug_stream.hpp>                     // for seqan3::debug_stream
 
 #include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
 #include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
+#include "modules/genotyping/genotyping.hpp"                        // for genotype_clusters()
+#include "modules/refinement/insertion_consensus.hpp"               // for compute_insertion_consensus()
+#include "modules/refinement/sViper_refinement_method.hpp"          // for the sViper refinement method
+#include "modules/refinement/sVirl_refinement_method.hpp"           // for the sVirl refinement method
 #include "structures/cluster.hpp"                                   // for class Cluster
+#include "structures/indexed_fasta.hpp"                             // for class IndexedFasta
+#include "structures/interval_index.hpp"                            // for class IntervalIndex
+#include "structures/read_ahead_stream.hpp"                         // for struct ReadAheadOptions
 #include "variant_detection/validator.hpp"                          // for class EnumValidator
-#include "variant_detection/variant_detection.hpp"                  // for detect_junctions_in_long_reads_sam_file()
+#include "variant_detection/variant_detection.hpp"                  // for detect_junctions_in_samples()
 #include "variant_detection/variant_output.hpp"                     // for find_and_output_variants()
 
 void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments & args)
@@ -41,6 +56,32 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
                       "Input long read alignments in SAM or BAM format (PacBio, Oxford Nanopore, ...).",
                       seqan3::option_spec::standard,
                       seqan3::input_file_validator{{"sam", "bam"}} );
+    parser.add_option(args.sample_short_reads_file_paths,
+                      '\0', "sample_short_reads",
+                      "Input short read alignments of a further sample in SAM or BAM format. Can be given several "
+                      "times, once per sample. All samples are called jointly. A sample is named after its file, "
+                      "a long read file with the same name belongs to the same sample.",
+                      seqan3::option_spec::standard,
+                      seqan3::input_file_validator{{"sam", "bam"}} );
+    parser.add_option(args.sample_long_reads_file_paths,
+                      '\0', "sample_long_reads",
+                      "Input long read alignments of a further sample in SAM or BAM format. Can be given several "
+                      "times, once per sample. All samples are called jointly. A sample is named after its file, "
+                      "a short read file with the same name belongs to the same sample.",
+                      seqan3::option_spec::standard,
+                      seqan3::input_file_validator{{"sam", "bam"}} );
+    parser.add_option(args.genome_file_path,
+                      'g', "genome",
+                      "Reference genome in FASTA format, optionally indexed with samtools faidx. It is used for the REF "
+                      "column of the vcf output file.",
+                      seqan3::option_spec::standard,
+                      seqan3::input_file_validator{{"fa", "fasta", "fna"}} );
+    parser.add_option(args.exclude_file_path,
+                      '\0', "exclude",
+                      "Regions in BED format, e.g. centromeres and satellite arrays. Alignments that start in these "
+                      "regions are not analyzed and junctions with a breakend in them are dropped.",
+                      seqan3::option_spec::standard,
+                      seqan3::input_file_validator{{"bed"}} );
     parser.add_option(args.output_file_path, 'o', "output",
                       "The path of the vcf output file. If no path is given, will output to standard output.",
                       seqan3::option_spec::standard,
@@ -65,34 +106,85 @@ void initialize_argument_parser(seqan3::argument_parser & parser, cmd_arguments
     parser.add_option(args.max_tol_inserted_length, 't', "max_tol_inserted_length",
                       "Specify what should be the longest tolerated inserted sequence at sites of non-INS SVs (default 5 bp).",
                       seqan3::option_spec::advanced);
+    parser.add_option(args.max_consensus_members, '\0', "max_consensus_members",
+                      "Specify the maximum number of inserted sequences of an insertion that are aligned to compute "
+                      "its sequence for the ALT column. If 0, no consensus is computed and the ALT column is <INS>.",
+                      seqan3::option_spec::advanced,
+                      seqan3::arithmetic_range_validator{0, 1000});
+    parser.add_option(args.max_insert_size, '\0', "max_insert_size",
+                      "Specify the maximum insert size of the read pairs of a read group during its warm-up. Read "
+                      "pairs whose mates lie further apart are discordant.",
+                      seqan3::option_spec::advanced);
+    parser.add_option(args.warm_up_pairs, '\0', "warm_up_pairs",
+                      "Specify the number of proper read pairs of a read group after which its maximum insert size is "
+                      "learned from their template lengths.",
+                      seqan3::option_spec::advanced);
+    parser.add_flag(args.genotype, '\0', "genotype",
+                    "Count the reads that span the breakpoints without supporting the variant and output the "
+                    "genotype of the sample.",
+                    seqan3::option_spec::advanced);
+
+    // Options - Performance:
+    parser.add_option(args.max_depth, '\0', "max_depth",
+                      "Specify the read depth above which the alignments are downsampled deterministically by a hash "
+                      "of their read names. The read support of the variants is rescaled in the output. If 0, no "
+                      "alignments are downsampled.",
+                      seqan3::option_spec::advanced);
+    parser.add_option(args.threads, '\0', "threads",
+                      "Specify the number of threads used for the detection and clustering of junctions, the "
+                      "refinement methods, the insertion consensus and the output.",
+                      seqan3::option_spec::advanced,
+                      seqan3::arithmetic_range_validator{1, 1024});
+    parser.add_option(args.read_ahead_blocks, '\0', "read_ahead_blocks",
+                      "Specify the number of blocks of each alignment file that are read ahead by an additional "
+                      "thread, e.g. for files on network-attached storage. The time spent waiting for the blocks is "
+                      "reported. If 0, the files are read without read-ahead.",
+                      seqan3::option_spec::advanced,
+                      seqan3::arithmetic_range_validator{0, 1024});
+    parser.add_option(args.read_ahead_block_size, '\0', "read_ahead_block_size",
+                      "Specify the size of the blocks that are read ahead in KiB.",
+                      seqan3::option_spec::advanced,
+                      seqan3::arithmetic_range_validator{4, 1048576});
+    parser.add_option(args.timings_file_path, '\0', "timings",
+                      "The path of a tab-separated file to which the wall time of each stage (detection, clustering, "
+                      "refinement, consensus, genotyping and output) is written in seconds, e.g. for benchmarks.",
+                      seqan3::option_spec::advanced,
+                      seqan3::output_file_validator{seqan3::output_file_open_options::open_or_create, {"tsv"}});
 }
 
 void detect_variants_in_alignment_file(cmd_arguments const & args)
 {
+    // Wall time of each stage in seconds, every stage is listed even if it was skipped.
+    std::vector<std::pair<std::string, double>> stage_seconds{};
+    std::chrono::steady_clock::time_point stage_start = std::chrono::steady_clock::now();
+    auto finish_stage = [&stage_seconds, &stage_start] (std::string stage)
+    {
+        std::chrono::steady_clock::time_point const stage_end = std::chrono::steady_clock::now();
+        stage_seconds.emplace_back(std::move(stage), std::chrono::duration<double>(stage_end - stage_start).count());
+        stage_start = stage_end;
+    };
+
     // Store junctions
     std::vector<Junction> junctions{};
 
-    // short reads
-    if (args.alignment_short_reads_file_path != "")
-    {
-        seqan3::debug_stream << "Detect junctions in short reads...\n";
-        detect_junctions_in_short_reads_sam_file(junctions,
-                                                 args.alignment_short_reads_file_path,
-                                                 args.methods,
-                                                 args.min_var_length);
-    }
+    // Regions such as centromeres would only add large piles of artifacts.
+    IntervalIndex const excluded_regions = args.exclude_file_path.empty() ? IntervalIndex{}
+                                                                          : IntervalIndex{args.exclude_file_path};
 
-    // long reads
-    if (args.alignment_long_reads_file_path != "")
-    {
-        seqan3::debug_stream << "Detect junctions in long reads...\n";
-        detect_junctions_in_long_reads_sam_file(junctions,
-                                                args.alignment_long_reads_file_path,
-                                                args.methods,
-                                                args.min_var_length);
-    }
+    // The samples are read in parallel, junctions know their sample.
+    std::vector<AlignmentSample> const samples = get_samples(args);
+    detect_junctions_in_samples(junctions,
+                                samples,
+                                args.methods,
+                                args.min_var_length,
+                                args.threads,
+                                excluded_regions,
+                                args.max_depth,
+                                ReadAheadOptions{args.read_ahead_blocks, size_t{args.read_ahead_block_size} << 10},
+                                ReadPairOptions{args.max_insert_size, args.warm_up_pairs});
 
     std::sort(junctions.begin(), junctions.end());
+    finish_stage("detection");
 
     seqan3::debug_stream << "Start clustering...\n";
 
@@ -103,7 +195,7 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
             clusters = simple_clustering_method(junctions);
             break;
         case 1: // hierarchical clustering
-            clusters = hierarchical_clustering_method(junctions, 10.0);
+            clusters = hierarchical_clustering_method(junctions, 10.0, args.threads);
             break;
         case 2: // self-balancing_binary_tree,
             seqan3::debug_stream << "The self-balancing binary tree clustering method is not yet implemented\n";
@@ -114,6 +206,12 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
     }
 
     seqan3::debug_stream << "Done with clustering. Found " << clusters.size() << " junction clusters.\n";
+    finish_stage("clustering");
+
+    // The reference is mapped into memory, only the bases at the variants are read.
+    std::optional<IndexedFasta> reference{};
+    if (!args.genome_file_path.empty())
+        reference.emplace(args.genome_file_path);
 
     switch (args.refinement_method)
     {
@@ -121,14 +219,59 @@ void detect_variants_in_alignment_file(cmd_arguments const & args)
             seqan3::debug_stream << "No refinement was selected.\n";
             break;
         case 1: // sViper_refinement_method
-            seqan3::debug_stream << "The sViper refinement method is not yet implemented\n";
+            if (!reference)
+            {
+                seqan3::debug_stream << "The sViper refinement method needs a reference genome (-g). "
+                                        "No refinement was done.\n";
+                break;
+            }
+            // Long reads span more variants than short reads, so they are used if both are given. The reads of the
+            // first sample are enough to refine the breakpoints.
+            sViper_refinement_method(clusters,
+                                     samples.front().get_primary_file_path(),
+                                     *reference,
+                                     args.threads,
+                                     args.min_var_length);
             break;
         case 2: // sVirl_refinement_method
-            seqan3::debug_stream << "The sVirl refinement method is not yet implemented\n";
+            if (!reference)
+            {
+                seqan3::debug_stream << "The sVirl refinement method needs a reference genome (-g). "
+                                        "No refinement was done.\n";
+                break;
+            }
+            sVirl_refinement_method(clusters,
+                                    samples.front().get_primary_file_path(),
+                                    *reference,
+                                    args.threads,
+                                    args.min_var_length);
             break;
     }
+    finish_stage("refinement");
+
+    if (args.max_consensus_members > 0)
+        compute_insertion_consensus(clusters, args.min_var_length, args.max_consensus_members, args.threads);
+    finish_stage("consensus");
+
+    if (args.genotype)
+    {
+        std::vector<std::filesystem::path> alignment_file_paths{};
+        for (AlignmentSample const & sample : samples)
+            alignment_file_paths.push_back(sample.get_primary_file_path());
+        genotype_clusters(clusters, alignment_file_paths, args.min_var_length, args.max_var_length, args.threads);
+    }
+    finish_stage("genotyping");
 
-    find_and_output_variants(clusters, args, args.output_file_path);
+    find_and_output_variants(clusters, args, args.output_file_path, reference ? &*reference : nullptr);
+    finish_stage("output");
+
+    if (!args.timings_file_path.empty())
+    {
+        std::ofstream timings_file{args.timings_file_path};
+        timings_file << "stage\tseconds\n" << std::fixed << std::setprecision(6);
+        for (auto const & [stage, seconds] : stage_seconds)
+            timings_file << stage << '\t' << seconds << '\n';
+    }
 }
 
 int main(int argc, char ** argv)
@@ -149,7 +292,8 @@ int main(int argc, char ** argv)
     }
 
     // Check if we have at least one input file.
-    if (args.alignment_short_reads_file_path == "" && args.alignment_long_reads_file_path == "")
+    if (args.alignment_short_reads_file_path == "" && args.alignment_long_reads_file_path == "" &&
+        args.sample_short_reads_file_paths.empty() && args.sample_long_reads_file_paths.empty())
     {
         seqan3::debug_stream << "[Error] You need to input at least one sam/bam file.\n"
                              << "Please use -i or -input_short_reads to pass a short read file "
@@ -168,6 +312,17 @@ int main(int argc, char ** argv)
         return -1;
     }
 
+    // Check that the samples have distinct names.
+    try
+    {
+        get_samples(args);
+    }
+    catch (std::runtime_error const & ext)
+    {
+        seqan3::debug_stream << "[Error] " << ext.what() << '\n';
+        return -1;
+    }
+
     detect_variants_in_alignment_file(args);
 
     return 0;
@@ -1,8 +1,13 @@
 #include "modules/clustering/hierarchical_clustering_method.hpp"
 
+#include <algorithm>                                              // for std::sort, std::any_of
+#include <iterator>                                               // for std::make_move_iterator
 #include <limits>                                                 // for infinity
+#include <numeric>                                                // for std::iota
 
 #include "fastcluster.h"                                          // for hclust_fast
+#include "structures/arena.hpp"                                   // for class Arena and ArenaAllocator
+#include "structures/work_stealing_scheduler.hpp"                 // for class WorkStealingScheduler
 
 std::vector<std::vector<Junction>> partition_junctions(std::vector<Junction> const & junctions)
 {
@@ -28,10 +33,9 @@ std::vector<std::vector<Junction>> partition_junctions(std::vector<Junction> con
                     return a.get_mate2() < b.get_mate2();
                 });
                 current_partition_splitted = split_partition_based_on_mate2(current_partition);
-                for (std::vector<Junction> partition : current_partition_splitted)
-                {
-                    final_partitions.push_back(partition);
-                }
+                final_partitions.insert(final_partitions.end(),
+                                        std::make_move_iterator(current_partition_splitted.begin()),
+                                        std::make_move_iterator(current_partition_splitted.end()));
                 current_partition.clear();
             }
             current_partition.push_back(junction);
@@ -39,14 +43,13 @@ std::vector<std::vector<Junction>> partition_junctions(std::vector<Junction> con
     }
     if (!current_partition.empty())
     {
-        std::sort(current_partition.begin(), current_partition.end(), [](Junction a, Junction b) {
+        std::sort(current_partition.begin(), current_partition.end(), [](Junction const & a, Junction const & b) {
             return a.get_mate2() < b.get_mate2();
         });
         current_partition_splitted = split_partition_based_on_mate2(current_partition);
-        for (std::vector<Junction> partition : current_partition_splitted)
-        {
-            final_partitions.push_back(partition);
-        }
+        final_partitions.insert(final_partitions.end(),
+                                std::make_move_iterator(current_partition_splitted.begin()),
+                                std::make_move_iterator(current_partition_splitted.end()));
     }
     return final_partitions;
 }
@@ -69,7 +72,7 @@ std::vector<std::vector<Junction>> split_partition_based_on_mate2(std::vector<Ju
                 abs(junction.get_mate2().position - current_partition.back().get_mate2().position) > 50)
             {
                 std::sort(current_partition.begin(), current_partition.end());
-                splitted_partition.push_back(current_partition);
+                splitted_partition.push_back(std::move(current_partition));
                 current_partition.clear();
             }
             current_partition.push_back(junction);
@@ -78,7 +81,7 @@ std::vector<std::vector<Junction>> split_partition_based_on_mate2(std::vector<Ju
     if (!current_partition.empty())
     {
         std::sort(current_partition.begin(), current_partition.end());
-        splitted_partition.push_back(current_partition);
+        splitted_partition.push_back(std::move(current_partition));
     }
     return splitted_partition;
 }
@@ -104,61 +107,182 @@ int junction_distance(Junction const & lhs, Junction const & rhs)
     }
 }
 
-std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> const & junctions,
-                                                    double clustering_cutoff)
+/*! \brief Fills `labels` with the cluster label of each junction of a partition, like hclust_fast() and cutree_cdist()
+ *         with average linkage, but with the weights of the junctions as initial cluster sizes. The distance of two
+ *         clusters is then the average distance of their reads, so a merged junction is clustered like the identical
+ *         junctions it stands for, which fastcluster cannot do.
+ *
+ * \details The dendrogram is built by the nearest-neighbour chain algorithm in O(n^2) time, which finds the same merges
+ *          as fastcluster for the reducible average linkage. The merges below `clustering_cutoff` are joined in a
+ *          union-find forest, whose roots are the labels.
+ */
+static void cluster_weighted_partition(std::vector<Junction> const & partition,
+                                       double const clustering_cutoff,
+                                       Arena & arena,
+                                       std::vector<int, ArenaAllocator<int>> & labels)
 {
-    auto partitions = partition_junctions(junctions);
-    std::vector<Cluster> clusters{};
-    for (std::vector<Junction> & partition : partitions)
+    size_t const partition_size = partition.size();
+    // Full distance matrix, the row of a merged cluster is updated in place.
+    std::vector<double, ArenaAllocator<double>> distances (partition_size * partition_size, arena);
+    for (size_t i = 0; i < partition_size; ++i)
+        for (size_t j = i + 1; j < partition_size; ++j)
+            distances[i * partition_size + j] = distances[j * partition_size + i] = junction_distance(partition[i],
+                                                                                                      partition[j]);
+    std::vector<double, ArenaAllocator<double>> weights (partition_size, arena);
+    for (size_t i = 0; i < partition_size; ++i)
+        weights[i] = partition[i].get_weight();
+    std::vector<char, ArenaAllocator<char>> active (partition_size, true, arena);
+    std::iota(labels.begin(), labels.end(), 0);
+    auto find_label = [&labels] (int label)
     {
-        size_t partition_size = partition.size();
-        if (partition_size < 2)
+        while (labels[label] != label)
+            label = labels[label] = labels[labels[label]];
+        return label;
+    };
+
+    std::vector<size_t, ArenaAllocator<size_t>> chain (arena);
+    chain.reserve(partition_size);
+    size_t first_active = 0;
+    for (size_t remaining = partition_size; remaining > 1;)
+    {
+        if (chain.empty())
         {
-            clusters.emplace_back(std::move(partition));
+            while (!active[first_active])
+                ++first_active;
+            chain.push_back(first_active);
+        }
+        size_t const current = chain.back();
+        // The previous cluster of the chain wins ties, so the chain ends in a pair of reciprocal nearest neighbours.
+        size_t const previous = (chain.size() > 1) ? chain[chain.size() - 2] : partition_size;
+        size_t nearest = previous;
+        double nearest_distance = (previous < partition_size) ? distances[current * partition_size + previous]
+                                                              : std::numeric_limits<double>::infinity();
+        for (size_t k = 0; k < partition_size; ++k)
+        {
+            if (active[k] && k != current && distances[current * partition_size + k] < nearest_distance)
+            {
+                nearest = k;
+                nearest_distance = distances[current * partition_size + k];
+            }
+        }
+        if (nearest != previous)
+        {
+            chain.push_back(nearest);
             continue;
         }
-        // Compute condensed distance matrix (upper triangle of the full distance matrix)
-        std::vector<double> distmat ((partition_size * (partition_size - 1)) / 2);
-        int k, i, j;
-        for (i = k = 0; i < partition_size; ++i) {
-            for (j = i + 1; j< partition_size; ++j) {
-                // Compute distance between junctions i and j
-                distmat[k] = junction_distance(partition[i], partition[j]);
-                ++k;
+
+        // Merge the pair, the merged cluster takes the place of `current`.
+        chain.pop_back();
+        chain.pop_back();
+        if (nearest_distance < clustering_cutoff)
+            labels[find_label(nearest)] = find_label(current);
+        double const merged_weight = weights[current] + weights[nearest];
+        for (size_t k = 0; k < partition_size; ++k)
+        {
+            if (active[k] && k != current && k != nearest)
+            {
+                double const distance = (weights[current] * distances[current * partition_size + k] +
+                                         weights[nearest] * distances[nearest * partition_size + k]) / merged_weight;
+                distances[current * partition_size + k] = distances[k * partition_size + current] = distance;
             }
         }
+        weights[current] = merged_weight;
+        active[nearest] = false;
+        --remaining;
+    }
+    for (size_t i = 0; i < partition_size; ++i)
+        labels[i] = find_label(i);
+}
 
-        // Perform hierarchical clustering
-        // `height` is filled with cluster distance for each step
-        // `merge` contains dendrogram
-        std::vector<int> merge (2 * (partition_size - 1));
-        std::vector<double> height (partition_size - 1);
-        hclust_fast(partition_size, distmat.data(), HCLUST_METHOD_AVERAGE, merge.data(), height.data());
+std::vector<Cluster> hierarchical_clustering_method(std::vector<Junction> const & junctions,
+                                                    double clustering_cutoff,
+                                                    uint16_t const threads)
+{
+    auto partitions = partition_junctions(junctions);
 
-        // Fill labels[i] with cluster label of junction i.
-        // Clustering is stopped at step with cluster distance >= clustering_cutoff
-        std::vector<int> labels (partition_size);
-        cutree_cdist(partition_size, merge.data(), height.data(), clustering_cutoff, labels.data());
+    // The partitions are clustered from the largest to the smallest, so that a few large partitions (e.g. at repeats)
+    // are started first and the small ones fill the gaps.
+    std::vector<size_t> partition_order(partitions.size());
+    std::iota(partition_order.begin(), partition_order.end(), 0);
+    std::sort(partition_order.begin(), partition_order.end(), [&partitions] (size_t const lhs, size_t const rhs)
+    {
+        return partitions[lhs].size() != partitions[rhs].size() ? partitions[lhs].size() > partitions[rhs].size()
+                                                                : lhs < rhs;
+    });
 
-        std::unordered_map<int, std::vector<Junction>> label_to_junctions{};
-        for (int i = 0; i < partition_size; ++i)
+    WorkStealingScheduler const scheduler{threads};
+    // The buffers of a partition all die together, so they are taken from an arena that is reset per partition.
+    std::vector<Arena> arenas(scheduler.get_threads());
+    std::vector<std::vector<Cluster>> partition_clusters(partitions.size());
+    scheduler.run(partitions.size(), [&] (size_t const task_id, uint16_t const worker_id)
+    {
+        size_t const partition_id = partition_order[task_id];
+        std::vector<Junction> & partition = partitions[partition_id];
+        std::vector<Cluster> & clusters = partition_clusters[partition_id];
+        size_t partition_size = partition.size();
+        if (partition_size < 2)
         {
-            if (label_to_junctions.find(labels[i]) != label_to_junctions.end())
-            {
-                label_to_junctions[labels[i]].push_back(std::move(partition[i]));
-            }
-            else{
-                label_to_junctions.emplace(labels[i], std::vector{std::move(partition[i])});
+            clusters.emplace_back(std::move(partition));
+            return;
+        }
+        Arena & arena = arenas[worker_id];
+        arena.reset();
+        std::vector<int, ArenaAllocator<int>> labels (partition_size, arena);
+        bool const has_merged_junctions = std::any_of(partition.begin(), partition.end(), [] (Junction const & junction)
+        {
+            return junction.get_weight() > 1;
+        });
+        if (has_merged_junctions)
+        {
+            cluster_weighted_partition(partition, clustering_cutoff, arena, labels);
+        }
+        else
+        {
+            // Compute condensed distance matrix (upper triangle of the full distance matrix)
+            std::vector<double, ArenaAllocator<double>> distmat ((partition_size * (partition_size - 1)) / 2, arena);
+            size_t k, i, j;
+            for (i = k = 0; i < partition_size; ++i) {
+                for (j = i + 1; j< partition_size; ++j) {
+                    // Compute distance between junctions i and j
+                    distmat[k] = junction_distance(partition[i], partition[j]);
+                    ++k;
+                }
             }
+
+            // Perform hierarchical clustering
+            // `height` is filled with cluster distance for each step
+            // `merge` contains dendrogram
+            std::vector<int, ArenaAllocator<int>> merge (2 * (partition_size - 1), arena);
+            std::vector<double, ArenaAllocator<double>> height (partition_size - 1, arena);
+            hclust_fast(partition_size, distmat.data(), HCLUST_METHOD_AVERAGE, merge.data(), height.data());
+
+            // Fill labels[i] with cluster label of junction i.
+            // Clustering is stopped at step with cluster distance >= clustering_cutoff
+            cutree_cdist(partition_size, merge.data(), height.data(), clustering_cutoff, labels.data());
         }
 
-        // Add new clusters: junctions with the same label belong to one cluster
-        for (auto & [lab, jun] : label_to_junctions )
+        // Add new clusters: junctions with the same label belong to one cluster. The junctions are grouped by sorting
+        // their indices by label and index, which keeps the sorted order of the partition within each cluster.
+        std::vector<size_t, ArenaAllocator<size_t>> order (partition_size, arena);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&labels] (size_t const lhs, size_t const rhs)
         {
-            std::sort(jun.begin(), jun.end());
-            clusters.emplace_back(jun);
+            return labels[lhs] != labels[rhs] ? labels[lhs] < labels[rhs] : lhs < rhs;
+        });
+        for (size_t begin = 0, end = 0; begin < partition_size; begin = end)
+        {
+            std::vector<Junction> members{};
+            for (end = begin; end < partition_size && labels[order[end]] == labels[order[begin]]; ++end)
+                members.push_back(std::move(partition[order[end]]));
+            clusters.emplace_back(std::move(members));
         }
-    }
+    });
+
+    std::vector<Cluster> clusters{};
+    for (std::vector<Cluster> & clusters_of_partition : partition_clusters)
+        clusters.insert(clusters.end(),
+                        std::make_move_iterator(clusters_of_partition.begin()),
+                        std::make_move_iterator(clusters_of_partition.end()));
     std::sort(clusters.begin(), clusters.end());
     return clusters;
 }
@@ -0,0 +1,227 @@
+#include "modules/genotyping/genotyping.hpp"
+
+#include <algorithm>        // for std::sort, std::max, std::min, std::remove_if
+#include <atomic>           // for std::atomic
+#include <exception>        // for std::exception_ptr
+#include <mutex>            // for std::mutex
+#include <thread>           // for std::thread
+#include <unordered_map>    // for std::unordered_map
+#include <utility>          // for std::pair
+
+#include <seqan3/core/debug_stream.hpp>
+#include <seqan3/io/sam_file/input.hpp>         // SAM/BAM support (seqan3::sam_file_input)
+#include <seqan3/std/algorithm>                 // for std::ranges::any_of
+
+#include "variant_detection/bam_functions.hpp"  // for hasFlag* functions, get_reference_length()
+
+std::vector<GenotypingSite> extract_genotyping_sites(std::vector<Cluster> const & clusters,
+                                                     uint64_t const min_var_length,
+                                                     uint64_t const max_var_length)
+{
+    std::vector<GenotypingSite> sites{};
+    for (size_t cluster_id = 0; cluster_id < clusters.size(); ++cluster_id)
+    {
+        Breakend const mate1 = clusters[cluster_id].get_refined_mate1();
+        Breakend const mate2 = clusters[cluster_id].get_refined_mate2();
+        if (mate1.seq_name != mate2.seq_name || mate1.orientation != strand::forward ||
+            mate2.orientation != strand::forward)
+            continue;
+
+        int64_t const distance = mate2.position - mate1.position;
+        if (distance == 1)
+        {
+            // Insertion
+            if (clusters[cluster_id].get_refined_inserted_sequence_size() >= static_cast<int64_t>(min_var_length))
+                sites.push_back(GenotypingSite{cluster_id, mate1.seq_name, mate2.position});
+        }
+        else if (distance >= static_cast<int64_t>(min_var_length) && distance <= static_cast<int64_t>(max_var_length))
+        {
+            // Deletion
+            sites.push_back(GenotypingSite{cluster_id, mate1.seq_name, mate1.position + 1});
+            sites.push_back(GenotypingSite{cluster_id, mate1.seq_name, mate2.position});
+        }
+    }
+    return sites;
+}
+
+std::vector<size_t> count_reference_support(std::filesystem::path const & alignment_file_path,
+                                            std::vector<GenotypingSite> & sites,
+                                            uint64_t const min_var_length,
+                                            int32_t const min_overhang)
+{
+    // Open input alignment file, the sequences and qualities are not needed.
+    using my_fields = seqan3::fields<seqan3::field::flag,       // 2: FLAG
+                                     seqan3::field::ref_id,     // 3: RNAME
+                                     seqan3::field::ref_offset, // 4: POS
+                                     seqan3::field::mapq,       // 5: MAPQ
+                                     seqan3::field::cigar>;     // 6: CIGAR
+
+    seqan3::sam_file_input alignment_file{alignment_file_path, my_fields{}};
+
+    // Check that the file is sorted before proceeding.
+    if (alignment_file.header().sorting != "coordinate")
+    {
+        throw seqan3::format_error{"ERROR: Input file must be sorted by coordinate (e.g. samtools sort)"};
+    }
+    std::unordered_map<std::string, int32_t> alignment_ref_ids{};
+    for (std::string const & ref_name : alignment_file.header().ref_ids())
+    {
+        int32_t const ref_id = alignment_ref_ids.size();
+        alignment_ref_ids.emplace(ref_name, ref_id);
+    }
+
+    // Sort the sites like the alignments, so that they can be counted in a single pass.
+    sites.erase(std::remove_if(sites.begin(), sites.end(), [&] (GenotypingSite const & site)
+    {
+        return alignment_ref_ids.find(site.ref_name) == alignment_ref_ids.end();
+    }), sites.end());
+    std::sort(sites.begin(), sites.end(), [&] (GenotypingSite const & lhs, GenotypingSite const & rhs)
+    {
+        return std::pair{alignment_ref_ids[lhs.ref_name], lhs.position} <
+               std::pair{alignment_ref_ids[rhs.ref_name], rhs.position};
+    });
+    std::vector<int32_t> site_ref_ids(sites.size());
+    for (size_t site_id = 0; site_id < sites.size(); ++site_id)
+        site_ref_ids[site_id] = alignment_ref_ids[sites[site_id].ref_name];
+
+    std::vector<size_t> reference_support(sites.size(), 0);
+    size_t first_site = 0;
+    // The reference intervals of the large indels of the current alignment, an insertion is an empty interval.
+    std::vector<std::pair<int32_t, int32_t>> large_indels{};
+
+    for (auto & record : alignment_file)
+    {
+        if (first_site == sites.size())
+            break;
+
+        seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
+        int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
+        int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
+        uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
+        auto const & cigar                  = record.cigar_sequence();                  // 6: CIGAR
+
+        if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagSupplementary(flag) || hasFlagDuplicate(flag) ||
+            mapq < 20 || ref_id < 0 || ref_pos < 0)
+            continue;
+
+        // No later alignment starts early enough to span the sites before this alignment.
+        while (first_site < sites.size() &&
+               (site_ref_ids[first_site] < ref_id ||
+                (site_ref_ids[first_site] == ref_id && sites[first_site].position - min_overhang < ref_pos)))
+        {
+            ++first_site;
+        }
+        if (first_site == sites.size() || site_ref_ids[first_site] != ref_id)
+            continue;
+        int32_t const ref_end = ref_pos + get_reference_length(cigar);
+        if (sites[first_site].position + min_overhang > ref_end)
+            continue;
+
+        large_indels.clear();
+        int32_t reference_position = ref_pos;
+        for (auto [element_length, element_operation] : cigar)
+        {
+            int32_t const length = element_length;
+            char const operation = element_operation.to_char();
+            bool const is_insertion = (operation == 'I');
+            bool const is_deletion = (operation == 'D' || operation == 'N');
+            if ((is_insertion || is_deletion) && length >= static_cast<int64_t>(min_var_length))
+                large_indels.emplace_back(reference_position, reference_position + (is_deletion ? length : 0));
+            if (is_deletion || operation == 'M' || operation == '=' || operation == 'X')
+                reference_position += length;
+        }
+
+        for (size_t site_id = first_site;
+             site_id < sites.size() && site_ref_ids[site_id] == ref_id &&
+             sites[site_id].position + min_overhang <= ref_end;
+             ++site_id)
+        {
+            int32_t const begin = sites[site_id].position - min_overhang;
+            int32_t const end = sites[site_id].position + min_overhang;
+            bool const has_large_indel = std::ranges::any_of(large_indels, [&] (auto const & indel)
+            {
+                return indel.first <= end && indel.second >= begin;
+            });
+            if (!has_large_indel)
+                ++reference_support[site_id];
+        }
+    }
+    return reference_support;
+}
+
+void genotype_clusters(std::vector<Cluster> & clusters,
+                       std::vector<std::filesystem::path> const & alignment_file_paths,
+                       uint64_t const min_var_length,
+                       uint64_t const max_var_length,
+                       uint16_t const threads,
+                       int32_t const min_overhang)
+{
+    std::vector<GenotypingSite> const sites = extract_genotyping_sites(clusters, min_var_length, max_var_length);
+
+    // Every thread takes the next sample and counts its reads at a copy of the sites.
+    std::vector<std::vector<GenotypingSite>> sample_sites(alignment_file_paths.size());
+    std::vector<std::vector<size_t>> sample_reference_support(alignment_file_paths.size());
+    std::atomic<size_t> next_sample{0};
+    std::exception_ptr exception{};
+    std::mutex exception_mutex{};
+    auto count_samples = [&] ()
+    {
+        for (size_t sample_id = next_sample++; sample_id < alignment_file_paths.size(); sample_id = next_sample++)
+        {
+            try
+            {
+                sample_sites[sample_id] = sites;
+                sample_reference_support[sample_id] = count_reference_support(alignment_file_paths[sample_id],
+                                                                              sample_sites[sample_id],
+                                                                              min_var_length,
+                                                                              min_overhang);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{exception_mutex};
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> workers{};
+    for (uint16_t thread = 1; thread < std::min<size_t>(threads, alignment_file_paths.size()); ++thread)
+        workers.emplace_back(count_samples);
+    count_samples();
+    for (std::thread & worker : workers)
+        worker.join();
+    if (exception)
+        std::rethrow_exception(exception);
+
+    // Sites on sequences without alignments have no reference support.
+    std::vector<std::vector<size_t>> reference_support(clusters.size());
+    for (GenotypingSite const & site : sites)
+        reference_support[site.cluster_id].assign(alignment_file_paths.size(), 0);
+    for (size_t sample_id = 0; sample_id < alignment_file_paths.size(); ++sample_id)
+    {
+        for (size_t site_id = 0; site_id < sample_sites[sample_id].size(); ++site_id)
+        {
+            size_t & support = reference_support[sample_sites[sample_id][site_id].cluster_id][sample_id];
+            support = std::max(support, sample_reference_support[sample_id][site_id]);
+        }
+    }
+    for (size_t cluster_id = 0; cluster_id < clusters.size(); ++cluster_id)
+    {
+        if (!reference_support[cluster_id].empty())
+            clusters[cluster_id].set_reference_support(std::move(reference_support[cluster_id]));
+    }
+    seqan3::debug_stream << "Counted the reads supporting the reference at " << sites.size() << " breakpoints.\n";
+}
+
+std::string genotype(size_t const reference_support, size_t const variant_support)
+{
+    size_t const total_support = reference_support + variant_support;
+    if (total_support == 0)
+        return "./.";
+    double const variant_allele_fraction = static_cast<double>(variant_support) / total_support;
+    if (variant_allele_fraction < 0.2)
+        return "0/0";
+    if (variant_allele_fraction >= 0.8)
+        return "1/1";
+    return "0/1";
+}
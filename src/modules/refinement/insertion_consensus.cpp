@@ -0,0 +1,207 @@
+#include "modules/refinement/insertion_consensus.hpp"
+
+#include <algorithm>    // for std::sort, std::stable_sort, std::max_element, std::remove_if
+#include <array>        // for std::array
+#include <atomic>       // for std::atomic
+#include <cstdlib>      // for std::abs
+#include <thread>       // for std::thread
+#include <tuple>        // for std::tie
+
+#include <seqan3/alignment/configuration/all.hpp>
+#include <seqan3/alignment/pairwise/align_pairwise.hpp>
+#include <seqan3/alignment/scoring/nucleotide_scoring_scheme.hpp>
+#include <seqan3/alphabet/concept.hpp>
+#include <seqan3/alphabet/gap/gap.hpp>
+
+/*! \brief Aligns the sequences to the backbone and returns the consensus of the pileup.
+ *
+ * \param[in] backbone          - sequence that the other sequences are aligned to
+ * \param[in] sequences         - sequences to align
+ * \param[in] backbone_votes    - whether the backbone is one of the sequences and votes for its own bases
+ */
+static seqan3::dna5_vector pileup_consensus(seqan3::dna5_vector const & backbone,
+                                            std::vector<seqan3::dna5_vector> const & sequences,
+                                            bool const backbone_votes)
+{
+    // The votes for the bases (by rank) and for a deletion (last element) at each position of the backbone.
+    constexpr size_t deletion_vote = seqan3::alphabet_size<seqan3::dna5>;
+    std::vector<std::array<uint32_t, deletion_vote + 1>> base_votes(backbone.size(),
+                                                                     std::array<uint32_t, deletion_vote + 1>{});
+    // The sequences inserted before each base of the backbone and after the last one.
+    std::vector<std::vector<seqan3::dna5_vector>> insertions(backbone.size() + 1);
+
+    int32_t band = backbone.size() / 10 + 1;
+    for (seqan3::dna5_vector const & sequence : sequences)
+    {
+        int32_t const length_difference = static_cast<int32_t>(sequence.size()) - static_cast<int32_t>(backbone.size());
+        band = std::max<int32_t>(band, std::abs(length_difference) + backbone.size() / 10 + 1);
+    }
+
+    auto sequence_pairs = sequences | std::views::transform([&backbone] (seqan3::dna5_vector const & sequence)
+    {
+        return std::tie(backbone, sequence);
+    });
+    auto const config = seqan3::align_cfg::method_global{} |
+                        seqan3::align_cfg::scoring_scheme{seqan3::nucleotide_scoring_scheme{
+                            seqan3::match_score{2}, seqan3::mismatch_score{-3}}} |
+                        seqan3::align_cfg::gap_cost_affine{seqan3::align_cfg::open_score{-5},
+                                                           seqan3::align_cfg::extension_score{-1}} |
+                        seqan3::align_cfg::band_fixed_size{seqan3::align_cfg::lower_diagonal{-band},
+                                                           seqan3::align_cfg::upper_diagonal{band}} |
+                        seqan3::align_cfg::output_alignment{};
+
+    for (auto const & result : seqan3::align_pairwise(sequence_pairs, config))
+    {
+        auto const & [backbone_row, sequence_row] = result.alignment();
+        size_t position = 0;
+        seqan3::dna5_vector inserted_sequence{};
+        auto sequence_column = sequence_row.begin();
+        for (auto backbone_column = backbone_row.begin();
+             backbone_column != backbone_row.end();
+             ++backbone_column, ++sequence_column)
+        {
+            if (*backbone_column == seqan3::gap{})
+            {
+                inserted_sequence.push_back((*sequence_column).template convert_to<seqan3::dna5>());
+                continue;
+            }
+            if (!inserted_sequence.empty())
+            {
+                insertions[position].push_back(std::move(inserted_sequence));
+                inserted_sequence.clear();
+            }
+            if (*sequence_column == seqan3::gap{})
+                ++base_votes[position][deletion_vote];
+            else
+                ++base_votes[position][seqan3::to_rank((*sequence_column).template convert_to<seqan3::dna5>())];
+            ++position;
+        }
+        if (!inserted_sequence.empty())
+            insertions[position].push_back(std::move(inserted_sequence));
+    }
+
+    size_t const number_of_sequences = sequences.size() + (backbone_votes ? 1 : 0);
+    seqan3::dna5_vector consensus{};
+    for (size_t position = 0; position <= backbone.size(); ++position)
+    {
+        // The most frequent inserted sequence is added if most sequences have an insertion here.
+        std::vector<seqan3::dna5_vector> & inserted_sequences = insertions[position];
+        if (inserted_sequences.size() * 2 > number_of_sequences)
+        {
+            std::sort(inserted_sequences.begin(), inserted_sequences.end());
+            auto most_frequent = inserted_sequences.begin();
+            size_t most_frequent_count = 0;
+            for (auto run_begin = inserted_sequences.begin(); run_begin != inserted_sequences.end();)
+            {
+                auto run_end = std::find_if(run_begin, inserted_sequences.end(), [&] (auto const & sequence)
+                {
+                    return sequence != *run_begin;
+                });
+                if (static_cast<size_t>(run_end - run_begin) > most_frequent_count)
+                {
+                    most_frequent = run_begin;
+                    most_frequent_count = run_end - run_begin;
+                }
+                run_begin = run_end;
+            }
+            consensus.insert(consensus.end(), most_frequent->begin(), most_frequent->end());
+        }
+        if (position == backbone.size())
+            break;
+
+        // The base with the most votes is kept, unless most sequences delete it.
+        std::array<uint32_t, deletion_vote + 1> & votes = base_votes[position];
+        if (backbone_votes)
+            ++votes[seqan3::to_rank(backbone[position])];
+        size_t const most_votes = std::max_element(votes.begin(), votes.end()) - votes.begin();
+        if (most_votes != deletion_vote)
+            consensus.push_back(seqan3::dna5{}.assign_rank(most_votes));
+    }
+    return consensus;
+}
+
+seqan3::dna5_vector insertion_consensus(std::vector<seqan3::dna5_vector> inserted_sequences, size_t const max_members)
+{
+    inserted_sequences.erase(std::remove_if(inserted_sequences.begin(),
+                                            inserted_sequences.end(),
+                                            [] (seqan3::dna5_vector const & sequence)
+                                            {
+                                                return sequence.empty();
+                                            }),
+                             inserted_sequences.end());
+    if (inserted_sequences.empty() || max_members == 0)
+        return {};
+
+    // Select the sequences with the lengths closest to the median length, the first one has the median length.
+    std::sort(inserted_sequences.begin(), inserted_sequences.end(), [] (auto const & lhs, auto const & rhs)
+    {
+        return lhs.size() < rhs.size();
+    });
+    int64_t const median_length = inserted_sequences[inserted_sequences.size() / 2].size();
+    std::stable_sort(inserted_sequences.begin(), inserted_sequences.end(), [median_length] (auto const & lhs,
+                                                                                           auto const & rhs)
+    {
+        return std::abs(static_cast<int64_t>(lhs.size()) - median_length) <
+               std::abs(static_cast<int64_t>(rhs.size()) - median_length);
+    });
+    if (inserted_sequences.size() > max_members)
+        inserted_sequences.resize(max_members);
+
+    seqan3::dna5_vector backbone = std::move(inserted_sequences.front());
+    inserted_sequences.erase(inserted_sequences.begin());
+    if (inserted_sequences.empty())
+        return backbone;
+
+    seqan3::dna5_vector const first_consensus = pileup_consensus(backbone, inserted_sequences, true);
+    if (first_consensus.empty())
+        return backbone;
+    inserted_sequences.push_back(std::move(backbone));
+    seqan3::dna5_vector consensus = pileup_consensus(first_consensus, inserted_sequences, false);
+    return consensus.empty() ? first_consensus : consensus;
+}
+
+void compute_insertion_consensus(std::vector<Cluster> & clusters,
+                                 uint64_t const min_var_length,
+                                 size_t const max_members,
+                                 uint16_t const threads)
+{
+    // Every thread takes the next cluster and only changes this one.
+    std::atomic<size_t> next_cluster{0};
+    auto compute_consensus = [&] ()
+    {
+        for (size_t cluster_id = next_cluster++; cluster_id < clusters.size(); cluster_id = next_cluster++)
+        {
+            Cluster & cluster = clusters[cluster_id];
+            if (cluster.get_refined_inserted_sequence())
+                continue;
+            Breakend const mate1 = cluster.get_refined_mate1();
+            Breakend const mate2 = cluster.get_refined_mate2();
+            if (mate1.seq_name != mate2.seq_name ||
+                mate1.orientation != strand::forward ||
+                mate2.orientation != strand::forward ||
+                mate2.position - mate1.position != 1 ||
+                cluster.get_average_inserted_sequence_size() < static_cast<int64_t>(min_var_length))
+            {
+                continue;
+            }
+
+            std::vector<seqan3::dna5_vector> inserted_sequences{};
+            // A merged junction contributes the inserted sequence of each of its reads.
+            for (Junction const & member : cluster.get_members())
+            {
+                inserted_sequences.insert(inserted_sequences.end(),
+                                          member.get_weight(),
+                                          member.get_inserted_sequence());
+            }
+            seqan3::dna5_vector consensus = insertion_consensus(std::move(inserted_sequences), max_members);
+            if (!consensus.empty())
+                cluster.set_refined_inserted_sequence(std::move(consensus));
+        }
+    };
+    std::vector<std::thread> workers{};
+    for (uint16_t thread = 1; thread < threads; ++thread)
+        workers.emplace_back(compute_consensus);
+    compute_consensus();
+    for (std::thread & worker : workers)
+        worker.join();
+}
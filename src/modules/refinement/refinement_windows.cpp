@@ -0,0 +1,201 @@
+#include "modules/refinement/refinement_windows.hpp"
+
+#include <algorithm>        // for std::sort, std::max, std::remove_if
+#include <unordered_map>    // for std::unordered_map
+
+#include <seqan3/alphabet/views/char_to.hpp>
+#include <seqan3/io/sam_file/input.hpp>         // SAM/BAM support (seqan3::sam_file_input)
+#include <seqan3/utility/views/to.hpp>
+
+#include "structures/aligned_segment.hpp"       // for struct AlignedSegment
+#include "variant_detection/bam_functions.hpp"  // for hasFlag* functions, get_reference_length()
+
+std::pair<int32_t, int32_t> query_interval(int32_t const pos,
+                                           std::vector<seqan3::cigar> const & cigar,
+                                           int32_t const begin,
+                                           int32_t const end)
+{
+    AlignedSegment const segment{strand::forward, "", pos, 0, cigar};
+    int32_t const reference_end = segment.get_reference_end();
+    if (end <= pos || begin >= reference_end || begin >= end)
+        return {0, 0};
+
+    // Outside of the aligned part, the interval is extended into the soft clips.
+    int32_t query_begin = (begin < pos) ? std::max(0, segment.get_left_soft_clip() - (pos - begin)) : -1;
+    int32_t query_end = (end > reference_end) ? std::min(segment.get_query_length(),
+                                                         segment.get_query_length() - segment.get_right_soft_clip() +
+                                                         (end - reference_end))
+                                              : -1;
+
+    int32_t reference_position = pos;
+    int32_t query_position = segment.get_left_soft_clip();
+    for (auto [element_length, element_operation] : cigar)
+    {
+        int32_t const length = element_length;
+        switch (element_operation.to_char())
+        {
+            case 'M':
+            case 'X':
+            case '=':
+                if (query_begin < 0 && begin < reference_position + length)
+                    query_begin = query_position + (begin - reference_position);
+                if (query_end < 0 && end < reference_position + length)
+                    query_end = query_position + (end - reference_position);
+                reference_position += length;
+                query_position += length;
+                break;
+            case 'D':
+            case 'N':
+                // An interval border inside a deletion lies between the adjacent bases of the read.
+                if (query_begin < 0 && begin < reference_position + length)
+                    query_begin = query_position;
+                if (query_end < 0 && end < reference_position + length)
+                    query_end = query_position;
+                reference_position += length;
+                break;
+            case 'I':
+                query_position += length;
+                break;
+            default: // S, H and P do not change the position inside the aligned part.
+                break;
+        }
+    }
+    // The interval ends exactly at the end of the aligned part.
+    if (query_end < 0)
+        query_end = query_position;
+    return {query_begin, std::max(query_begin, query_end)};
+}
+
+std::vector<RefinementWindow> extract_refinement_windows(std::vector<Cluster> const & clusters,
+                                                         IndexedFasta const & reference,
+                                                         uint64_t const min_var_length,
+                                                         int32_t const max_var_length,
+                                                         int32_t const flank_length)
+{
+    std::vector<RefinementWindow> windows{};
+    for (size_t cluster_id = 0; cluster_id < clusters.size(); ++cluster_id)
+    {
+        Breakend const mate1 = clusters[cluster_id].get_average_mate1();
+        Breakend const mate2 = clusters[cluster_id].get_average_mate2();
+        std::optional<size_t> const ref_id = reference.get_id(mate1.seq_name);
+        if (mate1.seq_name != mate2.seq_name || mate1.orientation != strand::forward ||
+            mate2.orientation != strand::forward || !ref_id)
+            continue;
+
+        bool const is_insertion = (mate2.position - mate1.position == 1);
+        int32_t const expected_length = is_insertion ? clusters[cluster_id].get_average_inserted_sequence_size()
+                                                     : mate2.position - mate1.position - 1;
+        if (expected_length < static_cast<int64_t>(min_var_length) || expected_length > max_var_length)
+            continue;
+
+        int64_t const ref_length = reference.get_entry(*ref_id).length;
+        int32_t const start = std::max<int64_t>(0, mate1.position + 1 - flank_length);
+        int32_t const end = std::min<int64_t>(ref_length, mate2.position + flank_length);
+        if (start >= end)
+            continue;
+        windows.push_back(RefinementWindow{cluster_id,
+                                           mate1.seq_name,
+                                           start,
+                                           is_insertion,
+                                           expected_length,
+                                           reference.sequence(*ref_id, start, end)
+                                           | seqan3::views::char_to<seqan3::dna5>
+                                           | seqan3::views::to<seqan3::dna5_vector>});
+    }
+    return windows;
+}
+
+void collect_read_segments(std::filesystem::path const & alignment_file_path,
+                           std::vector<RefinementWindow> & windows,
+                           size_t const max_reads_per_window,
+                           uint64_t const min_segment_length,
+                           std::function<void(ReadSegment &&)> const & add_read_segment)
+{
+    // Open input alignment file
+    using my_fields = seqan3::fields<seqan3::field::flag,       // 2: FLAG
+                                     seqan3::field::ref_id,     // 3: RNAME
+                                     seqan3::field::ref_offset, // 4: POS
+                                     seqan3::field::mapq,       // 5: MAPQ
+                                     seqan3::field::cigar,      // 6: CIGAR
+                                     seqan3::field::seq>;       // 10:SEQ
+
+    seqan3::sam_file_input alignment_file{alignment_file_path, my_fields{}};
+
+    // Check that the file is sorted before proceeding.
+    if (alignment_file.header().sorting != "coordinate")
+    {
+        throw seqan3::format_error{"ERROR: Input file must be sorted by coordinate (e.g. samtools sort)"};
+    }
+    std::unordered_map<std::string, int32_t> alignment_ref_ids{};
+    for (std::string const & ref_name : alignment_file.header().ref_ids())
+    {
+        int32_t const ref_id = alignment_ref_ids.size();
+        alignment_ref_ids.emplace(ref_name, ref_id);
+    }
+
+    // Sort the windows like the alignments, so that they can be filled in a single pass.
+    windows.erase(std::remove_if(windows.begin(), windows.end(), [&] (RefinementWindow const & window)
+    {
+        return alignment_ref_ids.find(window.ref_name) == alignment_ref_ids.end();
+    }), windows.end());
+    std::sort(windows.begin(), windows.end(), [&] (RefinementWindow const & lhs, RefinementWindow const & rhs)
+    {
+        return std::pair{alignment_ref_ids[lhs.ref_name], lhs.start} <
+               std::pair{alignment_ref_ids[rhs.ref_name], rhs.start};
+    });
+    std::vector<int32_t> window_ref_ids(windows.size());
+    int32_t max_window_length = 0;
+    for (size_t window_id = 0; window_id < windows.size(); ++window_id)
+    {
+        window_ref_ids[window_id] = alignment_ref_ids[windows[window_id].ref_name];
+        max_window_length = std::max<int32_t>(max_window_length, windows[window_id].sequence.size());
+    }
+
+    std::vector<size_t> number_of_reads(windows.size(), 0);
+    size_t first_window = 0;
+
+    for (auto & record : alignment_file)
+    {
+        if (first_window == windows.size())
+            break;
+
+        seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
+        int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
+        int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
+        uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
+        auto const & cigar                  = record.cigar_sequence();                  // 6: CIGAR
+        auto const & seq                    = record.sequence();                        // 10:SEQ
+
+        if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagSupplementary(flag) || hasFlagDuplicate(flag) ||
+            mapq < 20 || ref_id < 0 || ref_pos < 0 || seq.empty())
+            continue;
+
+        // No later alignment overlaps the windows that end before this alignment.
+        while (first_window < windows.size() &&
+               (window_ref_ids[first_window] < ref_id ||
+                (window_ref_ids[first_window] == ref_id &&
+                 windows[first_window].start + max_window_length <= ref_pos)))
+        {
+            ++first_window;
+        }
+
+        int32_t const ref_end = ref_pos + get_reference_length(cigar);
+        for (size_t window_id = first_window;
+             window_id < windows.size() && window_ref_ids[window_id] == ref_id && windows[window_id].start < ref_end;
+             ++window_id)
+        {
+            RefinementWindow const & window = windows[window_id];
+            if (window.end() <= ref_pos || number_of_reads[window_id] >= max_reads_per_window)
+                continue;
+
+            auto const [query_begin, query_end] = query_interval(ref_pos, cigar, window.start, window.end());
+            if (query_end - query_begin < static_cast<int64_t>(min_segment_length) ||
+                query_end > static_cast<int32_t>(seq.size()))
+                continue;
+
+            add_read_segment(ReadSegment{window_id,
+                                         seqan3::dna5_vector(seq.begin() + query_begin, seq.begin() + query_end)});
+            ++number_of_reads[window_id];
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#include "modules/refinement/sViper_refinement_method.hpp"
+
+#include <algorithm>        // for std::sort, std::nth_element
+#include <tuple>            // for std::tie
+
+#include <seqan3/alignment/configuration/all.hpp>
+#include <seqan3/alignment/pairwise/align_pairwise.hpp>
+#include <seqan3/alignment/scoring/nucleotide_scoring_scheme.hpp>
+#include <seqan3/alphabet/gap/gap.hpp>
+#include <seqan3/core/debug_stream.hpp>
+#include <seqan3/std/algorithm>    // for std::ranges::move
+#include <seqan3/std/iterator>     // for std::cpp20::back_inserter
+#include <seqan3/std/ranges>       // for std::views::transform
+
+std::vector<RealignedBreakpoint> realign_read_segments(std::vector<RefinementWindow> const & windows,
+                                                       std::vector<ReadSegment> & read_segments,
+                                                       uint16_t const threads)
+{
+    std::vector<RealignedBreakpoint> breakpoints{};
+    if (read_segments.empty())
+        return breakpoints;
+
+    // The alignments in the lanes of a SIMD register are computed together, so they should be of similar size.
+    std::sort(read_segments.begin(), read_segments.end(), [&windows] (ReadSegment const & lhs,
+                                                                      ReadSegment const & rhs)
+    {
+        return std::pair{windows[lhs.window_id].sequence.size(), lhs.sequence.size()} <
+               std::pair{windows[rhs.window_id].sequence.size(), rhs.sequence.size()};
+    });
+
+    auto sequence_pairs = read_segments | std::views::transform([&windows] (ReadSegment const & read_segment)
+    {
+        return std::tie(windows[read_segment.window_id].sequence, read_segment.sequence);
+    });
+
+    // The read segment is aligned globally, the reference window may be longer than the read on both sides.
+    auto const config = seqan3::align_cfg::method_global{seqan3::align_cfg::free_end_gaps_sequence1_leading{true},
+                                                         seqan3::align_cfg::free_end_gaps_sequence2_leading{false},
+                                                         seqan3::align_cfg::free_end_gaps_sequence1_trailing{true},
+                                                         seqan3::align_cfg::free_end_gaps_sequence2_trailing{false}} |
+                        seqan3::align_cfg::scoring_scheme{seqan3::nucleotide_scoring_scheme{
+                            seqan3::match_score{2}, seqan3::mismatch_score{-3}}} |
+                        seqan3::align_cfg::gap_cost_affine{seqan3::align_cfg::open_score{-5},
+                                                           seqan3::align_cfg::extension_score{-1}} |
+                        seqan3::align_cfg::output_sequence1_id{} |
+                        seqan3::align_cfg::output_begin_position{} |
+                        seqan3::align_cfg::output_alignment{} |
+                        seqan3::align_cfg::vectorised{} |
+                        seqan3::align_cfg::parallel{threads};
+
+    for (auto const & result : seqan3::align_pairwise(sequence_pairs, config))
+    {
+        // With several threads, the results may arrive in any order.
+        RefinementWindow const & window = windows[read_segments[result.sequence1_id()].window_id];
+        auto const & [reference_row, read_row] = result.alignment();
+
+        // Find the longest gap in the read (deletion) or in the reference (insertion).
+        int32_t reference_position = window.start + result.sequence1_begin_position();
+        int32_t gap_position = 0;
+        int32_t gap_length = 0;
+        RealignedBreakpoint longest_gap{read_segments[result.sequence1_id()].window_id, 0, 0};
+        auto read_column = read_row.begin();
+        for (auto reference_column = reference_row.begin();
+             reference_column != reference_row.end();
+             ++reference_column, ++read_column)
+        {
+            bool const is_reference_gap = (*reference_column == seqan3::gap{});
+            if (window.is_insertion ? is_reference_gap : (*read_column == seqan3::gap{}))
+            {
+                if (gap_length == 0)
+                    gap_position = reference_position;
+                if (++gap_length > longest_gap.length)
+                {
+                    longest_gap.position = gap_position;
+                    longest_gap.length = gap_length;
+                }
+            }
+            else
+            {
+                gap_length = 0;
+            }
+            if (!is_reference_gap)
+                ++reference_position;
+        }
+
+        if (longest_gap.length * 2 >= window.expected_length && longest_gap.length <= window.expected_length * 2)
+            breakpoints.push_back(longest_gap);
+    }
+    return breakpoints;
+}
+
+//!\brief Returns the median of the values, the upper one for an even number of values.
+static int32_t median(std::vector<int32_t> & values)
+{
+    auto const middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+void sViper_refinement_method(std::vector<Cluster> & clusters,
+                              std::filesystem::path const & alignment_file_path,
+                              IndexedFasta const & reference,
+                              uint16_t const threads,
+                              uint64_t const min_var_length,
+                              int32_t const max_var_length,
+                              int32_t const flank_length,
+                              size_t const max_reads_per_cluster,
+                              size_t const min_support,
+                              size_t const batch_size)
+{
+    std::vector<RefinementWindow> windows = extract_refinement_windows(clusters,
+                                                                       reference,
+                                                                       min_var_length,
+                                                                       max_var_length,
+                                                                       flank_length);
+
+    // The read segments are realigned as soon as a batch is full.
+    std::vector<ReadSegment> read_segments{};
+    std::vector<RealignedBreakpoint> breakpoints{};
+    collect_read_segments(alignment_file_path,
+                          windows,
+                          max_reads_per_cluster,
+                          min_var_length,
+                          [&] (ReadSegment && read_segment)
+    {
+        read_segments.push_back(std::move(read_segment));
+        if (read_segments.size() >= batch_size)
+        {
+            std::ranges::move(realign_read_segments(windows, read_segments, threads),
+                              std::cpp20::back_inserter(breakpoints));
+            read_segments.clear();
+        }
+    });
+    std::ranges::move(realign_read_segments(windows, read_segments, threads), std::cpp20::back_inserter(breakpoints));
+
+    // The refined breakends are the median position and length of the variants in the reads of a cluster.
+    std::sort(breakpoints.begin(), breakpoints.end(), [] (RealignedBreakpoint const & lhs,
+                                                          RealignedBreakpoint const & rhs)
+    {
+        return lhs.window_id < rhs.window_id;
+    });
+    size_t number_of_refined_clusters = 0;
+    std::vector<int32_t> positions{};
+    std::vector<int32_t> lengths{};
+    for (auto group_begin = breakpoints.begin(); group_begin != breakpoints.end();)
+    {
+        auto const group_end = std::find_if(group_begin, breakpoints.end(), [&] (RealignedBreakpoint const & b)
+        {
+            return b.window_id != group_begin->window_id;
+        });
+        RefinementWindow const & window = windows[group_begin->window_id];
+        if (static_cast<size_t>(group_end - group_begin) >= min_support)
+        {
+            positions.clear();
+            lengths.clear();
+            for (auto breakpoint = group_begin; breakpoint != group_end; ++breakpoint)
+            {
+                positions.push_back(breakpoint->position);
+                lengths.push_back(breakpoint->length);
+            }
+            int32_t const position = median(positions);
+            // A deletion connects the last base before and the first base after the deleted sequence, an insertion
+            // the last base before and the first base after the inserted sequence.
+            int32_t const mate2_position = window.is_insertion ? position : position + median(lengths);
+            clusters[window.cluster_id].set_refined_mates(Breakend{window.ref_name, position - 1, strand::forward},
+                                                          Breakend{window.ref_name, mate2_position, strand::forward});
+            ++number_of_refined_clusters;
+        }
+        group_begin = group_end;
+    }
+
+    seqan3::debug_stream << "Refined " << number_of_refined_clusters << " of " << windows.size()
+                         << " deletion and insertion clusters by realigning the reads.\n";
+}
@@ -0,0 +1,280 @@
+#include "modules/refinement/sVirl_refinement_method.hpp"
+
+#include <algorithm>    // for std::stable_sort
+#include <atomic>       // for std::atomic
+#include <limits>       // for std::numeric_limits
+#include <thread>       // for std::thread
+
+#include <seqan3/alphabet/concept.hpp>
+#include <seqan3/core/debug_stream.hpp>
+
+//!\brief Marks an empty entry of a k-mer hash table.
+static constexpr uint64_t empty_kmer = std::numeric_limits<uint64_t>::max();
+
+//!\brief Returns the smallest power of two that is at least `size`, the size of a k-mer hash table.
+static size_t round_up_to_power_of_two(size_t const size)
+{
+    size_t power = 1;
+    while (power < size)
+        power <<= 1;
+    return power;
+}
+
+//!\brief Returns the 2-bit code of a base (A: 0, C: 1, G: 2, T: 3) or 4 for N.
+static uint8_t base_code(seqan3::dna5 const base)
+{
+    uint8_t const rank = seqan3::to_rank(base); // A: 0, C: 1, G: 2, N: 3, T: 4
+    return (rank == 3) ? 4 : ((rank == 4) ? 3 : rank);
+}
+
+//!\brief Returns the base of a 2-bit code.
+static seqan3::dna5 code_base(uint8_t const code)
+{
+    return seqan3::dna5{}.assign_rank((code == 3) ? 4 : code);
+}
+
+/*! \brief Calls the callback with every k-mer of the sequence that contains no N, as 2-bit encoded integer, and with
+ *         its start position.
+ */
+template <typename sequence_t, typename callback_t>
+static void for_each_kmer(sequence_t const & sequence, uint8_t const k, uint64_t const kmer_mask, callback_t && callback)
+{
+    uint64_t kmer = 0;
+    size_t valid_bases = 0;
+    for (size_t position = 0; position < sequence.size(); ++position)
+    {
+        uint8_t const code = base_code(sequence[position]);
+        if (code > 3)
+        {
+            valid_bases = 0;
+            continue;
+        }
+        kmer = ((kmer << 2) | code) & kmer_mask;
+        if (++valid_bases >= k)
+            callback(kmer, position + 1 - k);
+    }
+}
+
+LocalAssembler::LocalAssembler(uint8_t const k, uint32_t const min_kmer_count) :
+    k{k},
+    min_kmer_count{min_kmer_count},
+    kmer_mask{(uint64_t{1} << (2 * k)) - 1}
+{}
+
+LocalAssembler::KmerEntry & LocalAssembler::find_slot(KmerTable & table, uint64_t const kmer)
+{
+    // The table size is a power of two, the upper bits of the product are well mixed.
+    size_t const slot_mask = table.size() - 1;
+    size_t slot = ((kmer * 0x9E3779B97F4A7C15ull) >> 32) & slot_mask;
+    while (table[slot].kmer != empty_kmer && table[slot].kmer != kmer)
+        slot = (slot + 1) & slot_mask;
+    return table[slot];
+}
+
+std::optional<AssembledVariant> LocalAssembler::assemble(RefinementWindow const & window,
+                                                         std::span<ReadSegment const> const read_segments)
+{
+    seqan3::dna5_vector const & reference_sequence = window.sequence;
+    if (reference_sequence.size() < k)
+        return std::nullopt;
+    // All tables and the contig of the previous window are freed at once.
+    arena.reset();
+
+    // Count the k-mers of the reads. The tables are at most half full.
+    size_t number_of_kmers = 0;
+    for (ReadSegment const & read_segment : read_segments)
+        number_of_kmers += (read_segment.sequence.size() >= k) ? read_segment.sequence.size() - k + 1 : 0;
+    KmerTable read_kmers(round_up_to_power_of_two(2 * number_of_kmers + 1),
+                         KmerEntry{empty_kmer, 0, 0},
+                         ArenaAllocator<KmerEntry>{arena});
+    for (ReadSegment const & read_segment : read_segments)
+    {
+        for_each_kmer(read_segment.sequence, k, kmer_mask, [&] (uint64_t const kmer, size_t)
+        {
+            KmerEntry & entry = find_slot(read_kmers, kmer);
+            entry.kmer = kmer;
+            ++entry.count;
+        });
+    }
+
+    // Index the k-mers of the reference with their position. The contig starts at the first one that is supported by
+    // the reads.
+    KmerTable reference_kmers(round_up_to_power_of_two(2 * reference_sequence.size() + 1),
+                              KmerEntry{empty_kmer, 0, 0},
+                              ArenaAllocator<KmerEntry>{arena});
+    size_t seed_position = reference_sequence.size();
+    uint64_t seed_kmer = 0;
+    for_each_kmer(reference_sequence, k, kmer_mask, [&] (uint64_t const kmer, size_t const position)
+    {
+        KmerEntry & entry = find_slot(reference_kmers, kmer);
+        if (entry.kmer == empty_kmer)
+        {
+            entry.kmer = kmer;
+            entry.value = position;
+        }
+        ++entry.count;
+        if (seed_position == reference_sequence.size() && find_slot(read_kmers, kmer).count >= min_kmer_count)
+        {
+            seed_position = position;
+            seed_kmer = kmer;
+        }
+    });
+    if (seed_position == reference_sequence.size())
+        return std::nullopt;
+
+    // Walk the de Bruijn graph along the most frequent successors. The value of a read k-mer marks it as visited.
+    std::vector<seqan3::dna5, ArenaAllocator<seqan3::dna5>> contig(reference_sequence.begin() + seed_position,
+                                                                   reference_sequence.begin() + seed_position + k,
+                                                                   ArenaAllocator<seqan3::dna5>{arena});
+    find_slot(read_kmers, seed_kmer).value = 1;
+    size_t const max_contig_length = reference_sequence.size() + (window.is_insertion ? 2 * window.expected_length : 0);
+    uint64_t kmer = seed_kmer;
+    while (contig.size() < max_contig_length)
+    {
+        KmerEntry * successor = nullptr;
+        uint8_t successor_code = 0;
+        for (uint8_t code = 0; code < 4; ++code)
+        {
+            KmerEntry & entry = find_slot(read_kmers, ((kmer << 2) | code) & kmer_mask);
+            if (entry.kmer != empty_kmer && entry.count >= min_kmer_count &&
+                (successor == nullptr || entry.count > successor->count))
+            {
+                successor = &entry;
+                successor_code = code;
+            }
+        }
+        if (successor == nullptr || successor->value != 0)
+            break;
+        successor->value = 1;
+        kmer = successor->kmer;
+        contig.push_back(code_base(successor_code));
+    }
+
+    // The left breakpoint is the end of the common prefix of the contig and the reference.
+    size_t left_contig = 0;
+    while (left_contig < contig.size() && seed_position + left_contig < reference_sequence.size() &&
+           contig[left_contig] == reference_sequence[seed_position + left_contig])
+    {
+        ++left_contig;
+    }
+    if (left_contig == contig.size())
+        return std::nullopt;
+    size_t const left_reference = seed_position + left_contig;
+
+    // The right breakpoint is anchored by the last k-mer of the contig that is unique in the reference.
+    std::vector<uint64_t, ArenaAllocator<uint64_t>> contig_kmers{ArenaAllocator<uint64_t>{arena}};
+    contig_kmers.reserve(contig.size());
+    for_each_kmer(contig, k, kmer_mask, [&] (uint64_t const kmer, size_t)
+    {
+        contig_kmers.push_back(kmer);
+    });
+    size_t right_contig = contig.size();
+    size_t right_reference = 0;
+    for (size_t position = contig_kmers.size(); position-- > left_contig;)
+    {
+        KmerEntry const & entry = find_slot(reference_kmers, contig_kmers[position]);
+        if (entry.kmer != empty_kmer && entry.count == 1 && entry.value >= left_reference)
+        {
+            right_contig = position;
+            right_reference = entry.value;
+            break;
+        }
+    }
+    if (right_contig == contig.size())
+        return std::nullopt;
+    while (right_contig > left_contig && right_reference > left_reference &&
+           contig[right_contig - 1] == reference_sequence[right_reference - 1])
+    {
+        --right_contig;
+        --right_reference;
+    }
+    if (right_contig == left_contig && right_reference == left_reference)
+        return std::nullopt;
+
+    return AssembledVariant{window.start + static_cast<int32_t>(left_reference),
+                            static_cast<int32_t>(right_reference - left_reference),
+                            seqan3::dna5_vector(contig.begin() + left_contig, contig.begin() + right_contig)};
+}
+
+void sVirl_refinement_method(std::vector<Cluster> & clusters,
+                             std::filesystem::path const & alignment_file_path,
+                             IndexedFasta const & reference,
+                             uint16_t const threads,
+                             uint64_t const min_var_length,
+                             int32_t const max_var_length,
+                             int32_t const flank_length,
+                             size_t const max_reads_per_cluster)
+{
+    std::vector<RefinementWindow> windows = extract_refinement_windows(clusters,
+                                                                       reference,
+                                                                       min_var_length,
+                                                                       max_var_length,
+                                                                       flank_length);
+    std::vector<ReadSegment> read_segments{};
+    collect_read_segments(alignment_file_path,
+                          windows,
+                          max_reads_per_cluster,
+                          min_var_length,
+                          [&] (ReadSegment && read_segment)
+    {
+        read_segments.push_back(std::move(read_segment));
+    });
+
+    // Group the read segments by window.
+    std::stable_sort(read_segments.begin(), read_segments.end(), [] (ReadSegment const & lhs, ReadSegment const & rhs)
+    {
+        return lhs.window_id < rhs.window_id;
+    });
+    std::vector<size_t> window_begins(windows.size() + 1, 0);
+    for (ReadSegment const & read_segment : read_segments)
+        ++window_begins[read_segment.window_id + 1];
+    for (size_t window_id = 0; window_id < windows.size(); ++window_id)
+        window_begins[window_id + 1] += window_begins[window_id];
+
+    // Every thread takes the next window and writes only the result of it.
+    std::vector<std::optional<AssembledVariant>> variants(windows.size());
+    std::atomic<size_t> next_window{0};
+    auto assemble_windows = [&] ()
+    {
+        LocalAssembler assembler{};
+        for (size_t window_id = next_window++; window_id < windows.size(); window_id = next_window++)
+        {
+            variants[window_id] = assembler.assemble(windows[window_id],
+                                                     std::span<ReadSegment const>{read_segments}.subspan(
+                                                         window_begins[window_id],
+                                                         window_begins[window_id + 1] - window_begins[window_id]));
+        }
+    };
+    std::vector<std::thread> workers{};
+    for (uint16_t thread = 1; thread < threads; ++thread)
+        workers.emplace_back(assemble_windows);
+    assemble_windows();
+    for (std::thread & worker : workers)
+        worker.join();
+
+    size_t number_of_refined_clusters = 0;
+    for (size_t window_id = 0; window_id < windows.size(); ++window_id)
+    {
+        if (!variants[window_id])
+            continue;
+        RefinementWindow const & window = windows[window_id];
+        AssembledVariant & variant = *variants[window_id];
+        int32_t const length = window.is_insertion ? static_cast<int32_t>(variant.inserted_sequence.size())
+                                                   : variant.deleted_length;
+        bool const has_cluster_type = window.is_insertion ? (variant.deleted_length == 0)
+                                                          : (variant.deleted_length > 0);
+        if (!has_cluster_type || length * 2 < window.expected_length || length > window.expected_length * 2)
+            continue;
+
+        // A deletion connects the last base before and the first base after the deleted sequence, an insertion the
+        // last base before and the first base after the inserted sequence.
+        Cluster & cluster = clusters[window.cluster_id];
+        cluster.set_refined_mates(Breakend{window.ref_name, variant.position - 1, strand::forward},
+                                  Breakend{window.ref_name, variant.position + variant.deleted_length, strand::forward});
+        cluster.set_refined_inserted_sequence(std::move(variant.inserted_sequence));
+        ++number_of_refined_clusters;
+    }
+
+    seqan3::debug_stream << "Refined " << number_of_refined_clusters << " of " << windows.size()
+                         << " deletion and insertion clusters by local assembly.\n";
+}
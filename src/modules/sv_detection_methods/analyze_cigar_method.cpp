@@ -41,7 +41,6 @@ void analyze_cigar(std::string const & read_name,
                                       Breakend{chromosome, pos_ref, strand::forward},
                                       inserted_bases,
                                       read_name};
-                seqan3::debug_stream << "INS: " << new_junction << "\n";
                 junctions.push_back(std::move(new_junction));
             }
             pos_read += length;
@@ -55,7 +54,6 @@ void analyze_cigar(std::string const & read_name,
                                       Breakend{chromosome, pos_ref + length, strand::forward},
                                       ""_dna5,
                                       read_name};
-                seqan3::debug_stream << "DEL: " << new_junction << "\n";
                 junctions.push_back(std::move(new_junction));
             }
             pos_ref += length;
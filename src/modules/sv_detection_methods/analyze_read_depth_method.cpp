@@ -0,0 +1,121 @@
+#include "modules/sv_detection_methods/analyze_read_depth_method.hpp"
+
+#include <algorithm>    // for std::min
+#include <numeric>      // for std::partial_sum
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+using seqan3::operator""_dna5;
+
+void ReadDepthDetector::flush_bins(size_t const number_of_bins)
+{
+    size_t const number_of_window_bins = std::min(number_of_bins, coverage_differences.size() - window_offset);
+    size_t const first_bin = bin_depths.size();
+    bin_depths.resize(first_bin + number_of_bins);
+
+    if (number_of_window_bins > 0)
+    {
+        // The prefix sum is the only sequential step. The depths are computed in a separate loop, which the compiler
+        // can vectorize.
+        auto const window_begin = coverage_differences.begin() + window_offset;
+        *window_begin += covering_alignments;
+        std::partial_sum(window_begin, window_begin + number_of_window_bins, window_begin);
+        covering_alignments = window_begin[number_of_window_bins - 1];
+
+        uint32_t * depths = bin_depths.data() + first_bin;
+        int32_t const * coverage = coverage_differences.data() + window_offset;
+        int32_t const * corrections = partial_bin_corrections.data() + window_offset;
+        for (size_t i = 0; i < number_of_window_bins; ++i)
+            depths[i] = bin_size * coverage[i] + corrections[i];
+
+        // The resolved bins are only erased once they outnumber the pending ones, so that erasing from the front of
+        // the arrays costs constant time per bin.
+        window_offset += number_of_window_bins;
+        if (window_offset >= coverage_differences.size() - window_offset)
+        {
+            coverage_differences.erase(coverage_differences.begin(), coverage_differences.begin() + window_offset);
+            partial_bin_corrections.erase(partial_bin_corrections.begin(),
+                                          partial_bin_corrections.begin() + window_offset);
+            window_offset = 0;
+        }
+    }
+    // Bins after the window are only covered by the alignments that cover the whole window.
+    std::fill(bin_depths.begin() + first_bin + number_of_window_bins,
+              bin_depths.end(),
+              bin_size * covering_alignments);
+
+    for (size_t bin = first_bin; bin < bin_depths.size(); ++bin)
+        depth_distribution.add(bin_depths[bin]);
+    window_start += number_of_bins;
+}
+
+void ReadDepthDetector::finish_chromosome(std::vector<Junction> & junctions)
+{
+    flush_bins(coverage_differences.size() - window_offset);
+
+    double const median_depth = depth_distribution.quantile(0.5);
+    if (bin_depths.empty() || median_depth < min_median_depth * bin_size)
+        return;
+
+    uint32_t const loss_threshold = loss_ratio * median_depth;
+
+    size_t segment_start = 0;
+    for (size_t bin = 1; bin <= bin_depths.size(); ++bin)
+    {
+        bool const is_loss = bin_depths[segment_start] < loss_threshold;
+        if (bin < bin_depths.size() && (bin_depths[bin] < loss_threshold) == is_loss)
+            continue;
+
+        // Only segments with a normal depth on both sides are reported.
+        if (is_loss && segment_start > 0 && bin < bin_depths.size() && bin - segment_start >= min_segment_bins)
+        {
+            // Like the CIGAR method, a deletion connects the last base before and the first base after the segment.
+            int32_t const start_position = segment_start * bin_size;
+            int32_t const end_position = bin * bin_size;
+            junctions.push_back(Junction{Breakend{ref_name, start_position - 1, strand::forward},
+                                         Breakend{ref_name, end_position, strand::forward},
+                                         ""_dna5,
+                                         "read_depth"});
+        }
+        segment_start = bin;
+    }
+}
+
+void ReadDepthDetector::add_alignment(int32_t const ref_id,
+                                      std::string const & ref_name,
+                                      int32_t const start,
+                                      int32_t const end,
+                                      std::vector<Junction> & junctions)
+{
+    if (ref_id != this->ref_id)
+    {
+        finish_chromosome(junctions);
+        this->ref_id = ref_id;
+        this->ref_name = ref_name;
+        window_start = 0;
+        covering_alignments = 0;
+        bin_depths.clear();
+        depth_distribution = QuantileSketch{};
+    }
+    if (end <= start)
+        return;
+
+    size_t const start_bin = start / bin_size;
+    size_t const end_bin = end / bin_size;
+
+    // No later alignment changes the bins before the start of this one.
+    if (start_bin >= window_start + flush_chunk_size)
+        flush_bins(start_bin - window_start);
+
+    size_t const start_index = start_bin - window_start + window_offset;
+    size_t const end_index = end_bin - window_start + window_offset;
+    if (end_index >= coverage_differences.size())
+    {
+        coverage_differences.resize(end_index + 1, 0);
+        partial_bin_corrections.resize(end_index + 1, 0);
+    }
+    coverage_differences[start_index] += 1;
+    partial_bin_corrections[start_index] -= start % bin_size;
+    coverage_differences[end_index] -= 1;
+    partial_bin_corrections[end_index] += end % bin_size;
+}
@@ -1,6 +1,125 @@
-#include <seqan3/core/debug_stream.hpp>
+#include "modules/sv_detection_methods/analyze_read_pair_method.hpp"
 
-void analyze_read_pair()
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+using seqan3::operator""_dna5;
+
+void ReadPairDetector::evict_passed_mates(int32_t const ref_id, int32_t const pos)
+{
+    while (!eviction_queue.empty() &&
+           std::tie(eviction_queue.top().mate_ref_id, eviction_queue.top().mate_pos) < std::tie(ref_id, pos))
+    {
+        // Entries of completed pairs are still in the queue, but no longer in the cache.
+        number_of_evicted_reads += pending_mates.erase(eviction_queue.top().read_name);
+        eviction_queue.pop();
+    }
+}
+
+void ReadPairDetector::add_insert_size(ReadGroupStatistics & statistics, uint64_t const template_length)
 {
-    seqan3::debug_stream << "The read pair method is not yet implemented.\n";
+    statistics.insert_sizes.add(template_length);
+    uint64_t const number_of_pairs = statistics.insert_sizes.size();
+    // The quantiles are recomputed at the end of the warm-up and then after every 1024 pairs.
+    if (number_of_pairs < warm_up_pairs || (number_of_pairs != warm_up_pairs && number_of_pairs % 1024 != 0))
+        return;
+
+    uint64_t const first_quartile = statistics.insert_sizes.quantile(0.25);
+    uint64_t const third_quartile = statistics.insert_sizes.quantile(0.75);
+    statistics.max_insert_size = third_quartile + 3 * (third_quartile - first_quartile);
+}
+
+uint64_t ReadPairDetector::get_max_insert_size(std::string const & read_group) const
+{
+    auto const statistics = read_groups.find(read_group);
+    return statistics == read_groups.end() ? default_max_insert_size : statistics->second.max_insert_size;
+}
+
+QuantileSketch const * ReadPairDetector::get_insert_sizes(std::string const & read_group) const
+{
+    auto const statistics = read_groups.find(read_group);
+    return statistics == read_groups.end() ? nullptr : &statistics->second.insert_sizes;
+}
+
+void ReadPairDetector::add_alignment(std::string const & read_name,
+                                     std::string const & read_group,
+                                     AlignedSegment const & segment,
+                                     int32_t const ref_id,
+                                     int32_t const mate_ref_id,
+                                     int32_t const mate_pos,
+                                     strand const mate_orientation,
+                                     int32_t const template_length,
+                                     bool const is_proper_pair,
+                                     std::vector<Junction> & junctions,
+                                     double const sampling_rate)
+{
+    int32_t const pos = segment.get_reference_start();
+    evict_passed_mates(ref_id, pos);
+
+    auto statistics = read_groups.find(read_group);
+    if (statistics == read_groups.end())
+    {
+        statistics = read_groups.emplace(read_group,
+                                         ReadGroupStatistics{QuantileSketch{}, default_max_insert_size}).first;
+    }
+    // Learn the insert sizes from the leftmost read of proper forward-reverse pairs. The template lengths of pairs
+    // around structural variants would widen the distribution and hide them.
+    if (is_proper_pair && template_length > 0 && mate_ref_id == ref_id &&
+        segment.orientation == strand::forward && mate_orientation == strand::reverse)
+    {
+        add_insert_size(statistics->second, template_length);
+    }
+    uint64_t const max_insert_size = statistics->second.max_insert_size;
+
+    auto pending_mate = pending_mates.find(read_name);
+    if (pending_mate != pending_mates.end())
+    {
+        // The cached read is the leftmost one. The mate is sequenced from the other strand, so the junction connects
+        // the cached read with the reverse complemented mate, like two segments of a split read.
+        AlignedSegment const & first = pending_mate->second.segment;
+        AlignedSegment const & second = segment;
+        strand const second_orientation = (second.orientation == strand::forward) ? strand::reverse : strand::forward;
+
+        bool const is_concordant = pending_mate->second.ref_id == ref_id &&
+                                   first.orientation == strand::forward &&
+                                   second.orientation == strand::reverse &&
+                                   second.get_reference_end() - first.get_reference_start() <=
+                                   static_cast<int64_t>(max_insert_size);
+        if (!is_concordant)
+        {
+            Breakend mate1{first.ref_name,
+                           first.orientation == strand::forward ? first.get_reference_end()
+                                                                : first.get_reference_start(),
+                           first.orientation};
+            Breakend mate2{second.ref_name,
+                           second_orientation == strand::forward ? second.get_reference_start()
+                                                                 : second.get_reference_end(),
+                           second_orientation};
+            Junction new_junction{mate1, mate2, ""_dna5, read_name};
+            new_junction.set_sampling_rate(pending_mate->second.sampling_rate);
+            junctions.push_back(std::move(new_junction));
+        }
+        pending_mates.erase(pending_mate);
+        return;
+    }
+
+    // The mate was already passed, but not cached: the pair is concordant or the mate was filtered.
+    if (std::tie(mate_ref_id, mate_pos) < std::tie(ref_id, pos))
+        return;
+
+    // Skip pairs that look concordant from this read, assuming that the mate has the same length.
+    bool const looks_concordant = mate_ref_id == ref_id &&
+                                  segment.orientation == strand::forward &&
+                                  mate_orientation == strand::reverse &&
+                                  static_cast<int64_t>(mate_pos) + segment.get_reference_end() - 2 * pos <=
+                                  static_cast<int64_t>(max_insert_size);
+    if (looks_concordant)
+        return;
+
+    if (pending_mates.size() >= max_cache_size)
+    {
+        ++number_of_dropped_reads;
+        return;
+    }
+    pending_mates.emplace(read_name, PendingMate{segment, ref_id, sampling_rate});
+    eviction_queue.push(EvictionEntry{mate_ref_id, mate_pos, read_name});
 }
@@ -1,4 +1,9 @@
+#include <array>
+#include <string_view>
+
 #include <seqan3/core/debug_stream.hpp>
+#include <seqan3/std/charconv>
+#include <seqan3/std/span>
 
 #include "variant_detection/bam_functions.hpp"  // for hasFlag* functions
 #include "structures/aligned_segment.hpp"       // for struct AlignedSegment
@@ -16,53 +21,133 @@ void split_string(std::string const & str, Container & cont, char const delim =
     }
 }
 
-void retrieve_aligned_segments(std::string const & sa_string, std::vector<AlignedSegment> & aligned_segments)
+template void split_string<std::vector<std::string>>(std::string const & str,
+                                                     std::vector<std::string> & cont,
+                                                     char const delim);
+
+/*! \brief Parses a CIGAR string and computes the reference end, query length and soft clips of an aligned segment
+ *         from it, without storing the CIGAR elements.
+ *
+ * \param[in]       cigar_string    - CIGAR string, e.g. "6S10M34S"
+ * \param[in, out]  segment         - aligned segment, its start position has to be set
+ *
+ * \returns `false` if the CIGAR string is corrupted.
+ */
+bool parse_cigar_string(std::string_view const cigar_string, AlignedSegment & segment)
 {
-    std::vector<std::string> sa_tags{};
-    split_string(sa_string, sa_tags, ';');
-    for (std::string sa_tag : sa_tags)
+    static constexpr std::string_view cigar_operations{"MIDNSHP=X"};
+    segment.clear_cigar();
+    char const * current = cigar_string.data();
+    char const * const end = current + cigar_string.size();
+    while (current != end)
     {
-        std::vector<std::string> fields {};
-        split_string(sa_tag, fields, ',');
-        if (fields.size() == 6)
+        uint32_t count{};
+        auto const [operation, error_code] = std::from_chars(current, end, count);
+        if (error_code != std::errc{} || operation == end ||
+            cigar_operations.find(*operation) == std::string_view::npos)
+            return false;
+        segment.add_cigar_element(count, *operation);
+        current = operation + 1;
+    }
+    return true;
+}
+
+/*! \brief Parses a complete number with std::from_chars.
+ *
+ * \param[in]   field   - the number as string
+ * \param[out]  number  - the parsed number
+ *
+ * \returns `false` if the field is not a number.
+ */
+bool parse_number(std::string_view const field, int32_t & number)
+{
+    auto const [last, error_code] = std::from_chars(field.data(), field.data() + field.size(), number);
+    return error_code == std::errc{} && last == field.data() + field.size();
+}
+
+/*! \brief Parses the SA tag into `aligned_segments`, starting at index `number_of_segments`. Existing elements are
+ *         overwritten, so that the storage of their members is reused.
+ *
+ * \param[in]       sa_string           - "SA" tag string
+ * \param[in, out]  aligned_segments    - vector of [aligned_segments](\ref AlignedSegment)
+ * \param[in]       number_of_segments  - number of valid elements at the beginning of `aligned_segments`
+ *
+ * \returns The number of valid elements at the beginning of `aligned_segments`.
+ */
+size_t parse_sa_tag(std::string_view const sa_string,
+                    std::vector<AlignedSegment> & aligned_segments,
+                    size_t number_of_segments)
+{
+    // Returns the next field up to the delimiter and advances `rest` behind it.
+    auto next_field = [] (std::string_view & rest, char const delim)
+    {
+        size_t const delim_pos = rest.find(delim);
+        std::string_view const field = rest.substr(0, delim_pos);
+        rest.remove_prefix(delim_pos == std::string_view::npos ? rest.size() : delim_pos + 1);
+        return field;
+    };
+
+    std::string_view rest_of_tag{sa_string};
+    while (!rest_of_tag.empty())
+    {
+        std::string_view const sa_tag = next_field(rest_of_tag, ';');
+
+        // Like std::getline, an empty field after the last delimiter is not counted.
+        std::array<std::string_view, 6> fields{};
+        size_t number_of_fields = 0;
+        for (std::string_view rest_of_segment{sa_tag}; !rest_of_segment.empty(); ++number_of_fields)
         {
-            std::string ref_name = fields[0];
-            int32_t pos = std::stoi(fields[1]);
-            strand orientation;
-            if (fields[2] == "+")
-            {
-                orientation = strand::forward;
-            }
-            else if (fields[2] == "-")
-            {
-                orientation = strand::reverse;
-            }
-            else
-            {
-                continue;
-            }
-            std::string cigar_field = fields[3];
-            std::tuple<std::vector<seqan3::cigar>, int32_t, int32_t> parsed_cigar = parse_cigar(cigar_field);
-            std::vector<seqan3::cigar> cigar_vector = std::get<0>(parsed_cigar);
-            int32_t mapq = std::stoi(fields[4]);
-            aligned_segments.push_back(AlignedSegment{orientation, ref_name, pos, mapq, cigar_vector});
+            std::string_view const field = next_field(rest_of_segment, ',');
+            if (number_of_fields < fields.size())
+                fields[number_of_fields] = field;
         }
+        if (number_of_fields != fields.size())
+        {
+            seqan3::debug_stream << "Your SA tag has a wrong format (wrong amount of parameters): "
+                                 << std::string{sa_tag} << '\n';
+            continue;
+        }
+
+        strand orientation;
+        if (fields[2] == "+")
+            orientation = strand::forward;
+        else if (fields[2] == "-")
+            orientation = strand::reverse;
         else
+            continue;
+
+        if (number_of_segments == aligned_segments.size())
+            aligned_segments.emplace_back();
+        AlignedSegment & segment = aligned_segments[number_of_segments];
+        if (!parse_number(fields[1], segment.pos) ||
+            !parse_number(fields[4], segment.mapq) ||
+            !parse_cigar_string(fields[3], segment))
         {
-            seqan3::debug_stream << "Your SA tag has a wrong format (wrong amount of parameters): " << sa_tag << '\n';
+            seqan3::debug_stream << "Your SA tag has a wrong format (corrupted number or CIGAR): "
+                                 << std::string{sa_tag} << '\n';
+            continue;
         }
+        segment.orientation = orientation;
+        segment.ref_name.assign(fields[0]);
+        ++number_of_segments;
     }
+    return number_of_segments;
 }
 
-void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segments,
+void retrieve_aligned_segments(std::string_view const sa_string, std::vector<AlignedSegment> & aligned_segments)
+{
+    aligned_segments.resize(parse_sa_tag(sa_string, aligned_segments, aligned_segments.size()));
+}
+
+void analyze_aligned_segments(std::span<AlignedSegment const> const aligned_segments,
                               std::vector<Junction> & junctions,
                               seqan3::dna5_vector const & query_sequence,
                               std::string const & read_name)
 {
     for(size_t i = 1; i<aligned_segments.size(); i++)
     {
-        AlignedSegment current = aligned_segments[i-1];
-        AlignedSegment next = aligned_segments[i];
+        AlignedSegment const & current = aligned_segments[i-1];
+        AlignedSegment const & next = aligned_segments[i];
         int32_t distance_on_read = next.get_query_start() - current.get_query_end();
         // Check that there is neither an overlap nor a larger gap on the read
         // TODO(eldarion): add command-line parameters for changing these currently hard-coded cutoffs
@@ -78,7 +163,6 @@ void analyze_aligned_segments(std::vector<AlignedSegment> const & aligned_segmen
                            next.orientation};
             auto inserted_bases = query_sequence | seqan3::views::slice(current.get_query_end(), next.get_query_start());
             Junction new_junction{mate1, mate2, inserted_bases, read_name};
-            seqan3::debug_stream << "BND: " << new_junction << "\n";
             junctions.push_back(std::move(new_junction));
         }
     }
@@ -94,11 +178,20 @@ void analyze_sa_tag(std::string const & query_name,
                     std::string const & sa_tag,
                     std::vector<Junction> & junctions)
 {
+    // Reused for all reads of the thread, see parse_sa_tag().
+    thread_local std::vector<AlignedSegment> aligned_segments{};
+    if (aligned_segments.empty())
+        aligned_segments.emplace_back();
+
+    AlignedSegment & primary_segment = aligned_segments[0];
+    primary_segment.orientation = (hasFlagReverseComplement(flag) ? strand::reverse : strand::forward);
+    primary_segment.ref_name.assign(ref_name);
+    primary_segment.pos = pos;
+    primary_segment.mapq = mapq;
+    primary_segment.assign_cigar(cigar);
+    size_t const number_of_segments = parse_sa_tag(sa_tag, aligned_segments, 1);
 
-    std::vector<AlignedSegment> aligned_segments{};
-    strand strand = (hasFlagReverseComplement(flag) ? strand::reverse : strand::forward);
-    aligned_segments.push_back(AlignedSegment{strand, ref_name, pos, mapq, cigar});
-    retrieve_aligned_segments(sa_tag, aligned_segments);
-    std::sort(aligned_segments.begin(), aligned_segments.end());
-    analyze_aligned_segments(aligned_segments, junctions, seq, query_name);
+    std::span<AlignedSegment> const segments{aligned_segments.data(), number_of_segments};
+    std::sort(segments.begin(), segments.end());
+    analyze_aligned_segments(segments, junctions, seq, query_name);
 }
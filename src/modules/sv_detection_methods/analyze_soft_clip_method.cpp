@@ -0,0 +1,110 @@
+#include "modules/sv_detection_methods/analyze_soft_clip_method.hpp"
+
+#include <limits>       // for std::numeric_limits
+
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+using seqan3::operator""_dna5;
+
+void SoftClipDetector::close_pileup(ClipPileup & pileup, std::vector<Junction> & junctions)
+{
+    uint32_t const support = pileup.support;
+    int32_t const position = (pileup.position_sum + support / 2) / support;
+    pileup.position_sum = 0;
+    pileup.support = 0;
+    if (support < min_support)
+        return;
+
+    while (!candidates.empty() && candidates.front().position < position - max_pair_distance)
+        candidates.pop_front();
+
+    ClipCandidate new_candidate{position, pileup.is_left_clip, false};
+    for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); ++candidate)
+    {
+        // Positions of right clips are the last aligned base, positions of left clips the first one.
+        int32_t const variant_length = pileup.is_left_clip ? position - candidate->position - 1
+                                                           : position - candidate->position + 1;
+        if (candidate->is_paired || candidate->is_left_clip == pileup.is_left_clip || variant_length < min_var_length)
+            continue;
+
+        // Like the CIGAR method, a deletion connects the last base before and the first base after the deleted
+        // sequence, and a tandem duplication connects the end of the duplicated sequence with its start.
+        Junction new_junction{Breakend{ref_name, pileup.is_left_clip ? candidate->position : position, strand::forward},
+                              Breakend{ref_name, pileup.is_left_clip ? position : candidate->position, strand::forward},
+                              ""_dna5,
+                              "soft_clip"};
+        junctions.push_back(std::move(new_junction));
+        candidate->is_paired = true;
+        new_candidate.is_paired = true;
+        break;
+    }
+    candidates.push_back(new_candidate);
+}
+
+void SoftClipDetector::add_to_pileup(ClipPileup & pileup, int32_t const position, std::vector<Junction> & junctions)
+{
+    if (pileup.support > 0 && position > pileup.last_position + cluster_distance)
+        close_pileup(pileup, junctions);
+    pileup.last_position = position;
+    pileup.position_sum += position;
+    ++pileup.support;
+}
+
+void SoftClipDetector::process_clips_before(int32_t const position, std::vector<Junction> & junctions)
+{
+    // No later alignment ends before its own start, so the right clips before the position are complete.
+    while (!right_clips.empty() && right_clips.top() < position)
+    {
+        int32_t const right_clip = right_clips.top();
+        // Close the left pileup first if it lies before, so that the candidates are created in positional order.
+        if (left_pileup.support > 0 && left_pileup.last_position + cluster_distance < right_clip)
+            close_pileup(left_pileup, junctions);
+        add_to_pileup(right_pileup, right_clip, junctions);
+        right_clips.pop();
+    }
+
+    bool const close_left = left_pileup.support > 0 &&
+                            static_cast<int64_t>(left_pileup.last_position) + cluster_distance < position;
+    bool const close_right = right_pileup.support > 0 &&
+                             static_cast<int64_t>(right_pileup.last_position) + cluster_distance < position;
+    if (close_left && close_right && right_pileup.last_position < left_pileup.last_position)
+    {
+        close_pileup(right_pileup, junctions);
+        close_pileup(left_pileup, junctions);
+    }
+    else
+    {
+        if (close_left)
+            close_pileup(left_pileup, junctions);
+        if (close_right)
+            close_pileup(right_pileup, junctions);
+    }
+}
+
+void SoftClipDetector::finish(std::vector<Junction> & junctions)
+{
+    process_clips_before(std::numeric_limits<int32_t>::max(), junctions);
+    candidates.clear();
+}
+
+void SoftClipDetector::add_alignment(int32_t const ref_id,
+                                     std::string const & ref_name,
+                                     int32_t const pos,
+                                     std::vector<seqan3::cigar> const & cigar,
+                                     std::vector<Junction> & junctions)
+{
+    if (ref_id != this->ref_id)
+    {
+        finish(junctions);
+        this->ref_id = ref_id;
+        this->ref_name = ref_name;
+    }
+    process_clips_before(pos, junctions);
+
+    segment.pos = pos;
+    segment.assign_cigar(cigar);
+    if (segment.get_left_soft_clip() >= min_clip_length)
+        add_to_pileup(left_pileup, pos, junctions);
+    if (segment.get_right_soft_clip() >= min_clip_length)
+        right_clips.push(segment.get_reference_end() - 1);
+}
@@ -1,131 +1,73 @@
 #include "structures/aligned_segment.hpp"
 
+#include <iostream>  // for std::cerr
+
 #include <seqan3/alphabet/cigar/cigar.hpp>
 
-int32_t AlignedSegment::get_reference_start() const
+AlignedSegment::AlignedSegment(strand const orientation,
+                               std::string ref_name,
+                               int32_t const pos,
+                               int32_t const mapq,
+                               std::vector<seqan3::cigar> const & cigar) :
+    ref_name{std::move(ref_name)},
+    pos{pos},
+    mapq{mapq},
+    orientation{orientation}
 {
-    return pos;
+    assign_cigar(cigar);
 }
 
-int32_t AlignedSegment::get_reference_end() const
+void AlignedSegment::assign_cigar(std::vector<seqan3::cigar> const & cigar)
 {
-    int32_t current_pos = pos;
-    for (auto [element_length, element_operation] : cig)
-    {
-        switch(element_operation.to_char())
-        {
-            case 'M':
-            case 'D':
-            case 'N':
-            case 'X':
-            case '=':
-                current_pos += element_length;
-                break;
-            case 'I':
-            case 'S':
-            case 'H':
-            case 'P': // do nothing
-                break;
-            default:
-                std::cerr << "The default case was accidentally triggered by the following element, which is no part of"
-                             " a CIGAR string: "
-                          << element_operation.to_char() << '\n';
-                break;
-        }
-    }
-    return current_pos;
+    clear_cigar();
+    for (auto [element_length, element_operation] : cigar)
+        add_cigar_element(element_length, element_operation.to_char());
 }
 
-int32_t AlignedSegment::get_left_soft_clip() const
+void AlignedSegment::clear_cigar()
 {
-    int32_t left_soft_clip = 0;
-    for (auto [element_length, element_operation] : cig)
-    {
-        if(element_operation.to_char() == 'S')
-        {
-            left_soft_clip += element_length;
-        }
-        else if(element_operation.to_char() == 'M' ||
-                element_operation.to_char() == '=' ||
-                element_operation.to_char() == 'X' ||
-                element_operation.to_char() == 'I')
-        {
-            break;
-        }
-    }
-    return left_soft_clip;
+    reference_end = pos;
+    query_length = 0;
+    left_soft_clip = 0;
+    right_soft_clip = 0;
+    cigar_hash = cigar_hash_basis;
 }
 
-int32_t AlignedSegment::get_right_soft_clip() const
+void AlignedSegment::add_cigar_element(uint32_t const length, char const operation)
 {
-    int32_t right_soft_clip = 0;
-    for (auto [element_length, element_operation] : std::views::reverse(cig))
+    // FNV-1a step over the element, so that CIGAR strings with the same spans but other elements differ.
+    cigar_hash = (cigar_hash ^ ((uint64_t{length} << 8) | static_cast<unsigned char>(operation))) * 1099511628211u;
+    switch(operation)
     {
-        if(element_operation.to_char() == 'S')
-        {
-            right_soft_clip += element_length;
-        }
-        else if(element_operation.to_char() == 'M' ||
-                element_operation.to_char() == '=' ||
-                element_operation.to_char() == 'X' ||
-                element_operation.to_char() == 'I')
-        {
+        case 'S':
+            // As long as only soft clips were added, the query length equals the left soft clip.
+            if (query_length == left_soft_clip)
+                left_soft_clip += length;
+            right_soft_clip += length;
+            query_length += length;
+            break;
+        case 'M':
+        case 'X':
+        case '=':
+            reference_end += length;
+            [[fallthrough]];
+        case 'I':
+            // A soft clip is only a right soft clip if no aligned base follows.
+            right_soft_clip = 0;
+            query_length += length;
+            break;
+        case 'D':
+        case 'N':
+            reference_end += length;
+            break;
+        case 'H':
+        case 'P': // do nothing
+            break;
+        default:
+            std::cerr << "The default case was accidentally triggered by the following element, which is no part of"
+                         " a CIGAR string: "
+                      << operation << '\n';
             break;
-        }
-    }
-    return right_soft_clip;
-}
-
-int32_t AlignedSegment::get_query_start() const
-{
-    if (orientation == strand::forward)
-    {
-        return get_left_soft_clip();
-    }
-    else
-    {
-        return get_right_soft_clip();
-    }
-}
-
-int32_t AlignedSegment::get_query_length() const
-{
-    int32_t current_length = 0;
-    for (auto [element_length, element_operation] : cig)
-    {
-        switch(element_operation.to_char())
-        {
-            case 'M':
-            case 'S':
-            case 'I':
-            case 'X':
-            case '=':
-                current_length += element_length;
-                break;
-            case 'D':
-            case 'N':
-            case 'H':
-            case 'P': // do nothing
-                break;
-            default:
-                std::cerr << "The default case was accidentally triggered by the following element, which is no part of"
-                             " a CIGAR string: "
-                          << element_operation.to_char() << '\n';
-                break;
-        }
-    }
-    return current_length;
-}
-
-int32_t AlignedSegment::get_query_end() const
-{
-    if (orientation == strand::forward)
-    {
-        return get_query_length() - get_right_soft_clip();
-    }
-    else
-    {
-        return get_query_length() - get_left_soft_clip();
     }
 }
 
@@ -144,5 +86,9 @@ bool operator==(AlignedSegment const & lhs, AlignedSegment const & rhs)
            lhs.ref_name == rhs.ref_name &&
            lhs.pos == rhs.pos &&
            lhs.mapq == rhs.mapq &&
-           lhs.cig == rhs.cig;
+           lhs.reference_end == rhs.reference_end &&
+           lhs.query_length == rhs.query_length &&
+           lhs.left_soft_clip == rhs.left_soft_clip &&
+           lhs.right_soft_clip == rhs.right_soft_clip &&
+           lhs.cigar_hash == rhs.cigar_hash;
 }
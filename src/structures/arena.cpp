@@ -0,0 +1,28 @@
+#include "structures/arena.hpp"
+
+#include <algorithm>    // for std::max
+
+void * Arena::allocate_in_next_block(size_t const bytes)
+{
+    // Blocks are only skipped if a single allocation is larger than them.
+    size_t next_block = blocks.empty() ? 0 : current_block + 1;
+    while (next_block < blocks.size() && blocks[next_block].size < bytes)
+        ++next_block;
+
+    if (next_block == blocks.size())
+    {
+        size_t const block_size = std::max(bytes, blocks.empty() ? initial_block_size : 2 * blocks.back().size);
+        blocks.push_back(Block{std::unique_ptr<std::byte[]>{new std::byte[block_size]}, block_size});
+    }
+    current_block = next_block;
+    offset = bytes;
+    return blocks[current_block].data.get();
+}
+
+size_t Arena::capacity() const
+{
+    size_t total_size = 0;
+    for (Block const & block : blocks)
+        total_size += block.size;
+    return total_size;
+}
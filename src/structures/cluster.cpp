@@ -5,7 +5,10 @@
 
 size_t Cluster::get_cluster_size() const
 {
-    return members.size();
+    size_t number_of_reads = 0;
+    for (Junction const & member : members)
+        number_of_reads += member.get_weight();
+    return number_of_reads;
 }
 
 Breakend Cluster::get_average_mate1() const
@@ -31,10 +34,10 @@ Breakend Cluster::get_average_mate1() const
                 throw std::runtime_error("Junctions with incompatible breakends were clustered together (different seq_name or orientation).");
             }
         }
-        // Add up breakend positions aross all members
-        sum_positions += mate1.position;
+        // Add up breakend positions aross all members, each member counts for its reads
+        sum_positions += static_cast<uint64_t>(mate1.position) * members[i].get_weight();
     }
-    int32_t average_position = std::round(static_cast<double>(sum_positions) / members.size());
+    int32_t average_position = std::round(static_cast<double>(sum_positions) / get_cluster_size());
     Breakend average_breakend{seq_name, average_position, orientation};
     return average_breakend;
 }
@@ -62,10 +65,10 @@ Breakend Cluster::get_average_mate2() const
                 throw std::runtime_error("Junctions with incompatible breakends were clustered together (different seq_name or orientation).");
             }
         }
-        // Add up breakend positions aross all members
-        sum_positions += mate2.position;
+        // Add up breakend positions aross all members, each member counts for its reads
+        sum_positions += static_cast<uint64_t>(mate2.position) * members[i].get_weight();
     }
-    int32_t average_position = std::round(static_cast<double>(sum_positions) / members.size());
+    int32_t average_position = std::round(static_cast<double>(sum_positions) / get_cluster_size());
     Breakend average_breakend{seq_name, average_position, orientation};
     return average_breakend;
 }
@@ -76,9 +79,9 @@ int32_t Cluster::get_average_inserted_sequence_size() const
     // Iterate through members of the cluster
     for (size_t i = 0; i < members.size(); ++i)
     {
-        sum_sizes += members[i].get_inserted_sequence().size();
+        sum_sizes += members[i].get_inserted_sequence().size() * members[i].get_weight();
     }
-    int32_t average_size = std::round(static_cast<double>(sum_sizes) / members.size());
+    int32_t average_size = std::round(static_cast<double>(sum_sizes) / get_cluster_size());
     return average_size;
 }
 
@@ -87,6 +90,74 @@ std::vector<Junction> Cluster::get_members() const
     return members;
 }
 
+void Cluster::set_refined_mates(Breakend mate1, Breakend mate2)
+{
+    refined_mates.emplace(std::move(mate1), std::move(mate2));
+}
+
+bool Cluster::is_refined() const
+{
+    return refined_mates.has_value();
+}
+
+Breakend Cluster::get_refined_mate1() const
+{
+    return refined_mates ? refined_mates->first : get_average_mate1();
+}
+
+Breakend Cluster::get_refined_mate2() const
+{
+    return refined_mates ? refined_mates->second : get_average_mate2();
+}
+
+void Cluster::set_refined_inserted_sequence(seqan3::dna5_vector inserted_sequence)
+{
+    refined_inserted_sequence = std::move(inserted_sequence);
+}
+
+std::optional<seqan3::dna5_vector> const & Cluster::get_refined_inserted_sequence() const
+{
+    return refined_inserted_sequence;
+}
+
+int32_t Cluster::get_refined_inserted_sequence_size() const
+{
+    return refined_inserted_sequence ? static_cast<int32_t>(refined_inserted_sequence->size())
+                                     : get_average_inserted_sequence_size();
+}
+
+size_t Cluster::get_estimated_support() const
+{
+    double support = 0;
+    for (Junction const & member : members)
+        support += member.get_weight() / member.get_sampling_rate();
+    return std::round(support);
+}
+
+std::vector<size_t> Cluster::get_variant_support(size_t const number_of_samples) const
+{
+    std::vector<double> variant_support(number_of_samples, 0);
+    for (Junction const & member : members)
+    {
+        if (member.get_sample_id() < number_of_samples)
+            variant_support[member.get_sample_id()] += member.get_weight() / member.get_sampling_rate();
+    }
+    std::vector<size_t> rounded_variant_support(number_of_samples);
+    for (size_t sample_id = 0; sample_id < number_of_samples; ++sample_id)
+        rounded_variant_support[sample_id] = std::round(variant_support[sample_id]);
+    return rounded_variant_support;
+}
+
+void Cluster::set_reference_support(std::vector<size_t> number_of_reads)
+{
+    reference_support = std::move(number_of_reads);
+}
+
+std::vector<size_t> const & Cluster::get_reference_support() const
+{
+    return reference_support;
+}
+
 bool operator<(Cluster const & lhs, Cluster const & rhs)
 {
     return lhs.get_average_mate1() != rhs.get_average_mate1()
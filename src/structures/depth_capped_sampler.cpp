@@ -0,0 +1,43 @@
+#include "structures/depth_capped_sampler.hpp"
+
+double read_name_fraction(std::string const & read_name)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char const character : read_name)
+    {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 1099511628211ull;
+    }
+    // The last characters only change the lower bits of FNV-1a, the finalizer of MurmurHash3 mixes them into the upper
+    // bits, which fill the mantissa of a double.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return static_cast<double>(hash >> 11) / static_cast<double>(uint64_t{1} << 53);
+}
+
+double DepthCappedSampler::sample(std::string const & read_name,
+                                  int32_t const ref_id,
+                                  int32_t const start,
+                                  int32_t const end)
+{
+    if (max_depth == 0)
+        return 1.0;
+
+    if (ref_id != current_ref_id)
+    {
+        alignment_ends = {};
+        current_ref_id = ref_id;
+    }
+    while (!alignment_ends.empty() && alignment_ends.top() <= start)
+        alignment_ends.pop();
+    alignment_ends.push(end);
+
+    size_t const depth = alignment_ends.size();
+    if (depth <= max_depth)
+        return 1.0;
+    double const sampling_rate = static_cast<double>(max_depth) / depth;
+    return (read_name_fraction(read_name) < sampling_rate) ? sampling_rate : 0.0;
+}
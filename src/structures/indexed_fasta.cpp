@@ -0,0 +1,183 @@
+#include "structures/indexed_fasta.hpp"
+
+#include <cstring>      // for std::memchr
+#include <fstream>      // for std::ifstream
+#include <sstream>      // for std::istringstream
+#include <utility>      // for std::exchange
+
+#include <fcntl.h>      // for open
+#include <sys/mman.h>   // for mmap, munmap, madvise
+#include <sys/stat.h>   // for fstat
+#include <unistd.h>     // for close
+
+IndexedFasta::IndexedFasta(std::filesystem::path const & fasta_path)
+{
+    int const file_descriptor = open(fasta_path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+        throw std::runtime_error{"Could not open file '" + fasta_path.string() + "' for reading."};
+
+    struct stat file_status{};
+    if (fstat(file_descriptor, &file_status) != 0 || file_status.st_size == 0)
+    {
+        close(file_descriptor);
+        throw std::runtime_error{"The reference file '" + fasta_path.string() + "' is empty."};
+    }
+    file_size = file_status.st_size;
+
+    void * const mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    // The mapping stays valid after closing the file.
+    close(file_descriptor);
+    if (mapping == MAP_FAILED)
+        throw std::runtime_error{"Could not map the reference file '" + fasta_path.string() + "' into memory."};
+    // Bases are looked up at the positions of the variants, not read sequentially.
+    madvise(mapping, file_size, MADV_RANDOM);
+    data = static_cast<char const *>(mapping);
+
+    try
+    {
+        std::filesystem::path index_path{fasta_path};
+        index_path += ".fai";
+        if (std::filesystem::exists(index_path))
+            read_index(index_path);
+        else
+            compute_index();
+    }
+    catch (...)
+    {
+        munmap(const_cast<char *>(data), file_size);
+        throw;
+    }
+
+    for (size_t id = 0; id < index_entries.size(); ++id)
+        name_to_id.emplace(index_entries[id].name, id);
+}
+
+IndexedFasta::IndexedFasta(IndexedFasta && other) noexcept :
+    data{std::exchange(other.data, nullptr)},
+    file_size{std::exchange(other.file_size, 0)},
+    index_entries{std::move(other.index_entries)},
+    name_to_id{std::move(other.name_to_id)}
+{}
+
+IndexedFasta & IndexedFasta::operator=(IndexedFasta && other) noexcept
+{
+    if (this != &other)
+    {
+        if (data != nullptr)
+            munmap(const_cast<char *>(data), file_size);
+        data = std::exchange(other.data, nullptr);
+        file_size = std::exchange(other.file_size, 0);
+        index_entries = std::move(other.index_entries);
+        name_to_id = std::move(other.name_to_id);
+    }
+    return *this;
+}
+
+IndexedFasta::~IndexedFasta()
+{
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), file_size);
+}
+
+void IndexedFasta::read_index(std::filesystem::path const & index_path)
+{
+    std::ifstream index_file{index_path};
+    if (!index_file.good())
+        throw std::runtime_error{"Could not open file '" + index_path.string() + "' for reading."};
+
+    std::string line{};
+    while (std::getline(index_file, line))
+    {
+        if (line.empty())
+            continue;
+        std::istringstream fields{line};
+        FastaIndexEntry entry{};
+        if (!std::getline(fields, entry.name, '\t') ||
+            !(fields >> entry.length >> entry.offset >> entry.line_bases >> entry.line_width) ||
+            entry.line_bases == 0 || entry.line_width < entry.line_bases)
+        {
+            throw std::runtime_error{"The FASTA index '" + index_path.string() + "' has a wrong format: " + line};
+        }
+        // The last base has to lie inside the mapped file.
+        if (entry.length > 0 &&
+            entry.offset + (entry.length - 1) / entry.line_bases * entry.line_width +
+            (entry.length - 1) % entry.line_bases >= file_size)
+        {
+            throw std::runtime_error{"The FASTA index '" + index_path.string() + "' does not match the reference "
+                                     "file. Please recreate it with 'samtools faidx'."};
+        }
+        index_entries.push_back(std::move(entry));
+    }
+}
+
+void IndexedFasta::compute_index()
+{
+    char const * const file_end = data + file_size;
+    auto line_end = [file_end] (char const * const line_begin)
+    {
+        char const * const newline = static_cast<char const *>(std::memchr(line_begin, '\n', file_end - line_begin));
+        return newline == nullptr ? file_end : newline;
+    };
+
+    char const * line_begin = data;
+    while (line_begin < file_end)
+    {
+        char const * header_end = line_end(line_begin);
+        if (*line_begin != '>')
+        {
+            throw std::runtime_error{"The reference file is not in FASTA format: every sequence has to start with a "
+                                     "line beginning with '>'."};
+        }
+        FastaIndexEntry entry{};
+        char const * name_end = line_begin + 1;
+        while (name_end < header_end && *name_end != ' ' && *name_end != '\t' && *name_end != '\r')
+            ++name_end;
+        entry.name.assign(line_begin + 1, name_end);
+        line_begin = header_end + 1;
+        entry.offset = line_begin - data;
+
+        // All lines of a sequence except for the last one have to be equally long.
+        bool last_line_seen = false;
+        while (line_begin < file_end && *line_begin != '>')
+        {
+            char const * const newline = line_end(line_begin);
+            uint64_t const line_width = newline - line_begin + (newline < file_end ? 1 : 0);
+            uint64_t const line_bases = newline - line_begin - (newline > line_begin && newline[-1] == '\r' ? 1 : 0);
+            if (entry.line_bases == 0)
+            {
+                entry.line_bases = line_bases;
+                entry.line_width = line_width;
+            }
+            else if (last_line_seen || line_bases > entry.line_bases)
+            {
+                throw std::runtime_error{"The sequence '" + entry.name + "' of the reference file has lines of "
+                                         "different lengths. Please index it with 'samtools faidx'."};
+            }
+            last_line_seen = last_line_seen || line_bases < entry.line_bases;
+            entry.length += line_bases;
+            line_begin = newline + 1;
+        }
+        index_entries.push_back(std::move(entry));
+    }
+}
+
+FastaIndexEntry const & IndexedFasta::checked_entry(size_t const id, uint64_t const begin, uint64_t const end) const
+{
+    if (id >= index_entries.size())
+        throw std::out_of_range{"The reference file has no sequence with ID " + std::to_string(id) + "."};
+    FastaIndexEntry const & entry = index_entries[id];
+    if (begin > end || end > entry.length)
+    {
+        throw std::out_of_range{"The range [" + std::to_string(begin) + ", " + std::to_string(end) + ") is not part "
+                                "of the reference sequence '" + entry.name + "'."};
+    }
+    return entry;
+}
+
+std::optional<size_t> IndexedFasta::get_id(std::string const & name) const
+{
+    auto const id = name_to_id.find(name);
+    if (id == name_to_id.end())
+        return std::nullopt;
+    return id->second;
+}
@@ -0,0 +1,77 @@
+#include "structures/interval_index.hpp"
+
+#include <algorithm>    // for std::sort, std::max, std::upper_bound
+#include <cstdint>      // for INT32_MAX
+#include <fstream>      // for std::ifstream
+#include <iterator>     // for std::prev
+#include <sstream>      // for std::istringstream
+#include <stdexcept>    // for std::runtime_error
+
+//!\brief Sorts the intervals of every sequence and merges overlapping and adjacent ones.
+static void merge_intervals(std::unordered_map<std::string, std::vector<std::pair<int32_t, int32_t>>> & intervals)
+{
+    for (auto & [seq_name, seq_intervals] : intervals)
+    {
+        std::sort(seq_intervals.begin(), seq_intervals.end());
+        size_t merged = 0;
+        for (size_t interval = 1; interval < seq_intervals.size(); ++interval)
+        {
+            if (seq_intervals[interval].first <= seq_intervals[merged].second)
+                seq_intervals[merged].second = std::max(seq_intervals[merged].second, seq_intervals[interval].second);
+            else
+                seq_intervals[++merged] = seq_intervals[interval];
+        }
+        seq_intervals.resize(merged + 1);
+    }
+}
+
+IntervalIndex::IntervalIndex(std::vector<GenomicInterval> const & genomic_intervals)
+{
+    for (GenomicInterval const & interval : genomic_intervals)
+    {
+        if (interval.begin < interval.end)
+            intervals[interval.seq_name].emplace_back(interval.begin, interval.end);
+    }
+    merge_intervals(intervals);
+}
+
+IntervalIndex::IntervalIndex(std::filesystem::path const & bed_file_path)
+{
+    std::ifstream bed_file{bed_file_path};
+    if (!bed_file.good())
+        throw std::runtime_error{"Could not open file '" + bed_file_path.string() + "' for reading."};
+
+    std::string line{};
+    while (std::getline(bed_file, line))
+    {
+        if (line.empty() || line[0] == '#' || line.compare(0, 5, "track") == 0 || line.compare(0, 7, "browser") == 0)
+            continue;
+        std::istringstream fields{line};
+        std::string seq_name{};
+        int64_t begin{};
+        int64_t end{};
+        if (!(fields >> seq_name >> begin >> end) || begin < 0 || end < begin || end > INT32_MAX)
+        {
+            throw std::runtime_error{"The BED file '" + bed_file_path.string() + "' has a wrong format: " + line};
+        }
+        if (begin < end)
+            intervals[seq_name].emplace_back(begin, end);
+    }
+    merge_intervals(intervals);
+}
+
+bool IntervalIndex::contains(std::string const & seq_name, int32_t const position) const
+{
+    auto const seq_intervals = intervals.find(seq_name);
+    if (seq_intervals == intervals.end())
+        return false;
+    // The last interval that begins at or before the position is the only one that can contain it.
+    auto const next_interval = std::upper_bound(seq_intervals->second.begin(),
+                                                seq_intervals->second.end(),
+                                                position,
+                                                [] (int32_t const value, std::pair<int32_t, int32_t> const & interval)
+                                                {
+                                                    return value < interval.first;
+                                                });
+    return next_interval != seq_intervals->second.begin() && position < std::prev(next_interval)->second;
+}
@@ -1,5 +1,8 @@
 #include "structures/junction.hpp"
 
+#include <algorithm>    // for std::stable_sort
+#include <tuple>        // for std::tie
+
 Breakend Junction::get_mate1() const
 {
     return mate1;
@@ -20,6 +23,77 @@ std::string Junction::get_read_name() const
     return read_name;
 }
 
+void Junction::set_sample_id(size_t const id)
+{
+    sample_id = id;
+}
+
+size_t Junction::get_sample_id() const
+{
+    return sample_id;
+}
+
+void Junction::set_sampling_rate(double const rate)
+{
+    sampling_rate = rate;
+}
+
+double Junction::get_sampling_rate() const
+{
+    return sampling_rate;
+}
+
+size_t Junction::get_weight() const
+{
+    return 1 + merged_read_names.size();
+}
+
+std::vector<std::string> Junction::get_read_names() const
+{
+    std::vector<std::string> read_names{read_name};
+    read_names.insert(read_names.end(), merged_read_names.begin(), merged_read_names.end());
+    return read_names;
+}
+
+bool Junction::is_mergeable(Junction const & other) const
+{
+    return *this == other && sample_id == other.sample_id && sampling_rate == other.sampling_rate;
+}
+
+void Junction::merge(Junction const & other)
+{
+    merged_read_names.push_back(other.read_name);
+    merged_read_names.insert(merged_read_names.end(), other.merged_read_names.begin(), other.merged_read_names.end());
+}
+
+void merge_identical_junctions(std::vector<Junction> & junctions)
+{
+    std::stable_sort(junctions.begin(), junctions.end(), [] (Junction const & lhs, Junction const & rhs)
+    {
+        if (lhs != rhs)
+            return lhs < rhs;
+        size_t const lhs_sample_id = lhs.get_sample_id();
+        size_t const rhs_sample_id = rhs.get_sample_id();
+        double const lhs_sampling_rate = lhs.get_sampling_rate();
+        double const rhs_sampling_rate = rhs.get_sampling_rate();
+        return std::tie(lhs_sample_id, lhs_sampling_rate) < std::tie(rhs_sample_id, rhs_sampling_rate);
+    });
+
+    size_t merged_size = 0;
+    for (size_t junction_id = 0; junction_id < junctions.size(); ++junction_id)
+    {
+        if (merged_size > 0 && junctions[merged_size - 1].is_mergeable(junctions[junction_id]))
+        {
+            junctions[merged_size - 1].merge(junctions[junction_id]);
+            continue;
+        }
+        if (merged_size != junction_id)
+            junctions[merged_size] = std::move(junctions[junction_id]);
+        ++merged_size;
+    }
+    junctions.resize(merged_size);
+}
+
 bool operator<(Junction const & lhs, Junction const & rhs)
 {
     return lhs.get_mate1() != rhs.get_mate1()
@@ -0,0 +1,47 @@
+#include "structures/quantile_sketch.hpp"
+
+#include <cmath>        // for std::log, std::exp, std::ceil
+#include <stdexcept>    // for std::invalid_argument
+
+QuantileSketch::QuantileSketch(double const relative_accuracy)
+{
+    if (!(relative_accuracy > 0 && relative_accuracy < 1))
+        throw std::invalid_argument{"The relative accuracy of a quantile sketch has to be in (0, 1)."};
+    log_gamma = std::log((1 + relative_accuracy) / (1 - relative_accuracy));
+}
+
+void QuantileSketch::add(uint64_t const value)
+{
+    ++count;
+    if (value == 0)
+    {
+        ++zero_count;
+        return;
+    }
+    size_t const index = static_cast<size_t>(std::ceil(std::log(static_cast<double>(value)) / log_gamma));
+    if (index >= bucket_counts.size())
+        bucket_counts.resize(index + 1, 0);
+    ++bucket_counts[index];
+}
+
+uint64_t QuantileSketch::quantile(double const q) const
+{
+    if (count == 0)
+        return 0;
+
+    uint64_t const rank = static_cast<uint64_t>(q * (count - 1));
+    uint64_t cumulative_count = zero_count;
+    if (rank < cumulative_count)
+        return 0;
+    for (size_t index = 0; index < bucket_counts.size(); ++index)
+    {
+        cumulative_count += bucket_counts[index];
+        if (rank < cumulative_count)
+        {
+            // Center of (gamma^(index-1), gamma^index] with the lowest relative error.
+            double const gamma = std::exp(log_gamma);
+            return std::llround(2 * std::exp(log_gamma * index) / (gamma + 1));
+        }
+    }
+    return std::llround(std::exp(log_gamma * (bucket_counts.size() - 1)));
+}
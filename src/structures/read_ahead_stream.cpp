@@ -0,0 +1,87 @@
+#include "structures/read_ahead_stream.hpp"
+
+#include <algorithm>    // for std::max
+#include <cerrno>       // for errno, EINTR
+#include <cstring>      // for std::strerror
+#include <optional>     // for std::optional
+#include <stdexcept>    // for std::runtime_error
+
+#include <fcntl.h>      // for open, posix_fadvise
+#include <unistd.h>     // for pread, close
+
+ReadAheadBuffer::ReadAheadBuffer(std::filesystem::path const & file_path, ReadAheadOptions const & options) :
+    file_name{file_path.string()},
+    options{std::max<size_t>(options.queue_depth, 1), std::max<size_t>(options.block_size, 1)},
+    blocks{this->options.queue_depth}
+{
+    file_descriptor = open(file_path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+        throw std::runtime_error{"Could not open file '" + file_name + "' for reading."};
+    // The kernel may read ahead further than for random access. The advice is only a hint, so errors are ignored.
+    posix_fadvise(file_descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+    prefetcher = std::thread{&ReadAheadBuffer::prefetch_blocks, this};
+}
+
+ReadAheadBuffer::~ReadAheadBuffer()
+{
+    // A blocked push returns false once the queue is closed, so the prefetch thread stops early.
+    blocks.close();
+    if (prefetcher.joinable())
+        prefetcher.join();
+    close(file_descriptor);
+}
+
+void ReadAheadBuffer::prefetch_blocks()
+{
+    off_t offset = 0;
+    while (true)
+    {
+        // The blocks that fit into the queue after this one are requested while this one is read.
+        posix_fadvise(file_descriptor,
+                      offset + options.block_size,
+                      options.block_size * options.queue_depth,
+                      POSIX_FADV_WILLNEED);
+
+        std::vector<char> block(options.block_size);
+        size_t filled = 0;
+        while (filled < block.size())
+        {
+            ssize_t const bytes = pread(file_descriptor, block.data() + filled, block.size() - filled, offset + filled);
+            if (bytes < 0 && errno == EINTR)
+                continue;
+            if (bytes < 0)
+            {
+                error_message = "Could not read file '" + file_name + "': " + std::strerror(errno);
+                break;
+            }
+            if (bytes == 0)
+                break;
+            filled += bytes;
+        }
+        block.resize(filled);
+        offset += filled;
+        if (filled == 0 || !error_message.empty() || !blocks.push(std::move(block)))
+            break;
+    }
+    blocks.close();
+}
+
+ReadAheadBuffer::int_type ReadAheadBuffer::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    std::optional<std::vector<char>> block = blocks.pop();
+    wait_time += std::chrono::steady_clock::now() - start;
+    if (!block)
+    {
+        // The error message was written before the queue was closed.
+        if (!error_message.empty())
+            throw std::runtime_error{error_message};
+        return traits_type::eof();
+    }
+    current_block = std::move(*block);
+    setg(current_block.data(), current_block.data(), current_block.data() + current_block.size());
+    return traits_type::to_int_type(*gptr());
+}
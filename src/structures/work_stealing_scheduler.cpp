@@ -0,0 +1,116 @@
+#include "structures/work_stealing_scheduler.hpp"
+
+#include <algorithm>    // for std::min
+#include <atomic>       // for std::atomic
+#include <deque>        // for std::deque
+#include <exception>    // for std::exception_ptr
+#include <mutex>        // for std::mutex
+#include <optional>     // for std::optional
+#include <thread>       // for std::thread
+#include <vector>       // for std::vector
+
+//!\brief The tasks of a worker that have not been started yet.
+struct WorkerQueue
+{
+    std::mutex mutex{};
+    std::deque<size_t> tasks{};
+};
+
+//!\brief Takes the first task of the worker's own queue.
+static std::optional<size_t> take_task(WorkerQueue & queue)
+{
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.tasks.empty())
+        return std::nullopt;
+    size_t const task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return task;
+}
+
+//!\brief Moves the back half of the fullest queue into the thief's queue and returns the first stolen task.
+static std::optional<size_t> steal_task(std::vector<WorkerQueue> & queues, size_t const thief)
+{
+    while (true)
+    {
+        // The sizes may change until the victim is locked, so the victim is checked again.
+        size_t victim = thief;
+        size_t most_tasks = 0;
+        for (size_t worker = 0; worker < queues.size(); ++worker)
+        {
+            std::lock_guard<std::mutex> lock{queues[worker].mutex};
+            if (queues[worker].tasks.size() > most_tasks)
+            {
+                victim = worker;
+                most_tasks = queues[worker].tasks.size();
+            }
+        }
+        if (most_tasks == 0)
+            return std::nullopt;
+
+        std::deque<size_t> stolen_tasks{};
+        {
+            std::lock_guard<std::mutex> lock{queues[victim].mutex};
+            std::deque<size_t> & victim_tasks = queues[victim].tasks;
+            if (victim_tasks.empty())
+                continue;
+            auto const stolen_begin = victim_tasks.begin() + victim_tasks.size() / 2;
+            stolen_tasks.assign(stolen_begin, victim_tasks.end());
+            victim_tasks.erase(stolen_begin, victim_tasks.end());
+        }
+        size_t const task = stolen_tasks.front();
+        stolen_tasks.pop_front();
+        if (!stolen_tasks.empty())
+        {
+            std::lock_guard<std::mutex> lock{queues[thief].mutex};
+            queues[thief].tasks = std::move(stolen_tasks);
+        }
+        return task;
+    }
+}
+
+void WorkStealingScheduler::run(size_t const number_of_tasks,
+                                std::function<void(size_t, uint16_t)> const & task) const
+{
+    if (number_of_tasks == 0)
+        return;
+
+    uint16_t const number_of_workers = std::min<size_t>(threads, number_of_tasks);
+    std::vector<WorkerQueue> queues(number_of_workers);
+    for (size_t task_id = 0; task_id < number_of_tasks; ++task_id)
+        queues[task_id % number_of_workers].tasks.push_back(task_id);
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception{};
+    std::mutex exception_mutex{};
+    auto work = [&] (uint16_t const worker)
+    {
+        while (!failed)
+        {
+            std::optional<size_t> task_id = take_task(queues[worker]);
+            if (!task_id)
+                task_id = steal_task(queues, worker);
+            if (!task_id)
+                break;
+            try
+            {
+                task(*task_id, worker);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{exception_mutex};
+                if (!exception)
+                    exception = std::current_exception();
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers{};
+    for (uint16_t worker = 1; worker < number_of_workers; ++worker)
+        workers.emplace_back(work, worker);
+    work(0);
+    for (std::thread & worker : workers)
+        worker.join();
+    if (exception)
+        std::rethrow_exception(exception);
+}
@@ -9,7 +9,9 @@ return std::unordered_map<std::string, detection_methods>{{"0", detection_method
                                                             {"2", detection_methods::read_pairs},
                                                             {"read_pairs", detection_methods::read_pairs},
                                                             {"3", detection_methods::read_depth},
-                                                            {"read_depth", detection_methods::read_depth}};
+                                                            {"read_depth", detection_methods::read_depth},
+                                                            {"4", detection_methods::soft_clips},
+                                                            {"soft_clips", detection_methods::soft_clips}};
 };
 
 std::unordered_map<std::string, clustering_methods> enumeration_names(clustering_methods)
@@ -0,0 +1,250 @@
+#include "variant_detection/variant_caller.hpp"
+
+#include <algorithm>    // for std::all_of
+#include <iterator>     // for std::make_move_iterator
+#include <stdexcept>    // for std::runtime_error
+
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
+#include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
+#include "modules/refinement/insertion_consensus.hpp"               // for compute_insertion_consensus()
+#include "structures/work_stealing_scheduler.hpp"                   // for class WorkStealingScheduler
+#include "variant_detection/bam_functions.hpp"                      // for hasFlag* functions, get_reference_length()
+
+VariantCaller::VariantCaller(VariantCallerConfig config, std::function<void(Cluster)> callback) :
+    config{std::move(config)},
+    callback{std::move(callback)},
+    soft_clip_detector{static_cast<int32_t>(this->config.min_var_length)},
+    sampler{this->config.max_depth}
+{
+    if (this->config.clustering_method != simple_clustering &&
+        this->config.clustering_method != hierarchical_clustering)
+    {
+        throw std::runtime_error{"The variant caller supports only the simple and the hierarchical clustering method."};
+    }
+}
+
+bool VariantCaller::is_closed(Breakend const & breakend) const
+{
+    auto const ref_id = ref_ids.find(breakend.seq_name);
+    if (ref_id == ref_ids.end())
+        return false;
+    // The references are numbered in the order of their alignments, so any other reference is finished.
+    if (ref_id->second != current_ref_id)
+        return true;
+    return static_cast<int64_t>(breakend.position) + config.closing_distance < current_pos;
+}
+
+//!\brief Returns whether an alignment is filtered out like in a long read file.
+static bool is_filtered(AlignmentRecord const & alignment)
+{
+    return hasFlagUnmapped(alignment.flag) || hasFlagSecondary(alignment.flag) || hasFlagDuplicate(alignment.flag) ||
+           alignment.mapq < 20 || alignment.ref_name.empty() || alignment.ref_pos < 0;
+}
+
+void VariantCaller::check_order(std::vector<AlignmentRecord> const & alignments) const
+{
+    int32_t ref_id = current_ref_id;
+    int32_t pos = current_pos;
+    // The references of the batch that were not seen before, numbered like accept_alignment() will number them.
+    std::unordered_map<std::string, int32_t> new_ref_ids{};
+    for (AlignmentRecord const & alignment : alignments)
+    {
+        if (is_filtered(alignment))
+            continue;
+
+        bool is_new_reference = false;
+        int32_t alignment_ref_id;
+        if (auto const known_ref_id = ref_ids.find(alignment.ref_name); known_ref_id != ref_ids.end())
+        {
+            alignment_ref_id = known_ref_id->second;
+        }
+        else
+        {
+            auto const [new_ref_id, is_inserted] =
+                new_ref_ids.try_emplace(alignment.ref_name, static_cast<int32_t>(ref_ids.size() + new_ref_ids.size()));
+            alignment_ref_id = new_ref_id->second;
+            is_new_reference = is_inserted;
+        }
+        if (!is_new_reference && alignment_ref_id != ref_id)
+        {
+            throw std::runtime_error{"The alignments must be sorted by coordinate: the reference '" +
+                                     alignment.ref_name + "' is continued after the alignments of another reference."};
+        }
+        if (alignment_ref_id == ref_id && alignment.ref_pos < pos)
+        {
+            throw std::runtime_error{"The alignments must be sorted by coordinate: the position " +
+                                     std::to_string(alignment.ref_pos) + " of the reference '" + alignment.ref_name +
+                                     "' follows the position " + std::to_string(pos) + "."};
+        }
+        ref_id = alignment_ref_id;
+        pos = alignment.ref_pos;
+    }
+}
+
+int32_t VariantCaller::accept_alignment(AlignmentRecord & alignment)
+{
+    if (is_filtered(alignment))
+        return -1;
+
+    auto const ref_id = ref_ids.try_emplace(alignment.ref_name, static_cast<int32_t>(ref_ids.size())).first;
+    // Only the SA tags of primary alignments are analysed, like in a long read file.
+    if (hasFlagSupplementary(alignment.flag))
+        alignment.sa_tag.clear();
+    current_ref_id = ref_id->second;
+    current_pos = alignment.ref_pos;
+    alignment.sampling_rate = sampler.sample(alignment.query_name,
+                                             current_ref_id,
+                                             alignment.ref_pos,
+                                             alignment.ref_pos + get_reference_length(alignment.cigar));
+    return current_ref_id;
+}
+
+void VariantCaller::push(AlignmentRecord alignment)
+{
+    std::vector<AlignmentRecord> alignments{};
+    alignments.push_back(std::move(alignment));
+    push(std::move(alignments));
+}
+
+void VariantCaller::push(std::vector<AlignmentRecord> alignments)
+{
+    if (finished)
+        throw std::runtime_error{"No alignments can be pushed into a variant caller after finish()."};
+
+    // The whole batch is checked before any alignment is accepted, so that a rejected batch leaves the caller as it
+    // was and the caller can still push the following alignments or finish().
+    check_order(alignments);
+
+    int32_t const previous_ref_id = current_ref_id;
+    std::vector<int32_t> alignment_ref_ids(alignments.size());
+    for (size_t alignment_id = 0; alignment_id < alignments.size(); ++alignment_id)
+        alignment_ref_ids[alignment_id] = accept_alignment(alignments[alignment_id]);
+
+    // The CIGAR strings and SA tags are analysed in chunks, whose junctions are appended in the order of the chunks.
+    size_t const chunk_size = 256;
+    size_t const number_of_chunks = (alignments.size() + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<Junction>> chunk_junctions(number_of_chunks);
+    WorkStealingScheduler const scheduler{config.threads};
+    scheduler.run(number_of_chunks, [&] (size_t const chunk_id, uint16_t)
+    {
+        for (size_t alignment_id = chunk_id * chunk_size;
+             alignment_id < std::min(alignments.size(), (chunk_id + 1) * chunk_size);
+             ++alignment_id)
+        {
+            if (alignment_ref_ids[alignment_id] >= 0 && alignments[alignment_id].sampling_rate > 0)
+            {
+                detect_junctions_in_alignment(alignments[alignment_id],
+                                              config.methods,
+                                              config.min_var_length,
+                                              chunk_junctions[chunk_id]);
+            }
+        }
+    });
+    for (std::vector<Junction> & junctions : chunk_junctions)
+        open_junctions.insert(open_junctions.end(),
+                              std::make_move_iterator(junctions.begin()),
+                              std::make_move_iterator(junctions.end()));
+
+    for (size_t alignment_id = 0; alignment_id < alignments.size(); ++alignment_id)
+    {
+        int32_t const ref_id = alignment_ref_ids[alignment_id];
+        if (ref_id < 0)
+            continue;
+        AlignmentRecord const & alignment = alignments[alignment_id];
+        for (detection_methods method : config.methods) {
+            switch (method)
+            {
+                case detection_methods::read_depth: // Detect junctions from read depth evidence
+                    read_depth_detector.add_alignment(ref_id,
+                                                      alignment.ref_name,
+                                                      alignment.ref_pos,
+                                                      alignment.ref_pos + get_reference_length(alignment.cigar),
+                                                      open_junctions);
+                    break;
+                case detection_methods::soft_clips: // Detect junctions from piles of soft clipped reads
+                    soft_clip_detector.add_alignment(ref_id,
+                                                     alignment.ref_name,
+                                                     alignment.ref_pos,
+                                                     alignment.cigar,
+                                                     open_junctions);
+                    break;
+                default:                            // There are no read pairs in long reads, the cigar string and
+                    break;                          // split read methods ran above.
+            }
+        }
+    }
+
+    // Closing sorts the open junctions, so it is done once per reference and every `closing_distance` bases.
+    if (current_ref_id != previous_ref_id ||
+        static_cast<int64_t>(current_pos) - last_closing_pos >= config.closing_distance)
+    {
+        last_closing_pos = current_pos;
+        close_regions(false);
+    }
+}
+
+void VariantCaller::close_regions(bool const close_all)
+{
+    // The open junctions are sorted and the identical ones merged, so a junction of many reads is clustered once.
+    merge_identical_junctions(open_junctions);
+
+    // The junctions are closed in neighbourhoods of their first breakends, the partitions of partition_junctions().
+    std::vector<Junction> closed_junctions{};
+    std::vector<Junction> remaining_junctions{};
+    size_t neighbourhood_begin = 0;
+    for (size_t junction_id = 1; junction_id <= open_junctions.size(); ++junction_id)
+    {
+        if (junction_id < open_junctions.size())
+        {
+            Breakend const & mate1 = open_junctions[junction_id].get_mate1();
+            Breakend const & previous_mate1 = open_junctions[junction_id - 1].get_mate1();
+            if (mate1.seq_name == previous_mate1.seq_name && mate1.orientation == previous_mate1.orientation &&
+                abs(mate1.position - previous_mate1.position) <= 50)
+                continue;
+        }
+        auto const neighbourhood_begin_it = open_junctions.begin() + neighbourhood_begin;
+        auto const neighbourhood_end_it = open_junctions.begin() + junction_id;
+        bool const is_neighbourhood_closed = close_all ||
+                                             std::all_of(neighbourhood_begin_it,
+                                                         neighbourhood_end_it,
+                                                         [this] (Junction const & junction)
+                                                         {
+                                                             return is_closed(junction.get_mate1()) &&
+                                                                    is_closed(junction.get_mate2());
+                                                         });
+        std::vector<Junction> & target = is_neighbourhood_closed ? closed_junctions : remaining_junctions;
+        target.insert(target.end(),
+                      std::make_move_iterator(neighbourhood_begin_it),
+                      std::make_move_iterator(neighbourhood_end_it));
+        neighbourhood_begin = junction_id;
+    }
+    open_junctions = std::move(remaining_junctions);
+    if (closed_junctions.empty())
+        return;
+
+    std::vector<Cluster> clusters{};
+    switch (config.clustering_method)
+    {
+        case simple_clustering:
+            clusters = simple_clustering_method(closed_junctions);
+            break;
+        default:                    // hierarchical clustering, the other methods are rejected by the constructor
+            clusters = hierarchical_clustering_method(closed_junctions, config.clustering_cutoff, config.threads);
+            break;
+    }
+    if (config.max_consensus_members > 0)
+        compute_insertion_consensus(clusters, config.min_var_length, config.max_consensus_members, config.threads);
+
+    for (Cluster & cluster : clusters)
+        callback(std::move(cluster));
+}
+
+void VariantCaller::finish()
+{
+    if (finished)
+        return;
+    finished = true;
+    read_depth_detector.finish(open_junctions);
+    soft_clip_detector.finish(open_junctions);
+    close_regions(true);
+}
@@ -1,28 +1,93 @@
 #include "variant_detection/variant_detection.hpp"
 
+#include <algorithm>    // for std::max, std::sort, std::stable_sort, std::remove_if, std::find_if
+#include <array>        // for std::array
+#include <chrono>       // for std::chrono::duration_cast
+#include <exception>    // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <iterator>     // for std::make_move_iterator
+#include <numeric>      // for std::iota
+#include <optional>     // for std::optional
+#include <stdexcept>    // for std::runtime_error
+#include <system_error> // for std::error_code
+#include <thread>       // for std::thread
+#include <type_traits>  // for std::conditional_t
+
 #include <seqan3/core/debug_stream.hpp>
 #include <seqan3/io/sam_file/input.hpp>         // SAM/BAM support (seqan3::sam_file_input)
+#include <seqan3/std/algorithm>                 // for std::ranges::find
 
 #include "modules/sv_detection_methods/analyze_cigar_method.hpp"    // for the split read method
+#include "modules/sv_detection_methods/analyze_read_depth_method.hpp"// for the read depth method
 #include "modules/sv_detection_methods/analyze_read_pair_method.hpp"// for the read pair method
 #include "modules/sv_detection_methods/analyze_sa_tag_method.hpp"   // for the cigar string method
+#include "modules/sv_detection_methods/analyze_soft_clip_method.hpp"// for the soft clip method
+#include "structures/bounded_queue.hpp"                             // for class BoundedQueue
+#include "structures/depth_capped_sampler.hpp"                      // for class DepthCappedSampler
+#include "structures/read_ahead_stream.hpp"                         // for class ReadAheadStream
+#include "structures/work_stealing_scheduler.hpp"                   // for class WorkStealingScheduler
 #include "variant_detection/bam_functions.hpp"                      // for hasFlag* functions
 
 using seqan3::operator""_tag;
 
+//!\brief A SAM/BAM input file with the fields `fields_t`, opened from a path or from a ReadAheadStream.
+template <typename fields_t>
+using alignment_file_input = seqan3::sam_file_input<seqan3::sam_file_input_default_traits<>,
+                                                     fields_t,
+                                                     seqan3::type_list<seqan3::format_sam, seqan3::format_bam>>;
+
+/*! \brief Opens an alignment file. If `read_ahead` has a queue depth, the file is read through a ReadAheadStream,
+ *         which is emplaced into `read_ahead_stream` and has to outlive the file. The format is then chosen by the
+ *         extension of the path.
+ */
+template <typename fields_t>
+static alignment_file_input<fields_t> open_alignment_file(std::filesystem::path const & file_path,
+                                                          ReadAheadOptions const & read_ahead,
+                                                          std::optional<ReadAheadStream> & read_ahead_stream)
+{
+    if (read_ahead.queue_depth == 0)
+        return alignment_file_input<fields_t>{file_path, fields_t{}};
+
+    read_ahead_stream.emplace(file_path, read_ahead);
+    if (file_path.extension() == ".bam")
+        return alignment_file_input<fields_t>{*read_ahead_stream, seqan3::format_bam{}, fields_t{}};
+    return alignment_file_input<fields_t>{*read_ahead_stream, seqan3::format_sam{}, fields_t{}};
+}
+
+//!\brief Prints the time that was spent waiting for the blocks of a file read ahead by `read_ahead_stream`, if any.
+static void report_io_wait_time(std::optional<ReadAheadStream> const & read_ahead_stream,
+                                std::filesystem::path const & file_path)
+{
+    if (!read_ahead_stream)
+        return;
+    auto const wait_time = std::chrono::duration_cast<std::chrono::milliseconds>(read_ahead_stream->get_wait_time());
+    seqan3::debug_stream << ("Waited " + std::to_string(wait_time.count()) + " ms for the input of " +
+                             file_path.string() + ".\n");
+}
+
 void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
                                               std::filesystem::path const & alignment_short_reads_file_path,
                                               std::vector<detection_methods> const & methods,
-                                              uint64_t const min_var_length)
+                                              uint64_t const min_var_length,
+                                              IntervalIndex const & excluded_regions,
+                                              uint32_t const max_depth,
+                                              ReadAheadOptions const & read_ahead,
+                                              ReadPairOptions const & read_pairs)
 {
     // Open input alignment file
-    using my_fields = seqan3::fields<seqan3::field::flag,       // 2: FLAG
+    using my_fields = seqan3::fields<seqan3::field::id,         // 1: QNAME
+                                     seqan3::field::flag,       // 2: FLAG
                                      seqan3::field::ref_id,     // 3: RNAME
                                      seqan3::field::ref_offset, // 4: POS
                                      seqan3::field::mapq,       // 5: MAPQ
+                                     seqan3::field::cigar,      // 6: CIGAR
+                                     seqan3::field::mate,       // 7: RNEXT, 8: PNEXT, 9: TLEN
+                                     seqan3::field::tags,
                                      seqan3::field::header_ptr>;
 
-    seqan3::sam_file_input alignment_short_reads_file{alignment_short_reads_file_path, my_fields{}};
+    std::optional<ReadAheadStream> read_ahead_stream{};
+    auto alignment_short_reads_file = open_alignment_file<my_fields>(alignment_short_reads_file_path,
+                                                                     read_ahead,
+                                                                     read_ahead_stream);
 
     // Check that the file is sorted before proceeding.
     if (alignment_short_reads_file.header().sorting != "coordinate")
@@ -30,13 +95,23 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
         throw seqan3::format_error{"ERROR: Input file must be sorted by coordinate (e.g. samtools sort)"};
     }
     uint16_t num_good = 0;
+    // The maximum insert size is learned per read group, the default is used during the warm-up.
+    ReadPairDetector read_pair_detector{read_pairs.default_max_insert_size, read_pairs.warm_up_pairs};
+    DepthCappedSampler sampler{max_depth};
+    ReadDepthDetector read_depth_detector{};
+    SoftClipDetector soft_clip_detector{static_cast<int32_t>(min_var_length)};
 
     for (auto & record : alignment_short_reads_file)
     {
+        std::string const & query_name     = record.id();                              // 1: QNAME
         seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
         int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
         int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
         uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
+        int32_t const mate_ref_id           = record.mate_reference_id().value_or(-1);  // 7: RNEXT
+        int32_t const mate_pos              = record.mate_position().value_or(-1);      // 8: PNEXT
+        int32_t const template_length       = record.template_length();                 // 9: TLEN
+        auto const & tags                   = record.tags();
         auto const header_ptr               = record.header_ptr();
         auto const ref_ids = header_ptr->ref_ids();
 
@@ -45,6 +120,18 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
             continue;
 
         std::string const ref_name = ref_ids[ref_id];
+        // The alignments of excluded regions are only counted for the read depth, which then has no gaps there.
+        // Only the start is tested, the junctions of alignments that reach into a region are dropped later.
+        if (excluded_regions.contains(ref_name, ref_pos))
+        {
+            if (std::ranges::find(methods, detection_methods::read_depth) != methods.end())
+                read_depth_detector.add_alignment(ref_id,
+                                                  ref_name,
+                                                  ref_pos,
+                                                  ref_pos + get_reference_length(record.cigar_sequence()),
+                                                  junctions);
+            continue;
+        }
         for (detection_methods method : methods) {
             switch (method)
             {
@@ -55,13 +142,55 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
                     seqan3::debug_stream << "The split read method for short reads is not yet implemented.\n";
                     break;
                 case detection_methods::read_pairs: // Detect junctions from read pair evidence
-                    if (hasFlagMultiple(flag))
+                    if (hasFlagMultiple(flag) && !hasFlagMateUnmapped(flag) && !hasFlagSupplementary(flag) &&
+                        mate_ref_id >= 0 && mate_pos >= 0)
                     {
-                        analyze_read_pair();
+                        // The pair is kept or dropped by its first read, so that a mate in a deeper region does
+                        // not leave the first read cached without its mate. The second read is still counted for
+                        // the depth.
+                        bool const is_second_read = read_pair_detector.has_pending_mate(query_name);
+                        double const sampling_rate = sampler.sample(query_name,
+                                                                    ref_id,
+                                                                    ref_pos,
+                                                                    ref_pos +
+                                                                        get_reference_length(record.cigar_sequence()));
+                        if (sampling_rate == 0 && !is_second_read)
+                            break;
+                        size_t const first_new_junction = junctions.size();
+                        AlignedSegment const segment{hasFlagReverseComplement(flag) ? strand::reverse
+                                                                                    : strand::forward,
+                                                     ref_name,
+                                                     ref_pos,
+                                                     mapq,
+                                                     record.cigar_sequence()};
+                        auto const read_group = tags.find("RG"_tag);
+                        read_pair_detector.add_alignment(query_name,
+                                                         read_group == tags.end()
+                                                             ? std::string{}
+                                                             : std::get<std::string>(read_group->second),
+                                                         segment,
+                                                         ref_id,
+                                                         mate_ref_id,
+                                                         mate_pos,
+                                                         hasFlagMateReverseComplement(flag) ? strand::reverse
+                                                                                            : strand::forward,
+                                                         template_length,
+                                                         hasFlagAllProperlyAligned(flag),
+                                                         junctions,
+                                                         sampling_rate);
+                        for (size_t junction_id = first_new_junction; junction_id < junctions.size(); ++junction_id)
+                            seqan3::debug_stream << "PAIR: " << junctions[junction_id] << "\n";
                     }
                     break;
                 case detection_methods::read_depth: // Detect junctions from read depth evidence
-                    seqan3::debug_stream << "The read depth method for short reads is not yet implemented.\n";
+                    read_depth_detector.add_alignment(ref_id,
+                                                      ref_name,
+                                                      ref_pos,
+                                                      ref_pos + get_reference_length(record.cigar_sequence()),
+                                                      junctions);
+                    break;
+                case detection_methods::soft_clips: // Detect junctions from piles of soft clipped reads
+                    soft_clip_detector.add_alignment(ref_id, ref_name, ref_pos, record.cigar_sequence(), junctions);
                     break;
             }
         }
@@ -72,25 +201,167 @@ void detect_junctions_in_short_reads_sam_file(std::vector<Junction> & junctions,
             seqan3::debug_stream << num_good << " good alignments from short read file." << std::endl;
         }
     }
+
+    read_depth_detector.finish(junctions);
+    soft_clip_detector.finish(junctions);
+
+    report_io_wait_time(read_ahead_stream, alignment_short_reads_file_path);
+    if (read_pair_detector.get_number_of_dropped_reads() > 0)
+    {
+        seqan3::debug_stream << read_pair_detector.get_number_of_dropped_reads()
+                             << " reads were not paired, because the cache of pending mates was full.\n";
+    }
 }
 
-void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
-                                             std::filesystem::path const & alignment_long_reads_file_path,
-                                             std::vector<detection_methods> const & methods,
-                                             uint64_t const min_var_length)
+//!\brief Detects the junctions in the CIGAR string of a long read alignment.
+static void analyze_cigar_of_alignment(AlignmentRecord & alignment,
+                                       uint64_t const min_var_length,
+                                       std::vector<Junction> & junctions)
 {
-    // Open input alignment file
-    using my_fields = seqan3::fields<seqan3::field::id,         // 1: QNAME
-                                     seqan3::field::flag,       // 2: FLAG
-                                     seqan3::field::ref_id,     // 3: RNAME
-                                     seqan3::field::ref_offset, // 4: POS
-                                     seqan3::field::mapq,       // 5: MAPQ
-                                     seqan3::field::cigar,      // 6: CIGAR
-                                     seqan3::field::seq,        // 10:SEQ
-                                     seqan3::field::tags,
-                                     seqan3::field::header_ptr>;
+    analyze_cigar(alignment.query_name,
+                  alignment.ref_name,
+                  alignment.ref_pos,
+                  alignment.cigar,
+                  alignment.seq,
+                  junctions,
+                  min_var_length);
+}
 
-    seqan3::sam_file_input alignment_long_reads_file{alignment_long_reads_file_path, my_fields{}};
+//!\brief Detects the junctions between the segments of a split long read from the SA tag of its primary alignment.
+static void analyze_sa_tag_of_alignment(AlignmentRecord const & alignment, std::vector<Junction> & junctions)
+{
+    if (alignment.sa_tag.empty())
+        return;
+    analyze_sa_tag(alignment.query_name,
+                   alignment.flag,
+                   alignment.ref_name,
+                   alignment.ref_pos,
+                   alignment.mapq,
+                   alignment.cigar,
+                   alignment.seq,
+                   alignment.sa_tag,
+                   junctions);
+}
+
+void detect_junctions_in_alignment(AlignmentRecord & alignment,
+                                   std::vector<detection_methods> const & methods,
+                                   uint64_t const min_var_length,
+                                   std::vector<Junction> & junctions)
+{
+    size_t const first_new_junction = junctions.size();
+    for (detection_methods method : methods) {
+        switch (method)
+        {
+            case detection_methods::cigar_string: // Detect junctions from CIGAR string
+                analyze_cigar_of_alignment(alignment, min_var_length, junctions);
+                break;
+            case detection_methods::split_read:   // Detect junctions from split read evidence (SA tags)
+                analyze_sa_tag_of_alignment(alignment, junctions);
+                break;
+            default:                              // The other methods need the alignments in order.
+                break;
+        }
+    }
+    if (alignment.sampling_rate < 1.0)
+    {
+        for (size_t junction_id = first_new_junction; junction_id < junctions.size(); ++junction_id)
+            junctions[junction_id].set_sampling_rate(alignment.sampling_rate);
+    }
+}
+
+/*! \brief The detection methods of a long read file as compile-time flags. The per-record loop is instantiated for
+ *         each set of methods, so that it contains only the methods in use and decodes only the fields they need.
+ */
+template <bool cigar_string_method, bool split_read_method, bool read_depth_method, bool soft_clips_method>
+struct LongReadMethods
+{
+    static constexpr bool cigar_string = cigar_string_method;
+    static constexpr bool split_read = split_read_method;
+    static constexpr bool read_depth = read_depth_method;
+    static constexpr bool soft_clips = soft_clips_method;
+    //!\brief The cigar string and split read methods need the names and sequences of the reads.
+    static constexpr bool analyzes_reads = cigar_string || split_read;
+};
+
+//!\brief The number of flags of LongReadMethods.
+static constexpr size_t number_of_long_read_methods = 4;
+
+//!\brief The fields of a long read file that are decoded for a set of methods.
+template <typename methods_t>
+using long_read_fields = std::conditional_t<methods_t::split_read,
+                                            seqan3::fields<seqan3::field::id,           // 1: QNAME
+                                                           seqan3::field::flag,         // 2: FLAG
+                                                           seqan3::field::ref_id,       // 3: RNAME
+                                                           seqan3::field::ref_offset,   // 4: POS
+                                                           seqan3::field::mapq,         // 5: MAPQ
+                                                           seqan3::field::cigar,        // 6: CIGAR
+                                                           seqan3::field::seq,          // 10:SEQ
+                                                           seqan3::field::tags,
+                                                           seqan3::field::header_ptr>,
+                        std::conditional_t<methods_t::cigar_string,
+                                            seqan3::fields<seqan3::field::id,           // 1: QNAME
+                                                           seqan3::field::flag,         // 2: FLAG
+                                                           seqan3::field::ref_id,       // 3: RNAME
+                                                           seqan3::field::ref_offset,   // 4: POS
+                                                           seqan3::field::mapq,         // 5: MAPQ
+                                                           seqan3::field::cigar,        // 6: CIGAR
+                                                           seqan3::field::seq,          // 10:SEQ
+                                                           seqan3::field::header_ptr>,
+                                            seqan3::fields<seqan3::field::flag,         // 2: FLAG
+                                                           seqan3::field::ref_id,       // 3: RNAME
+                                                           seqan3::field::ref_offset,   // 4: POS
+                                                           seqan3::field::mapq,         // 5: MAPQ
+                                                           seqan3::field::cigar,        // 6: CIGAR
+                                                           seqan3::field::header_ptr>>>;
+
+/*! \brief Detects the junctions of a long read alignment with the cigar string and split read methods of `methods_t`
+ *         and prints them. The detection methods themselves do not print, so that the library stays silent.
+ */
+template <typename methods_t>
+static void analyze_long_read_alignment(AlignmentRecord & alignment,
+                                        uint64_t const min_var_length,
+                                        std::vector<Junction> & junctions)
+{
+    size_t const first_new_junction = junctions.size();
+    if constexpr (methods_t::cigar_string)
+    {
+        analyze_cigar_of_alignment(alignment, min_var_length, junctions);
+        // The cigar string method finds insertions, which have an inserted sequence, and deletions.
+        for (size_t junction_id = first_new_junction; junction_id < junctions.size(); ++junction_id)
+        {
+            seqan3::debug_stream << (junctions[junction_id].get_inserted_sequence().empty() ? "DEL: " : "INS: ")
+                                 << junctions[junction_id] << "\n";
+        }
+    }
+    if constexpr (methods_t::split_read)
+    {
+        size_t const first_split_read_junction = junctions.size();
+        analyze_sa_tag_of_alignment(alignment, junctions);
+        for (size_t junction_id = first_split_read_junction; junction_id < junctions.size(); ++junction_id)
+            seqan3::debug_stream << "BND: " << junctions[junction_id] << "\n";
+    }
+    if (alignment.sampling_rate < 1.0)
+    {
+        for (size_t junction_id = first_new_junction; junction_id < junctions.size(); ++junction_id)
+            junctions[junction_id].set_sampling_rate(alignment.sampling_rate);
+    }
+}
+
+//!\brief The loop of detect_junctions_in_long_reads_sam_file() for the set of methods `methods_t`.
+template <typename methods_t>
+static void detect_junctions_in_long_reads(std::vector<Junction> & junctions,
+                                           std::filesystem::path const & alignment_long_reads_file_path,
+                                           uint64_t const min_var_length,
+                                           uint16_t const threads,
+                                           IntervalIndex const & excluded_regions,
+                                           uint32_t const max_depth,
+                                           ReadAheadOptions const & read_ahead)
+{
+    // Open input alignment file, only the fields needed by the methods are decoded.
+    std::optional<ReadAheadStream> read_ahead_stream{};
+    auto alignment_long_reads_file = open_alignment_file<long_read_fields<methods_t>>(alignment_long_reads_file_path,
+                                                                                      read_ahead,
+                                                                                      read_ahead_stream);
 
     // Check that the file is sorted before proceeding.
     if (alignment_long_reads_file.header().sorting != "coordinate")
@@ -98,59 +369,403 @@ void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
         throw seqan3::format_error{"ERROR: Input file must be sorted by coordinate (e.g. samtools sort)"};
     }
     uint16_t num_good = 0;
+    ReadDepthDetector read_depth_detector{};
+    SoftClipDetector soft_clip_detector{static_cast<int32_t>(min_var_length)};
+    DepthCappedSampler sampler{max_depth};
 
-    for (auto & record : alignment_long_reads_file)
+    // With several threads, this thread reads batches of alignments and the other threads detect their junctions.
+    // The read depth and soft clip methods need the alignments in order and stay on this thread.
+    size_t const number_of_detectors = (methods_t::analyzes_reads && threads > 1) ? threads - 1 : 0;
+    size_t const batch_size = 256;
+    using Batch = std::pair<size_t, std::vector<AlignmentRecord>>;
+    BoundedQueue<Batch> batches{2 * number_of_detectors};
+    // Every detector stores the junctions of its batches, they are merged in the order of the batches.
+    std::vector<std::vector<std::pair<size_t, std::vector<Junction>>>> detector_junctions(number_of_detectors);
+    // An exception of a detector closes the queue, so that the reader stops, and is rethrown on this thread.
+    std::vector<std::exception_ptr> detector_errors(number_of_detectors);
+    std::vector<std::thread> detectors{};
+    for (size_t detector = 0; detector < number_of_detectors; ++detector)
     {
-        std::string const query_name        = record.id();                              // 1: QNAME
-        seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
-        int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
-        int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
-        uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
-        std::vector<seqan3::cigar> cigar    = record.cigar_sequence();                  // 6: CIGAR
-        seqan3::dna5_vector const seq       = record.sequence();                        // 10:SEQ
-        auto tags                           = record.tags();
-        auto const header_ptr               = record.header_ptr();
-        auto const ref_ids = header_ptr->ref_ids();
+        detectors.emplace_back([&, detector] ()
+        {
+            try
+            {
+                for (std::optional<Batch> batch = batches.pop(); batch; batch = batches.pop())
+                {
+                    std::vector<Junction> batch_junctions{};
+                    for (AlignmentRecord & alignment : batch->second)
+                        analyze_long_read_alignment<methods_t>(alignment, min_var_length, batch_junctions);
+                    detector_junctions[detector].emplace_back(batch->first, std::move(batch_junctions));
+                }
+            }
+            catch (...)
+            {
+                detector_errors[detector] = std::current_exception();
+                batches.close();
+            }
+        });
+    }
+    auto finish_detectors = [&] ()
+    {
+        batches.close();
+        for (std::thread & detector : detectors)
+            detector.join();
+        detectors.clear();
+    };
 
-        if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagDuplicate(flag) || mapq < 20 ||
-            ref_id < 0 || ref_pos < 0)
-            continue;
+    try
+    {
+        Batch batch{0, {}};
+        for (auto & record : alignment_long_reads_file)
+        {
+            seqan3::sam_flag const flag         = record.flag();                            // 2: FLAG
+            int32_t const ref_id                = record.reference_id().value_or(-1);       // 3: RNAME
+            int32_t const ref_pos               = record.reference_position().value_or(-1); // 4: POS
+            uint8_t const mapq                  = record.mapping_quality();                 // 5: MAPQ
 
-        std::string const ref_name = ref_ids[ref_id];
-        for (detection_methods method : methods) {
-            switch (method)
+            if (hasFlagUnmapped(flag) || hasFlagSecondary(flag) || hasFlagDuplicate(flag) || mapq < 20 ||
+                ref_id < 0 || ref_pos < 0)
+                continue;
+
+            std::string const & ref_name = record.header_ptr()->ref_ids()[ref_id];                 // 3: RNAME
+            // The alignments of excluded regions are only counted for the read depth, which then has no gaps there.
+            // Only the start is tested, the junctions of alignments that reach into a region are dropped later.
+            if (excluded_regions.contains(ref_name, ref_pos))
             {
-                case detection_methods::cigar_string: // Detect junctions from CIGAR string
-                    analyze_cigar(query_name,
-                                  ref_name,
-                                  ref_pos,
-                                  cigar,
-                                  seq,
-                                  junctions,
-                                  min_var_length);
-                    break;
-                case detection_methods::split_read:     // Detect junctions from split read evidence (SA tag,
-                    if (!hasFlagSupplementary(flag))    //                                  primary alignments only)
-                    {
-                        std::string const sa_tag = tags.get<"SA"_tag>();
-                        if (!sa_tag.empty())
-                        {
-                            analyze_sa_tag(query_name, flag, ref_name, ref_pos, mapq, cigar, seq, sa_tag, junctions);
-                        }
-                    }
-                    break;
-                case detection_methods::read_pairs: // There are no read pairs in long reads.
-                    break;
-                case detection_methods::read_depth: // Detect junctions from read depth evidence
-                    seqan3::debug_stream << "The read depth method for long reads is not yet implemented.\n";
-                    break;
+                if constexpr (methods_t::read_depth)
+                {
+                    read_depth_detector.add_alignment(ref_id,
+                                                      ref_name,
+                                                      ref_pos,
+                                                      ref_pos + get_reference_length(record.cigar_sequence()),
+                                                      junctions);
+                }
+                continue;
+            }
+
+            AlignmentRecord alignment{{},
+                                      flag,
+                                      ref_name,
+                                      ref_pos,
+                                      mapq,
+                                      std::move(record.cigar_sequence()),                   // 6: CIGAR
+                                      {},
+                                      {}};
+            if constexpr (methods_t::analyzes_reads)
+            {
+                alignment.query_name = std::move(record.id());                              // 1: QNAME
+                alignment.seq = std::move(record.sequence());                               // 10:SEQ
+                // In deep regions, only the cigar string and split read methods skip the dropped alignments. The
+                // read depth and soft clip methods count reads and not junctions per read.
+                alignment.sampling_rate = sampler.sample(alignment.query_name,
+                                                         ref_id,
+                                                         ref_pos,
+                                                         ref_pos + get_reference_length(alignment.cigar));
+            }
+            if constexpr (methods_t::split_read)
+            {
+                if (!hasFlagSupplementary(flag))
+                    alignment.sa_tag = record.tags().get<"SA"_tag>();
+            }
+
+            if (detectors.empty() && alignment.sampling_rate > 0)
+                analyze_long_read_alignment<methods_t>(alignment, min_var_length, junctions);
+
+            if constexpr (methods_t::read_depth)    // Detect junctions from read depth evidence
+            {
+                read_depth_detector.add_alignment(ref_id,
+                                                  alignment.ref_name,
+                                                  ref_pos,
+                                                  ref_pos + get_reference_length(alignment.cigar),
+                                                  junctions);
+            }
+            if constexpr (methods_t::soft_clips)    // Detect junctions from piles of soft clipped reads
+            {
+                soft_clip_detector.add_alignment(ref_id, alignment.ref_name, ref_pos, alignment.cigar, junctions);
+            }
+
+            // The alignment is moved into the batch after the read depth and soft clip methods used it.
+            if (!detectors.empty() && alignment.sampling_rate > 0)
+            {
+                batch.second.push_back(std::move(alignment));
+                if (batch.second.size() == batch_size)
+                {
+                    size_t const next_batch_id = batch.first + 1;
+                    if (!batches.push(std::move(batch)))    // A detector failed and closed the queue.
+                        break;
+                    batch = Batch{next_batch_id, {}};
+                }
+            }
+
+            num_good++;
+            if (num_good % 1000 == 0)
+            {
+                seqan3::debug_stream << num_good << " good alignments from long read file." << std::endl;
             }
         }
+        if (!batch.second.empty() && !detectors.empty())
+            batches.push(std::move(batch));
+    }
+    catch (...)
+    {
+        finish_detectors();
+        throw;
+    }
+    finish_detectors();
+    for (std::exception_ptr const & error : detector_errors)
+        if (error)
+            std::rethrow_exception(error);
+    report_io_wait_time(read_ahead_stream, alignment_long_reads_file_path);
 
-        num_good++;
-        if (num_good % 1000 == 0)
+    std::vector<std::pair<size_t, std::vector<Junction>>> batch_junctions{};
+    for (auto & junctions_of_detector : detector_junctions)
+        for (auto & junctions_of_batch : junctions_of_detector)
+            batch_junctions.push_back(std::move(junctions_of_batch));
+    std::sort(batch_junctions.begin(), batch_junctions.end(), [] (auto const & lhs, auto const & rhs)
+    {
+        return lhs.first < rhs.first;
+    });
+    for (auto & [batch_id, junctions_of_batch] : batch_junctions)
+        junctions.insert(junctions.end(),
+                         std::make_move_iterator(junctions_of_batch.begin()),
+                         std::make_move_iterator(junctions_of_batch.end()));
+
+    if constexpr (methods_t::read_depth)
+        read_depth_detector.finish(junctions);
+    if constexpr (methods_t::soft_clips)
+        soft_clip_detector.finish(junctions);
+}
+
+/*! \brief Instantiates detect_junctions_in_long_reads() for the methods in use. The flags of the methods are fixed
+ *         one after the other, so the runtime choice is made once per file and not per record.
+ */
+template <bool ... method_flags>
+static void dispatch_long_read_methods(std::array<bool, number_of_long_read_methods> const & uses_method,
+                                       std::vector<Junction> & junctions,
+                                       std::filesystem::path const & alignment_long_reads_file_path,
+                                       uint64_t const min_var_length,
+                                       uint16_t const threads,
+                                       IntervalIndex const & excluded_regions,
+                                       uint32_t const max_depth,
+                                       ReadAheadOptions const & read_ahead)
+{
+    if constexpr (sizeof...(method_flags) == number_of_long_read_methods)
+    {
+        detect_junctions_in_long_reads<LongReadMethods<method_flags...>>(junctions,
+                                                                         alignment_long_reads_file_path,
+                                                                         min_var_length,
+                                                                         threads,
+                                                                         excluded_regions,
+                                                                         max_depth,
+                                                                         read_ahead);
+    }
+    else if (uses_method[sizeof...(method_flags)])
+    {
+        dispatch_long_read_methods<method_flags..., true>(uses_method,
+                                                          junctions,
+                                                          alignment_long_reads_file_path,
+                                                          min_var_length,
+                                                          threads,
+                                                          excluded_regions,
+                                                          max_depth,
+                                                          read_ahead);
+    }
+    else
+    {
+        dispatch_long_read_methods<method_flags..., false>(uses_method,
+                                                           junctions,
+                                                           alignment_long_reads_file_path,
+                                                           min_var_length,
+                                                           threads,
+                                                           excluded_regions,
+                                                           max_depth,
+                                                           read_ahead);
+    }
+}
+
+void detect_junctions_in_long_reads_sam_file(std::vector<Junction> & junctions,
+                                             std::filesystem::path const & alignment_long_reads_file_path,
+                                             std::vector<detection_methods> const & methods,
+                                             uint64_t const min_var_length,
+                                             uint16_t const threads,
+                                             IntervalIndex const & excluded_regions,
+                                             uint32_t const max_depth,
+                                             ReadAheadOptions const & read_ahead)
+{
+    auto uses = [&] (detection_methods const method)
+    {
+        return std::ranges::find(methods, method) != methods.end();
+    };
+    // In the order of the template parameters of LongReadMethods. There are no read pairs in long reads.
+    std::array<bool, number_of_long_read_methods> const uses_method{uses(detection_methods::cigar_string),
+                                          uses(detection_methods::split_read),
+                                          uses(detection_methods::read_depth),
+                                          uses(detection_methods::soft_clips)};
+    dispatch_long_read_methods<>(uses_method,
+                                 junctions,
+                                 alignment_long_reads_file_path,
+                                 min_var_length,
+                                 threads,
+                                 excluded_regions,
+                                 max_depth,
+                                 read_ahead);
+}
+
+std::vector<AlignmentSample> get_samples(cmd_arguments const & args)
+{
+    std::vector<AlignmentSample> samples{};
+    if (!args.alignment_short_reads_file_path.empty() || !args.alignment_long_reads_file_path.empty())
+    {
+        samples.push_back(AlignmentSample{"",
+                                          args.alignment_short_reads_file_path,
+                                          args.alignment_long_reads_file_path});
+    }
+    for (AlignmentSample & sample : samples)
+        sample.name = sample.get_primary_file_path().stem().string();
+    size_t const first_further_sample = samples.size();
+
+    auto find_sample = [&samples] (std::string const & name)
+    {
+        return std::find_if(samples.begin(), samples.end(), [&name] (AlignmentSample const & sample)
+        {
+            return sample.name == name;
+        });
+    };
+    auto duplicate_name_error = [] (std::string const & name)
+    {
+        return std::runtime_error{"Two samples would be named '" + name + "'. The samples are named after their "
+                                  "alignment files, only the short and long reads of a further sample may share "
+                                  "their name."};
+    };
+    for (std::filesystem::path const & short_reads_file_path : args.sample_short_reads_file_paths)
+    {
+        std::string const name = short_reads_file_path.stem().string();
+        if (find_sample(name) != samples.end())
+            throw duplicate_name_error(name);
+        samples.push_back(AlignmentSample{name, short_reads_file_path, ""});
+    }
+    // The long reads of a further sample join its short reads if both files have the same name, e.g. the files
+    // short/HG002.bam and long/HG002.bam are one sample HG002.
+    size_t const end_of_short_read_samples = samples.size();
+    for (std::filesystem::path const & long_reads_file_path : args.sample_long_reads_file_paths)
+    {
+        std::string const name = long_reads_file_path.stem().string();
+        auto const sample = find_sample(name);
+        size_t const sample_id = sample - samples.begin();
+        if (sample == samples.end())
         {
-            seqan3::debug_stream << num_good << " good alignments from long read file." << std::endl;
+            samples.push_back(AlignmentSample{name, "", long_reads_file_path});
+        }
+        else if (sample_id >= first_further_sample && sample_id < end_of_short_read_samples &&
+                 sample->long_reads_file_path.empty())
+        {
+            sample->long_reads_file_path = long_reads_file_path;
+        }
+        else
+        {
+            throw duplicate_name_error(name);
+        }
+    }
+    return samples;
+}
+
+void detect_junctions_in_samples(std::vector<Junction> & junctions,
+                                 std::vector<AlignmentSample> const & samples,
+                                 std::vector<detection_methods> const & methods,
+                                 uint64_t const min_var_length,
+                                 uint16_t const threads,
+                                 IntervalIndex const & excluded_regions,
+                                 uint32_t const max_depth,
+                                 ReadAheadOptions const & read_ahead,
+                                 ReadPairOptions const & read_pairs)
+{
+    // Every alignment file is a task that writes its own junctions. The largest files are started first and idle
+    // threads steal the files of the others. If there are more threads than files, the remaining threads detect the
+    // junctions of the long reads files.
+    struct DetectionTask
+    {
+        size_t sample_id;
+        bool long_reads;
+        std::filesystem::path file_path;
+        std::uintmax_t file_size;
+    };
+    std::vector<DetectionTask> tasks{};
+    for (size_t sample_id = 0; sample_id < samples.size(); ++sample_id)
+    {
+        for (bool const long_reads : {false, true})
+        {
+            std::filesystem::path const & file_path = long_reads ? samples[sample_id].long_reads_file_path
+                                                                 : samples[sample_id].short_reads_file_path;
+            if (file_path.empty())
+                continue;
+            std::error_code error{};
+            std::uintmax_t const file_size = std::filesystem::file_size(file_path, error);
+            tasks.push_back(DetectionTask{sample_id, long_reads, file_path, error ? 0 : file_size});
         }
     }
+    std::vector<std::vector<Junction>> task_junctions(tasks.size());
+    uint16_t const threads_per_file = std::max<size_t>(1, threads / std::max<size_t>(1, tasks.size()));
+    WorkStealingScheduler const scheduler{threads};
+    // A single thread reads the files in the order of the samples.
+    std::vector<size_t> task_order(tasks.size());
+    std::iota(task_order.begin(), task_order.end(), 0);
+    if (scheduler.get_threads() > 1)
+    {
+        std::stable_sort(task_order.begin(), task_order.end(), [&tasks] (size_t const lhs, size_t const rhs)
+        {
+            return tasks[lhs].file_size > tasks[rhs].file_size;
+        });
+    }
+    scheduler.run(tasks.size(), [&] (size_t const task_id, uint16_t)
+    {
+        size_t const file_id = task_order[task_id];
+        DetectionTask const & task = tasks[file_id];
+        // The sample is only named if there are several.
+        std::string const of_sample = (samples.size() > 1) ? " of sample " + samples[task.sample_id].name : "";
+        if (!task.long_reads)
+        {
+            // short reads
+            seqan3::debug_stream << ("Detect junctions in short reads" + of_sample + "...\n");
+            detect_junctions_in_short_reads_sam_file(task_junctions[file_id],
+                                                     task.file_path,
+                                                     methods,
+                                                     min_var_length,
+                                                     excluded_regions,
+                                                     max_depth,
+                                                     read_ahead,
+                                                     read_pairs);
+        }
+        else
+        {
+            // long reads
+            seqan3::debug_stream << ("Detect junctions in long reads" + of_sample + "...\n");
+            detect_junctions_in_long_reads_sam_file(task_junctions[file_id],
+                                                    task.file_path,
+                                                    methods,
+                                                    min_var_length,
+                                                    threads_per_file,
+                                                    excluded_regions,
+                                                    max_depth,
+                                                    read_ahead);
+        }
+        // Alignments outside of the excluded regions can still reach into them.
+        std::vector<Junction> & junctions_of_file = task_junctions[file_id];
+        junctions_of_file.erase(std::remove_if(junctions_of_file.begin(),
+                                               junctions_of_file.end(),
+                                               [&excluded_regions] (Junction const & junction)
+                                               {
+                                                   return excluded_regions.contains(junction.get_mate1()) ||
+                                                          excluded_regions.contains(junction.get_mate2());
+                                               }),
+                                junctions_of_file.end());
+        for (Junction & junction : task_junctions[file_id])
+            junction.set_sample_id(task.sample_id);
+        // At high coverage many reads give the same junction, which is then sorted and clustered once.
+        merge_identical_junctions(task_junctions[file_id]);
+    });
+
+    for (std::vector<Junction> & junctions_of_file : task_junctions)
+        junctions.insert(junctions.end(),
+                         std::make_move_iterator(junctions_of_file.begin()),
+                         std::make_move_iterator(junctions_of_file.end()));
 }
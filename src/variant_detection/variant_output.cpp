@@ -1,83 +1,211 @@
 #include "variant_detection/variant_output.hpp"
 
-#include <iostream> // for std::cout
+#include <algorithm>    // for std::min
+#include <atomic>       // for std::atomic
+#include <cctype>       // for std::toupper
+#include <iostream>     // for std::cout
+#include <map>          // for std::map
+#include <mutex>        // for std::mutex
+#include <sstream>      // for std::ostringstream
+#include <thread>       // for std::thread
 
-#include "structures/junction.hpp"              // for class Junction
-#include "variant_parser/variant_record.hpp"    // for class variant_header
+#include <seqan3/alphabet/views/to_char.hpp>
+#include <seqan3/utility/views/to.hpp>
+
+#include "modules/genotyping/genotyping.hpp"         // for genotype()
+#include "structures/junction.hpp"                  // for class Junction
+#include "variant_detection/variant_detection.hpp"  // for get_samples()
+#include "variant_parser/variant_record.hpp"        // for class variant_header
+
+/*! \brief Returns the base before a variant for the REF column, i.e. the base at the 0-based position of the first
+ *         mate, or N if it is unknown.
+ */
+static std::string reference_base(IndexedFasta const * reference, Breakend const & mate1)
+{
+    if (reference == nullptr || mate1.position < 0)
+        return "N";
+    std::optional<size_t> const id = reference->get_id(mate1.seq_name);
+    if (!id || static_cast<uint64_t>(mate1.position) >= reference->get_entry(*id).length)
+        return "N";
+    // VCF only allows the bases A, C, G, T and N in the REF column.
+    char const base = std::toupper(reference->base(*id, mate1.position));
+    return (base == 'A' || base == 'C' || base == 'G' || base == 'T') ? std::string(1, base) : "N";
+}
+
+/*! \brief Adds the values of all samples to a record: the number of reads supporting the variant (DV) and, for a
+ *         genotyped cluster, the genotype (GT) and the number of reads supporting the reference (DR) before it.
+ */
+static void add_samples(variant_record & record,
+                        Cluster const & cluster,
+                        size_t const number_of_samples,
+                        bool const genotyped)
+{
+    std::vector<size_t> const variant_support = cluster.get_variant_support(number_of_samples);
+    std::vector<size_t> const & reference_support = cluster.get_reference_support();
+    record.set_format(genotyped ? "GT:DR:DV" : "DV");
+    for (size_t sample_id = 0; sample_id < number_of_samples; ++sample_id)
+    {
+        if (!genotyped)
+        {
+            record.add_sample(std::to_string(variant_support[sample_id]));
+            continue;
+        }
+        size_t const sample_reference_support = (sample_id < reference_support.size()) ? reference_support[sample_id]
+                                                                                         : 0;
+        record.add_sample(genotype(sample_reference_support, variant_support[sample_id]) + ":" +
+                          std::to_string(sample_reference_support) + ":" +
+                          std::to_string(variant_support[sample_id]));
+    }
+}
+
+/*! \brief Prints the variant of a junction cluster in VCF format, if it is a deletion or an insertion within the length
+ *         limits.
+ */
+static void output_variant(Cluster const & cluster,
+                           cmd_arguments const & args,
+                           size_t const number_of_samples,
+                           bool const has_sample_columns,
+                           IndexedFasta const * reference,
+                           std::ostream & out_stream)
+{
+    Breakend mate1 = cluster.get_refined_mate1();
+    Breakend mate2 = cluster.get_refined_mate2();
+    // Members of downsampled regions count for all reads they stand for.
+    size_t cluster_size = cluster.get_estimated_support();
+    if (mate1.orientation == mate2.orientation)
+    {
+        if (mate1.seq_name == mate2.seq_name)
+        {
+            int32_t mate1_pos = mate1.position;
+            int32_t mate2_pos = mate2.position;
+            int32_t insert_size = cluster.get_refined_inserted_sequence_size();
+            if (mate1.orientation == strand::forward)
+            {
+                int32_t distance = mate2_pos - mate1_pos;
+                //Deletion
+                if (distance >= args.min_var_length &&
+                    distance <= args.max_var_length &&
+                    insert_size <= args.max_tol_inserted_length)
+                {
+                    variant_record tmp{};
+                    tmp.set_chrom(mate1.seq_name);
+                    tmp.set_ref(reference_base(reference, mate1));
+                    tmp.set_qual(cluster_size);
+                    tmp.set_alt("<DEL>");
+                    tmp.add_info("SVTYPE", "DEL");
+                    // Increment position by 1 because VCF is 1-based
+                    tmp.set_pos(mate1_pos + 1);
+                    tmp.add_info("SVLEN", std::to_string(-distance + 1));
+                    // Increment end by 1 because VCF is 1-based
+                    // Decrement end by 1 because deletion ends one base before mate2 begins
+                    tmp.add_info("END", std::to_string(mate2_pos));
+                    if (has_sample_columns)
+                        add_samples(tmp, cluster, number_of_samples, args.genotype);
+                    tmp.print(out_stream);
+                }
+                //Insertion
+                else if (distance == 1 &&
+                         insert_size >= args.min_var_length)
+                {
+                    variant_record tmp{};
+                    std::string const ref = reference_base(reference, mate1);
+                    tmp.set_chrom(mate1.seq_name);
+                    tmp.set_ref(ref);
+                    tmp.set_qual(cluster_size);
+                    // If the inserted sequence is known, ALT is the base before the insertion followed by it.
+                    std::optional<seqan3::dna5_vector> const & inserted_sequence
+                        = cluster.get_refined_inserted_sequence();
+                    if (inserted_sequence)
+                        tmp.set_alt(ref + (*inserted_sequence | seqan3::views::to_char
+                                                              | seqan3::views::to<std::string>));
+                    else
+                        tmp.set_alt("<INS>");
+                    tmp.add_info("SVTYPE", "INS");
+                    // Increment position by 1 because VCF is 1-based
+                    tmp.set_pos(mate1_pos + 1);
+                    tmp.add_info("SVLEN", std::to_string(insert_size));
+                    // Increment end by 1 because VCF is 1-based
+                    tmp.add_info("END", std::to_string(mate1_pos + 1));
+                    if (has_sample_columns)
+                        add_samples(tmp, cluster, number_of_samples, args.genotype);
+                    tmp.print(out_stream);
+                }
+            }
+        }
+    }
+}
 
 void find_and_output_variants(std::vector<Cluster> const & clusters,
                               cmd_arguments const & args,
-                              std::ostream & out_stream)
+                              std::ostream & out_stream,
+                              IndexedFasta const * reference)
 {
     variant_header header{};
     header.set_fileformat("VCFv4.3");
     header.add_meta_info("SVTYPE", 1, "String", "Type of SV called.", "iGenVarCaller", "1.0");
     header.add_meta_info("SVLEN", 1, "Integer", "Length of SV called.", "iGenVarCaller", "1.0");
     header.add_meta_info("END", 1, "Integer", "End position of SV called.", "iGenVarCaller", "1.0");
+    // A single sample only gets a column if it is genotyped.
+    std::vector<AlignmentSample> const samples = get_samples(args);
+    bool const has_sample_columns = args.genotype || samples.size() > 1;
+    if (has_sample_columns)
+    {
+        if (args.genotype)
+        {
+            header.add_format_info("GT", 1, "String", "Genotype");
+            header.add_format_info("DR", 1, "Integer", "Number of reads supporting the reference");
+        }
+        header.add_format_info("DV", 1, "Integer", "Number of reads supporting the variant");
+        for (AlignmentSample const & sample : samples)
+            header.add_sample(sample.name);
+    }
     header.print(out_stream);
-    for (size_t i = 0; i < clusters.size(); ++i)
+
+    // The records of consecutive ranges of clusters are formatted in parallel into private buffers. A buffer is
+    // committed to the stream by the thread that completes the sequence of buffers before it, so the output is the
+    // same as with a single thread.
+    size_t const clusters_per_range = 1024;
+    size_t const number_of_ranges = (clusters.size() + clusters_per_range - 1) / clusters_per_range;
+    std::atomic<size_t> next_range{0};
+    std::mutex commit_mutex{};
+    std::map<size_t, std::string> formatted_ranges{};
+    size_t next_commit = 0;
+    auto format_ranges = [&] ()
     {
-        Breakend mate1 = clusters[i].get_average_mate1();
-        Breakend mate2 = clusters[i].get_average_mate2();
-        size_t cluster_size = clusters[i].get_cluster_size();
-        if (mate1.orientation == mate2.orientation)
+        for (size_t range = next_range++; range < number_of_ranges; range = next_range++)
         {
-            if (mate1.seq_name == mate2.seq_name)
+            std::ostringstream buffer{};
+            size_t const range_end = std::min(clusters.size(), (range + 1) * clusters_per_range);
+            for (size_t i = range * clusters_per_range; i < range_end; ++i)
+                output_variant(clusters[i], args, samples.size(), has_sample_columns, reference, buffer);
+
+            std::lock_guard<std::mutex> lock{commit_mutex};
+            formatted_ranges.emplace(range, buffer.str());
+            for (auto next = formatted_ranges.begin();
+                 next != formatted_ranges.end() && next->first == next_commit;
+                 next = formatted_ranges.erase(next), ++next_commit)
             {
-                int32_t mate1_pos = mate1.position;
-                int32_t mate2_pos = mate2.position;
-                int32_t insert_size = clusters[i].get_average_inserted_sequence_size();
-                if (mate1.orientation == strand::forward)
-                {
-                    int32_t distance = mate2_pos - mate1_pos;
-                    //Deletion
-                    if (distance >= args.min_var_length &&
-                        distance <= args.max_var_length &&
-                        insert_size <= args.max_tol_inserted_length)
-                    {
-                        variant_record tmp{};
-                        tmp.set_chrom(mate1.seq_name);
-                        tmp.set_qual(cluster_size);
-                        tmp.set_alt("<DEL>");
-                        tmp.add_info("SVTYPE", "DEL");
-                        // Increment position by 1 because VCF is 1-based
-                        tmp.set_pos(mate1_pos + 1);
-                        tmp.add_info("SVLEN", std::to_string(-distance + 1));
-                        // Increment end by 1 because VCF is 1-based
-                        // Decrement end by 1 because deletion ends one base before mate2 begins
-                        tmp.add_info("END", std::to_string(mate2_pos));
-                        tmp.print(out_stream);
-                    }
-                    //Insertion
-                    else if (distance == 1 &&
-                             insert_size >= args.min_var_length)
-                    {
-                        variant_record tmp{};
-                        tmp.set_chrom(mate1.seq_name);
-                        tmp.set_qual(cluster_size);
-                        tmp.set_alt("<INS>");
-                        tmp.add_info("SVTYPE", "INS");
-                        // Increment position by 1 because VCF is 1-based
-                        tmp.set_pos(mate1_pos + 1);
-                        tmp.add_info("SVLEN", std::to_string(insert_size));
-                        // Increment end by 1 because VCF is 1-based
-                        tmp.add_info("END", std::to_string(mate1_pos + 1));
-                        tmp.print(out_stream);
-                    }
-                }
+                out_stream << next->second;
             }
         }
-    }
+    };
+    std::vector<std::thread> workers{};
+    for (uint16_t thread = 1; thread < std::min<size_t>(args.threads, number_of_ranges); ++thread)
+        workers.emplace_back(format_ranges);
+    format_ranges();
+    for (std::thread & worker : workers)
+        worker.join();
 }
 
 //!\overload
 void find_and_output_variants(std::vector<Cluster> const & clusters,
                               cmd_arguments const & args,
-                              std::filesystem::path const & output_file_path)
+                              std::filesystem::path const & output_file_path,
+                              IndexedFasta const * reference)
 {
     if (output_file_path.empty())
     {
-        find_and_output_variants(clusters, args, std::cout);
+        find_and_output_variants(clusters, args, std::cout, reference);
     }
     else
     {
@@ -86,7 +214,7 @@ void find_and_output_variants(std::vector<Cluster> const & clusters,
         {
             throw std::runtime_error{"Could not open file '" + output_file_path.string() + "' for reading."};
         }
-        find_and_output_variants(clusters, args, out_file);
+        find_and_output_variants(clusters, args, out_file, reference);
         out_file.close();
     }
 }
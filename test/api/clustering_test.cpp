@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
 #include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
 #include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
 #include "structures/cluster.hpp"                                   // for class Cluster
+#include "structures/work_stealing_scheduler.hpp"                   // for class WorkStealingScheduler
 
 using seqan3::operator""_dna5;
 
@@ -380,3 +386,160 @@ TEST(clustering, clustering_25)
         }
     }
 }
+
+TEST(clustering, joint_samples)
+{
+    // The same junction is found in the reads of two samples and clustered jointly.
+    std::vector<Junction> input_junctions
+    {
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_1},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_2},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_3},
+        Junction{Breakend{chrom1, chrom1_position2, strand::forward},
+                 Breakend{chrom1, chrom1_position3, strand::forward}, ""_dna5, read_name_4}
+    };
+    input_junctions[1].set_sample_id(1);
+    input_junctions[2].set_sample_id(1);
+    EXPECT_EQ(input_junctions[0].get_sample_id(), 0u);
+    EXPECT_EQ(input_junctions[1].get_sample_id(), 1u);
+    // The sample does not change the identity of a junction.
+    EXPECT_EQ(input_junctions[0], input_junctions[1]);
+
+    std::sort(input_junctions.begin(), input_junctions.end());
+    std::vector<Cluster> clusters = simple_clustering_method(input_junctions);
+
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0].get_variant_support(2), (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(clusters[1].get_variant_support(2), (std::vector<size_t>{1, 0}));
+    EXPECT_TRUE(clusters[0].get_reference_support().empty());
+
+    clusters[0].set_reference_support({4, 0});
+    EXPECT_EQ(clusters[0].get_reference_support(), (std::vector<size_t>{4, 0}));
+}
+
+TEST(clustering, downsampled_support)
+{
+    // Each junction of a region downsampled to a quarter stands for four reads.
+    std::vector<Junction> members
+    {
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_1},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_2},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                 Breakend{chrom1, chrom1_position2, strand::forward}, ""_dna5, read_name_3}
+    };
+    members[0].set_sampling_rate(0.25);
+    members[1].set_sampling_rate(0.25);
+    members[2].set_sample_id(1);
+    EXPECT_EQ(members[2].get_sampling_rate(), 1.0);
+
+    Cluster const cluster{members};
+    EXPECT_EQ(cluster.get_cluster_size(), 3u);
+    EXPECT_EQ(cluster.get_estimated_support(), 9u);
+    EXPECT_EQ(cluster.get_variant_support(2), (std::vector<size_t>{8, 1}));
+}
+
+TEST(clustering, work_stealing_scheduler)
+{
+    // The first task takes much longer than the others, so the other workers have to steal its queue.
+    size_t const number_of_tasks = 64;
+    std::vector<std::atomic<size_t>> runs(number_of_tasks);
+    std::vector<uint16_t> workers(number_of_tasks);
+    WorkStealingScheduler const scheduler{4};
+    scheduler.run(number_of_tasks, [&] (size_t const task_id, uint16_t const worker_id)
+    {
+        if (task_id == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ++runs[task_id];
+        workers[task_id] = worker_id;
+    });
+    for (size_t task_id = 0; task_id < number_of_tasks; ++task_id)
+    {
+        EXPECT_EQ(runs[task_id].load(), 1u) << "Task " << task_id;
+        EXPECT_LT(workers[task_id], 4u);
+    }
+    // The tasks dealt to the first worker after the long one are stolen by the others.
+    EXPECT_NE(workers[number_of_tasks - 4], 0u);
+
+    // Exceptions of tasks are rethrown.
+    EXPECT_THROW(scheduler.run(number_of_tasks, [] (size_t const task_id, uint16_t)
+    {
+        if (task_id == 7)
+            throw std::runtime_error{"task failed"};
+    }), std::runtime_error);
+}
+
+TEST(clustering, hierarchical_clustering_threads)
+{
+    // The partitions are clustered in parallel with the same result.
+    std::vector<Junction> input_junctions = prepare_input_junctions();
+    std::vector<Cluster> const clusters = hierarchical_clustering_method(input_junctions, 10);
+    std::vector<Cluster> const clusters_parallel = hierarchical_clustering_method(input_junctions, 10, 4);
+
+    ASSERT_EQ(clusters.size(), clusters_parallel.size());
+    for (size_t cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
+    {
+        EXPECT_TRUE(clusters[cluster_index] == clusters_parallel[cluster_index]) << "Cluster " << cluster_index
+                                                                                 << " unequal";
+    }
+}
+
+TEST(clustering, merged_junctions)
+{
+    // Four reads give the same junction, the other two are 5 bp and 12 bp away from it.
+    Breakend const mate2{chrom1, chrom1_position2, strand::forward};
+    std::vector<Junction> junctions
+    {
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward}, mate2, ""_dna5, read_name_1},
+        Junction{Breakend{chrom1, chrom1_position1 + 12, strand::forward}, mate2, ""_dna5, read_name_2},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward}, mate2, ""_dna5, read_name_3},
+        Junction{Breakend{chrom1, chrom1_position1 + 5, strand::forward}, mate2, ""_dna5, read_name_4},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward}, mate2, ""_dna5, read_name_5},
+        Junction{Breakend{chrom1, chrom1_position1, strand::forward}, mate2, ""_dna5, read_name_6}
+    };
+    std::vector<Junction> merged_junctions = junctions;
+    merged_junctions.push_back(Junction{Breakend{chrom1, chrom1_position1, strand::forward},
+                                        mate2, ""_dna5, read_name_7});
+    merged_junctions.back().set_sample_id(1);
+    merge_identical_junctions(merged_junctions);
+
+    // Junctions of another sample are not merged.
+    ASSERT_EQ(merged_junctions.size(), 4u);
+    EXPECT_EQ(merged_junctions[0].get_weight(), 4u);
+    EXPECT_EQ(merged_junctions[0].get_read_names(),
+              (std::vector<std::string>{read_name_1, read_name_3, read_name_5, read_name_6}));
+    EXPECT_EQ(merged_junctions[1].get_weight(), 1u);
+    EXPECT_EQ(merged_junctions[1].get_sample_id(), 1u);
+    EXPECT_EQ(merged_junctions[2].get_read_names(), (std::vector<std::string>{read_name_4}));
+    merged_junctions.erase(merged_junctions.begin() + 1);
+    std::sort(junctions.begin(), junctions.end());
+
+    // The average distance of the far junction to the five reads of the other two is 11, so it is not clustered with
+    // them. Without the weights, it would be clustered at an average distance of 9.5 to the two junctions.
+    for (uint16_t threads : {1, 2})
+    {
+        std::vector<Cluster> const clusters = hierarchical_clustering_method(junctions, 10, threads);
+        std::vector<Cluster> const merged_clusters = hierarchical_clustering_method(merged_junctions, 10, threads);
+        ASSERT_EQ(clusters.size(), 2u);
+        ASSERT_EQ(merged_clusters.size(), 2u);
+        for (size_t cluster_index = 0; cluster_index < clusters.size(); ++cluster_index)
+        {
+            EXPECT_EQ(clusters[cluster_index].get_cluster_size(), merged_clusters[cluster_index].get_cluster_size());
+            EXPECT_EQ(clusters[cluster_index].get_average_mate1(), merged_clusters[cluster_index].get_average_mate1());
+            EXPECT_EQ(clusters[cluster_index].get_estimated_support(),
+                      merged_clusters[cluster_index].get_estimated_support());
+        }
+        EXPECT_EQ(merged_clusters[0].get_members().size(), 2u);
+        EXPECT_EQ(merged_clusters[0].get_cluster_size(), 5u);
+        EXPECT_EQ(merged_clusters[0].get_average_mate1(), (Breakend{chrom1, chrom1_position1 + 1, strand::forward}));
+    }
+
+    // The simple clustering method gives one cluster per merged junction.
+    std::vector<Cluster> const simple_clusters = simple_clustering_method(merged_junctions);
+    ASSERT_EQ(simple_clusters.size(), 3u);
+    EXPECT_EQ(simple_clusters[0].get_cluster_size(), 4u);
+}
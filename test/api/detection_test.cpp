@@ -1,10 +1,22 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <thread>
+
 #include <seqan3/alphabet/cigar/cigar.hpp>
 #include <seqan3/io/sam_file/sam_flag.hpp>
 
+#include "legacy_sa_tag_parser.hpp"                                 // for retrieve_aligned_segments_legacy()
 #include "modules/sv_detection_methods/analyze_cigar_method.hpp"    // for the split read method
+#include "modules/sv_detection_methods/analyze_read_depth_method.hpp"// for the read depth method
+#include "modules/sv_detection_methods/analyze_read_pair_method.hpp"// for the read pair method
 #include "modules/sv_detection_methods/analyze_sa_tag_method.hpp"   // for the cigar string method
+#include "modules/sv_detection_methods/analyze_soft_clip_method.hpp"// for the soft clip method
+#include "structures/bounded_queue.hpp"                             // for class BoundedQueue
+#include "structures/depth_capped_sampler.hpp"                      // for class DepthCappedSampler
+#include "structures/quantile_sketch.hpp"                           // for class QuantileSketch
 
 using seqan3::operator""_cigar_operation;
 using seqan3::operator""_dna5;
@@ -209,6 +221,48 @@ TEST(junction_detection, retrieve_aligned_segments)
     }
 }
 
+TEST(junction_detection, aligned_segment_coordinates)
+{
+    // Soft clips are separated from the aligned part by hard clips and deletions: 5S3D2S10M4I6M2D5S1H
+    std::vector<seqan3::cigar> const cigar{{5, 'S'_cigar_operation}, {3, 'D'_cigar_operation},
+                                           {2, 'S'_cigar_operation}, {10, 'M'_cigar_operation},
+                                           {4, 'I'_cigar_operation}, {6, 'M'_cigar_operation},
+                                           {2, 'D'_cigar_operation}, {5, 'S'_cigar_operation},
+                                           {1, 'H'_cigar_operation}};
+    AlignedSegment const forward_segment{strand::forward, "chr1", 100, 60, cigar};
+    EXPECT_EQ(forward_segment.get_reference_start(), 100);
+    EXPECT_EQ(forward_segment.get_reference_end(), 121);
+    EXPECT_EQ(forward_segment.get_left_soft_clip(), 7);
+    EXPECT_EQ(forward_segment.get_right_soft_clip(), 5);
+    EXPECT_EQ(forward_segment.get_query_length(), 32);
+    EXPECT_EQ(forward_segment.get_query_start(), 7);
+    EXPECT_EQ(forward_segment.get_query_end(), 27);
+
+    AlignedSegment const reverse_segment{strand::reverse, "chr1", 100, 60, cigar};
+    EXPECT_EQ(reverse_segment.get_query_start(), 5);
+    EXPECT_EQ(reverse_segment.get_query_end(), 25);
+
+    // A segment of soft clips only
+    AlignedSegment const clipped_segment{strand::forward, "chr1", 100, 60, {{5, 'S'_cigar_operation}}};
+    EXPECT_EQ(clipped_segment.get_reference_end(), 100);
+    EXPECT_EQ(clipped_segment.get_left_soft_clip(), 5);
+    EXPECT_EQ(clipped_segment.get_right_soft_clip(), 5);
+
+    // Segments with the same spans but other CIGAR strings are unequal: 10M5I5M and 5M5I10M
+    AlignedSegment const insertion_segment{strand::forward, "chr1", 100, 60, {{10, 'M'_cigar_operation},
+                                                                              {5, 'I'_cigar_operation},
+                                                                              {5, 'M'_cigar_operation}}};
+    AlignedSegment const other_insertion_segment{strand::forward, "chr1", 100, 60, {{5, 'M'_cigar_operation},
+                                                                                    {5, 'I'_cigar_operation},
+                                                                                    {10, 'M'_cigar_operation}}};
+    EXPECT_EQ(insertion_segment.get_reference_end(), other_insertion_segment.get_reference_end());
+    EXPECT_EQ(insertion_segment.get_query_length(), other_insertion_segment.get_query_length());
+    EXPECT_FALSE(insertion_segment == other_insertion_segment);
+    EXPECT_TRUE(insertion_segment == (AlignedSegment{strand::forward, "chr1", 100, 60, {{10, 'M'_cigar_operation},
+                                                                                        {5, 'I'_cigar_operation},
+                                                                                        {5, 'M'_cigar_operation}}}));
+}
+
 TEST(junction_detection, analyze_aligned_segments)
 {
     AlignedSegment aligned_segment1 {strand::forward, "chr1", 100, 60, std::vector<seqan3::cigar>{{6, 'M'_cigar_operation},
@@ -315,26 +369,432 @@ TEST(junction_detection, analyze_sa_tag)
     }
 }
 
-// TODO (irallia): these tests should be implemented when the associated detection methods are implemented
+// Generates SA tags with valid and malformed elements: missing and additional fields, invalid strands, empty elements
+// and missing or additional delimiters.
+std::string generate_fuzzed_sa_tag(std::mt19937 & generator)
+{
+    std::uniform_int_distribution<int> number_of_segments_distribution{0, 12};
+    std::uniform_int_distribution<int> kind_distribution{0, 9};
+    std::uniform_int_distribution<int> number_distribution{0, 1'000'000};
+    std::uniform_int_distribution<int> cigar_length_distribution{1, 8};
+    std::uniform_int_distribution<int> operation_distribution{0, 8};
+    std::string const operations{"MIDNSHP=X"};
+
+    std::string sa_tag{};
+    int const number_of_segments = number_of_segments_distribution(generator);
+    for (int i = 0; i < number_of_segments; ++i)
+    {
+        std::string cigar{};
+        for (int j = cigar_length_distribution(generator); j > 0; --j)
+            cigar += std::to_string(number_distribution(generator) % 5000 + 1) + operations[operation_distribution(generator)];
+
+        std::string const strand_field = (number_distribution(generator) % 2 == 0) ? "+" : "-";
+        std::string const ref_name = "chr" + std::to_string(number_distribution(generator) % 25);
+        std::string const pos = std::to_string(number_distribution(generator));
+        std::string const mapq = std::to_string(number_distribution(generator) % 61);
+        switch (kind_distribution(generator))
+        {
+            case 0: // missing field
+                sa_tag += ref_name + "," + pos + "," + strand_field + "," + cigar + "," + mapq;
+                break;
+            case 1: // additional field
+                sa_tag += ref_name + "," + pos + "," + strand_field + "," + cigar + "," + mapq + ",0,1";
+                break;
+            case 2: // invalid strand
+                sa_tag += ref_name + "," + pos + ",*," + cigar + "," + mapq + ",0";
+                break;
+            case 3: // empty element
+                break;
+            case 4: // trailing delimiter of the last field
+                sa_tag += ref_name + "," + pos + "," + strand_field + "," + cigar + "," + mapq + ",0,";
+                break;
+            default:
+                sa_tag += ref_name + "," + pos + "," + strand_field + "," + cigar + "," + mapq + ",0";
+                break;
+        }
+        if (i + 1 < number_of_segments || number_distribution(generator) % 2 == 0)
+            sa_tag += ";";
+    }
+    return sa_tag;
+}
+
+TEST(junction_detection, retrieve_aligned_segments_equivalence)
+{
+    testing::internal::CaptureStderr();
+    std::mt19937 generator{42};
+    for (size_t i = 0; i < 10'000; ++i)
+    {
+        std::string const sa_tag = generate_fuzzed_sa_tag(generator);
+
+        // Segments are appended to the existing ones.
+        AlignedSegment const primary{strand::forward, "chr1", 100, 60, std::vector<seqan3::cigar>{{50, 'M'_cigar_operation}}};
+        std::vector<AlignedSegment> segments_res{primary};
+        std::vector<AlignedSegment> segments_expected_res{primary};
+        retrieve_aligned_segments(sa_tag, segments_res);
+        retrieve_aligned_segments_legacy(sa_tag, segments_expected_res);
+
+        ASSERT_EQ(segments_expected_res.size(), segments_res.size()) << "SA tag: " << sa_tag;
+        for (size_t j = 0; j < segments_expected_res.size(); ++j)
+            EXPECT_TRUE(segments_expected_res[j] == segments_res[j]) << "SA tag: " << sa_tag << ", segment " << j;
+    }
+    testing::internal::GetCapturedStderr();
+}
+
+TEST(junction_detection, retrieve_aligned_segments_corrupted)
+{
+    // The legacy parser threw on some of these and ignored trailing characters of numbers; corrupted elements are
+    // now reported and skipped.
+    std::string const sa_tag = "chr1,abc,+,10M,60,0;chr1,100,+,10M,6x,0;chr1,100,+,10M5,60,0;chr1,100,+,M,60,0;"
+                               "chr1,200,-,5S10M,60,0;";
+    std::vector<AlignedSegment> segments_res{};
+    testing::internal::CaptureStderr();
+    retrieve_aligned_segments(sa_tag, segments_res);
+    testing::internal::GetCapturedStderr();
+
+    AlignedSegment const expected{strand::reverse, "chr1", 200, 60, std::vector<seqan3::cigar>{{5, 'S'_cigar_operation},
+                                                                                               {10, 'M'_cigar_operation}}};
+    ASSERT_EQ(segments_res.size(), 1u);
+    EXPECT_TRUE(segments_res[0] == expected);
+}
+
+TEST(junction_detection, analyze_sa_tag_reuses_segments)
+{
+    // The segments of a read with many supplementary alignments must not leak into the following read.
+    std::string const read_name = "read021";
+    std::vector<seqan3::cigar> cigar_string = {{10, 'S'_cigar_operation}, {14, 'M'_cigar_operation}, {26, 'S'_cigar_operation}};
+    seqan3::dna5_vector seq = {"GGGCTCATCGATCGATTTCGGATCGGGGGGCCCCCATTTTAAACGGCCCC"_dna5};
+    std::vector<Junction> junctions_res{};
+    analyze_sa_tag(read_name, seqan3::sam_flag{16u}, "chr1", 116, 60, cigar_string, seq,
+                   "chr1,100,+,6M44S,60,0;chr2,100,+,6S10M34S,60,0;chr1,106,+,16S10M24S,60,0;"
+                   "chr1,130,+,40S4M6S,60,0;chr1,150,+,44S6M,60,0;", junctions_res);
+    ASSERT_EQ(junctions_res.size(), 5u);
+
+    junctions_res.clear();
+    analyze_sa_tag(read_name, seqan3::sam_flag{0u}, "chr1", 130, 60, {{40, 'S'_cigar_operation}, {4, 'M'_cigar_operation},
+                   {6, 'S'_cigar_operation}}, seq, "chr1,150,+,44S6M,60,0;", junctions_res);
+    std::vector<Junction> junctions_expected_res{Junction{Breakend{"chr1", 134, strand::forward},
+                                                          Breakend{"chr1", 150, strand::forward},
+                                                          ""_dna5,
+                                                          read_name}};
+    ASSERT_EQ(junctions_res.size(), 1u);
+    EXPECT_TRUE(junctions_expected_res[0] == junctions_res[0]);
+}
 
-// TEST(junction_detection, read_pairs_method_simple)
-// {
-//     testing::internal::CaptureStdout();
+TEST(junction_detection, insert_size_quantile_sketch)
+{
+    QuantileSketch sketch{0.01};
+    EXPECT_EQ(sketch.quantile(0.5), 0u);
 
-//     std::vector<Junction> resulting_junctions{};
-//     analyze_read_pairs();
+    std::mt19937 generator{42};
+    std::normal_distribution<double> insert_size_distribution{400.0, 50.0};
+    std::vector<uint64_t> insert_sizes{};
+    for (size_t i = 0; i < 100'000; ++i)
+    {
+        insert_sizes.push_back(std::max<int64_t>(0, std::llround(insert_size_distribution(generator))));
+        sketch.add(insert_sizes.back());
+    }
+    std::sort(insert_sizes.begin(), insert_sizes.end());
+    EXPECT_EQ(sketch.size(), insert_sizes.size());
 
-//     std::vector<Junction> expected_junctions{};
-//     EXPECT_EQ(expected_junctions, resulting_junctions);
-// }
+    for (double const q : {0.01, 0.25, 0.5, 0.75, 0.99})
+    {
+        double const exact = insert_sizes[static_cast<size_t>(q * (insert_sizes.size() - 1))];
+        EXPECT_NEAR(static_cast<double>(sketch.quantile(q)), exact, 0.01 * exact + 1) << "quantile " << q;
+    }
+    // The memory does not depend on the number of values.
+    EXPECT_LT(sketch.memory_usage(), 8'192u);
+}
 
-// TEST(junction_detection, read_depth_method_simple)
-// {
-//     testing::internal::CaptureStdout();
+TEST(junction_detection, read_pairs_method_simple)
+{
+    std::vector<seqan3::cigar> const cigar{{50, 'M'_cigar_operation}};
+    auto segment = [&cigar] (std::string const & chromosome, int32_t const pos, strand const orientation)
+    {
+        return AlignedSegment{orientation, chromosome, pos, 60, cigar};
+    };
 
-//     std::vector<Junction> resulting_junctions{};
-//     analyze_read_depth();
+    ReadPairDetector detector{1000};
+    std::vector<Junction> junctions_res{};
+    // concordant pair, never cached
+    detector.add_alignment("pair1", "", segment("chr1", 100, strand::forward),
+                           0, 0, 400, strand::reverse, 0, false, junctions_res);
+    EXPECT_EQ(detector.get_cache_size(), 0u);
+    // deletion: distance larger than the maximum insert size
+    detector.add_alignment("pair2", "", segment("chr1", 200, strand::forward),
+                           0, 0, 5200, strand::reverse, 0, false, junctions_res);
+    // inversion: both mates on the forward strand
+    detector.add_alignment("pair3", "", segment("chr1", 300, strand::forward),
+                           0, 0, 600, strand::forward, 0, false, junctions_res);
+    // the mate of this read is filtered and never arrives
+    detector.add_alignment("pair4", "", segment("chr1", 350, strand::forward),
+                           0, 0, 500, strand::forward, 0, false, junctions_res);
+    detector.add_alignment("pair1", "", segment("chr1", 400, strand::reverse),
+                           0, 0, 100, strand::forward, 0, false, junctions_res);
+    EXPECT_EQ(detector.get_cache_size(), 3u);
+    detector.add_alignment("pair3", "", segment("chr1", 600, strand::forward),
+                           0, 0, 300, strand::forward, 0, false, junctions_res);
+    // translocation: mate on the next chromosome
+    detector.add_alignment("pair5", "", segment("chr1", 700, strand::reverse),
+                           0, 1, 100, strand::forward, 0, false, junctions_res);
+    detector.add_alignment("pair2", "", segment("chr1", 5200, strand::reverse),
+                           0, 0, 200, strand::forward, 0, false, junctions_res);
+    EXPECT_EQ(detector.get_number_of_evicted_reads(), 1u);
+    detector.add_alignment("pair5", "", segment("chr2", 100, strand::forward),
+                           1, 0, 700, strand::reverse, 0, false, junctions_res);
+    EXPECT_EQ(detector.get_cache_size(), 0u);
+
+    std::vector<Junction> junctions_expected_res{Junction{Breakend{"chr1", 350, strand::forward},
+                                                          Breakend{"chr1", 650, strand::reverse},
+                                                          ""_dna5, "pair3"},
+                                                 Junction{Breakend{"chr1", 250, strand::forward},
+                                                          Breakend{"chr1", 5200, strand::forward},
+                                                          ""_dna5, "pair2"},
+                                                 Junction{Breakend{"chr1", 700, strand::reverse},
+                                                          Breakend{"chr2", 150, strand::reverse},
+                                                          ""_dna5, "pair5"}};
+    ASSERT_EQ(junctions_expected_res.size(), junctions_res.size());
+    for (size_t i = 0; i < junctions_expected_res.size(); ++i)
+    {
+        EXPECT_EQ(junctions_expected_res[i].get_read_name(), junctions_res[i].get_read_name());
+        EXPECT_TRUE(junctions_expected_res[i] == junctions_res[i]) << "Junction " << i << " unequal";
+    }
+}
 
-//     std::vector<Junction> expected_junctions{};
-//     EXPECT_EQ(expected_junctions, resulting_junctions);
-// }
+TEST(junction_detection, read_pairs_method_bounded_cache)
+{
+    std::vector<seqan3::cigar> const cigar{{50, 'M'_cigar_operation}};
+    ReadPairDetector detector{1000, 10'000, 2};
+    std::vector<Junction> junctions_res{};
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        detector.add_alignment("pair" + std::to_string(i), "", AlignedSegment{strand::forward, "chr1", i, 60, cigar},
+                               0, 1, 100, strand::reverse, 0, false, junctions_res);
+    }
+    EXPECT_EQ(detector.get_cache_size(), 2u);
+    EXPECT_EQ(detector.get_number_of_dropped_reads(), 2u);
+    EXPECT_TRUE(junctions_res.empty());
+}
+
+TEST(junction_detection, read_pairs_method_sampling_rate)
+{
+    std::vector<seqan3::cigar> const cigar{{50, 'M'_cigar_operation}};
+    ReadPairDetector detector{1000};
+    std::vector<Junction> junctions_res{};
+
+    EXPECT_FALSE(detector.has_pending_mate("pair1"));
+    detector.add_alignment("pair1", "", AlignedSegment{strand::forward, "chr1", 100, 60, cigar},
+                           0, 0, 5100, strand::reverse, 0, false, junctions_res, 0.25);
+    EXPECT_TRUE(detector.has_pending_mate("pair1"));
+    // The junction gets the sampling rate of the first read, not the one of its mate.
+    detector.add_alignment("pair1", "", AlignedSegment{strand::reverse, "chr1", 5100, 60, cigar},
+                           0, 0, 100, strand::forward, 0, false, junctions_res, 1.0);
+    EXPECT_FALSE(detector.has_pending_mate("pair1"));
+    ASSERT_EQ(junctions_res.size(), 1u);
+    EXPECT_EQ(junctions_res[0].get_sampling_rate(), 0.25);
+}
+
+TEST(junction_detection, read_pairs_method_learned_insert_size)
+{
+    std::vector<seqan3::cigar> const cigar{{50, 'M'_cigar_operation}};
+    ReadPairDetector detector{1000, 201};
+    std::vector<Junction> junctions_res{};
+
+    // Concordant pairs of read group "lib1" with template lengths 300 to 500 bp.
+    for (int32_t i = 0; i < 201; ++i)
+    {
+        int32_t const template_length = 300 + i;
+        detector.add_alignment("pair" + std::to_string(i), "lib1",
+                               AlignedSegment{strand::forward, "chr1", i, 60, cigar},
+                               0, 0, i + template_length - 50, strand::reverse, template_length, true,
+                               junctions_res);
+        if (i + 1 < 201) // warm-up
+            EXPECT_EQ(detector.get_max_insert_size("lib1"), 1000u);
+    }
+    // Pairs that are not properly aligned are not learned.
+    detector.add_alignment("improper", "lib1", AlignedSegment{strand::forward, "chr1", 250, 60, cigar},
+                           0, 0, 5250, strand::reverse, 5050, false, junctions_res);
+    ASSERT_NE(detector.get_insert_sizes("lib1"), nullptr);
+    EXPECT_EQ(detector.get_insert_sizes("lib1")->size(), 201u);
+    EXPECT_EQ(detector.get_insert_sizes("lib2"), nullptr);
+
+    // Q1 = 350, Q3 = 450, IQR = 100: the maximum insert size is about 750 bp (with the 1% error of the sketch).
+    EXPECT_NEAR(static_cast<double>(detector.get_max_insert_size("lib1")), 750.0, 40.0);
+    EXPECT_EQ(detector.get_max_insert_size("lib2"), 1000u);
+    EXPECT_TRUE(junctions_res.empty());
+
+    // A pair with a distance of 900 bp is discordant for "lib1", but not for a read group in its warm-up.
+    detector.add_alignment("long1", "lib1", AlignedSegment{strand::forward, "chr1", 1000, 60, cigar},
+                           0, 0, 1850, strand::reverse, 900, true, junctions_res);
+    detector.add_alignment("long2", "lib2", AlignedSegment{strand::forward, "chr1", 1000, 60, cigar},
+                           0, 0, 1850, strand::reverse, 900, true, junctions_res);
+    detector.add_alignment("long1", "lib1", AlignedSegment{strand::reverse, "chr1", 1850, 60, cigar},
+                           0, 0, 1000, strand::forward, -900, true, junctions_res);
+    detector.add_alignment("long2", "lib2", AlignedSegment{strand::reverse, "chr1", 1850, 60, cigar},
+                           0, 0, 1000, strand::forward, -900, true, junctions_res);
+    ASSERT_EQ(junctions_res.size(), 1u);
+    EXPECT_EQ(junctions_res[0].get_read_name(), "long1");
+}
+
+TEST(junction_detection, read_depth_method_bin_depths)
+{
+    std::vector<Junction> junctions_res{};
+    ReadDepthDetector detector{100};
+
+    // An alignment covers 50 bases of bin 1, bins 2 and 3 completely and 20 bases of bin 4.
+    detector.add_alignment(0, "chr1", 150, 420, junctions_res);
+    detector.add_alignment(0, "chr1", 210, 230, junctions_res);
+    detector.finish(junctions_res);
+
+    std::vector<uint32_t> expected_depths{0, 50, 120, 100, 20};
+    EXPECT_EQ(detector.get_bin_depths(), expected_depths);
+    EXPECT_TRUE(junctions_res.empty());
+}
+
+TEST(junction_detection, read_depth_method_simple)
+{
+    std::vector<Junction> junctions_res{};
+    ReadDepthDetector detector{100};
+
+    // 20x coverage on 20,000 bins of chr1, with a deletion of bins [5000, 5010) and a duplication of bins
+    // [12000, 12005), which is not reported. The bins are resolved in chunks while streaming.
+    testing::internal::CaptureStderr();
+    for (int32_t bin = 0; bin < 20'000; ++bin)
+    {
+        int32_t const depth = (bin >= 5000 && bin < 5010) ? 0 : ((bin >= 12'000 && bin < 12'005) ? 40 : 20);
+        for (int32_t read = 0; read < depth; ++read)
+            detector.add_alignment(0, "chr1", bin * 100 + read, bin * 100 + read + 100, junctions_res);
+    }
+    // chr1 is finished as soon as the first alignment of chr2 is added.
+    detector.add_alignment(1, "chr2", 10, 110, junctions_res);
+    detector.finish(junctions_res);
+    testing::internal::GetCapturedStderr();
+
+    std::vector<Junction> expected_junctions
+    {
+        Junction{Breakend{"chr1", 499'999, strand::forward}, Breakend{"chr1", 501'000, strand::forward}, ""_dna5,
+                 "read_depth"}
+    };
+    EXPECT_EQ(junctions_res, expected_junctions);
+    EXPECT_EQ(detector.get_bin_depths().size(), 2u);
+}
+
+TEST(junction_detection, soft_clips_method_simple)
+{
+    auto clipped = [] (uint32_t const left_clip, uint32_t const matches, uint32_t const right_clip)
+    {
+        std::vector<seqan3::cigar> cigar{};
+        if (left_clip > 0)
+            cigar.push_back({left_clip, 'S'_cigar_operation});
+        cigar.push_back({matches, 'M'_cigar_operation});
+        if (right_clip > 0)
+            cigar.push_back({right_clip, 'S'_cigar_operation});
+        return cigar;
+    };
+
+    std::vector<Junction> junctions_res{};
+    SoftClipDetector detector{30};
+    testing::internal::CaptureStderr();
+    // Deletion of [1000, 1100): reads ending at 999 are clipped at their end, reads starting at 1100 at their start.
+    for (uint32_t read = 0; read < 5; ++read)
+        detector.add_alignment(0, "chr1", 900 + read, clipped(0, 100 - read, 30), junctions_res);
+    // A short clip is ignored.
+    detector.add_alignment(0, "chr1", 950, clipped(0, 45, 5), junctions_res);
+    for (uint32_t read = 0; read < 4; ++read)
+        detector.add_alignment(0, "chr1", 1100 + read, clipped(30, 100, 0), junctions_res);
+    // Tandem duplication of [3000, 3500): reads starting at 3000 are clipped at their start, reads ending at 3499 at
+    // their end.
+    for (uint32_t read = 0; read < 3; ++read)
+        detector.add_alignment(0, "chr1", 3000, clipped(20, 100, 0), junctions_res);
+    for (uint32_t read = 0; read < 3; ++read)
+        detector.add_alignment(0, "chr1", 3400, clipped(0, 100, 20), junctions_res);
+    // Not enough support.
+    for (uint32_t read = 0; read < 2; ++read)
+        detector.add_alignment(0, "chr1", 5000, clipped(20, 100, 0), junctions_res);
+    detector.add_alignment(1, "chr2", 10, clipped(0, 100, 0), junctions_res);
+    detector.finish(junctions_res);
+    testing::internal::GetCapturedStderr();
+
+    // The left clips of the deletion start at 1100 to 1103, their mean position is rounded.
+    std::vector<Junction> expected_junctions
+    {
+        Junction{Breakend{"chr1", 999, strand::forward}, Breakend{"chr1", 1102, strand::forward}, ""_dna5,
+                 "soft_clip"},
+        Junction{Breakend{"chr1", 3499, strand::forward}, Breakend{"chr1", 3000, strand::forward}, ""_dna5,
+                 "soft_clip"}
+    };
+    EXPECT_EQ(junctions_res, expected_junctions);
+}
+
+TEST(junction_detection, bounded_queue)
+{
+    // A producer passes more elements than fit into the queue to two consumers.
+    BoundedQueue<size_t> queue{2};
+    std::vector<std::vector<size_t>> consumed(2);
+    std::vector<std::thread> consumers{};
+    for (size_t consumer = 0; consumer < 2; ++consumer)
+    {
+        consumers.emplace_back([&queue, &consumed, consumer] ()
+        {
+            for (std::optional<size_t> element = queue.pop(); element; element = queue.pop())
+                consumed[consumer].push_back(*element);
+        });
+    }
+    for (size_t element = 0; element < 100; ++element)
+        EXPECT_TRUE(queue.push(element));
+    queue.close();
+    for (std::thread & consumer : consumers)
+        consumer.join();
+
+    // Every element is consumed once and each consumer receives its elements in order.
+    std::vector<size_t> all_consumed{};
+    for (std::vector<size_t> const & elements : consumed)
+    {
+        EXPECT_TRUE(std::is_sorted(elements.begin(), elements.end()));
+        all_consumed.insert(all_consumed.end(), elements.begin(), elements.end());
+    }
+    std::sort(all_consumed.begin(), all_consumed.end());
+    std::vector<size_t> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(all_consumed, expected);
+
+    // A closed queue accepts no further elements.
+    EXPECT_FALSE(queue.push(100));
+    EXPECT_FALSE(queue.pop());
+}
+
+TEST(junction_detection, depth_capped_sampler)
+{
+    // Without a cap, every alignment is kept.
+    DepthCappedSampler unlimited_sampler{0};
+    for (int32_t read = 0; read < 100; ++read)
+        EXPECT_EQ(unlimited_sampler.sample("read" + std::to_string(read), 0, 0, 1000), 1.0);
+
+    // Up to the cap, every alignment is kept, above it a decreasing fraction.
+    DepthCappedSampler sampler{10};
+    DepthCappedSampler same_sampler{10};
+    size_t kept_alignments = 0;
+    for (int32_t read = 0; read < 1000; ++read)
+    {
+        std::string const read_name = "read" + std::to_string(read);
+        double const sampling_rate = sampler.sample(read_name, 0, read, 10000);
+        EXPECT_EQ(sampling_rate, same_sampler.sample(read_name, 0, read, 10000));
+        if (read < 10)
+            EXPECT_EQ(sampling_rate, 1.0);
+        else if (sampling_rate > 0)
+            EXPECT_DOUBLE_EQ(sampling_rate, 10.0 / (read + 1));
+        EXPECT_EQ(sampling_rate > 0, read < 10 || read_name_fraction(read_name) < 10.0 / (read + 1));
+        kept_alignments += (sampling_rate > 0);
+    }
+    // About 10 + 10 * ln(100) alignments are kept.
+    EXPECT_GT(kept_alignments, 20u);
+    EXPECT_LT(kept_alignments, 120u);
+
+    // The depth drops behind the ends of the alignments and on the next reference.
+    EXPECT_EQ(sampler.sample("next", 0, 10000, 11000), 1.0);
+    DepthCappedSampler reference_sampler{1};
+    EXPECT_EQ(reference_sampler.sample("first", 0, 0, 1000), 1.0);
+    EXPECT_EQ(reference_sampler.sample("second", 1, 0, 1000), 1.0);
+
+    EXPECT_GE(read_name_fraction("read"), 0.0);
+    EXPECT_LT(read_name_fraction("read"), 1.0);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "modules/genotyping/genotyping.hpp"    // for the genotyping of the clusters
+
+using seqan3::operator""_dna5;
+
+/* -------- genotyping tests -------- */
+
+TEST(genotyping, genotype)
+{
+    EXPECT_EQ(genotype(0, 0), "./.");
+    EXPECT_EQ(genotype(10, 0), "0/0");
+    EXPECT_EQ(genotype(9, 2), "0/0");
+    EXPECT_EQ(genotype(8, 2), "0/1");
+    EXPECT_EQ(genotype(5, 5), "0/1");
+    EXPECT_EQ(genotype(2, 8), "1/1");
+    EXPECT_EQ(genotype(0, 3), "1/1");
+}
+
+TEST(genotyping, extract_genotyping_sites)
+{
+    std::vector<Cluster> const clusters
+    {
+        // deletion of [1100, 1160)
+        Cluster{{Junction{Breakend{"chr1", 1099, strand::forward},
+                          Breakend{"chr1", 1160, strand::forward},
+                          ""_dna5,
+                          "read1"}}},
+        // insertion after 2000
+        Cluster{{Junction{Breakend{"chr1", 2000, strand::forward},
+                          Breakend{"chr1", 2001, strand::forward},
+                          "ACGTACGTACGTACGTACGTACGTACGTACGTACGT"_dna5,
+                          "read2"}}},
+        // inversion breakpoint
+        Cluster{{Junction{Breakend{"chr1", 3000, strand::forward},
+                          Breakend{"chr1", 3500, strand::reverse},
+                          ""_dna5,
+                          "read3"}}},
+        // too short insertion
+        Cluster{{Junction{Breakend{"chr1", 4000, strand::forward},
+                          Breakend{"chr1", 4001, strand::forward},
+                          "ACGT"_dna5,
+                          "read4"}}}
+    };
+    std::vector<GenotypingSite> const sites = extract_genotyping_sites(clusters, 30, 1000000);
+    ASSERT_EQ(sites.size(), 3u);
+    EXPECT_EQ(sites[0].cluster_id, 0u);
+    EXPECT_EQ(sites[0].position, 1100);
+    EXPECT_EQ(sites[1].cluster_id, 0u);
+    EXPECT_EQ(sites[1].position, 1160);
+    EXPECT_EQ(sites[2].cluster_id, 1u);
+    EXPECT_EQ(sites[2].ref_name, "chr1");
+    EXPECT_EQ(sites[2].position, 2001);
+}
+
+TEST(genotyping, count_reference_support)
+{
+    std::vector<GenotypingSite> sites{{0, "chr21", 41980000},
+                                      {1, "chr21", 41972616},   // the insertion of m2257/8161/CCS
+                                      {2, "chr22", 100},        // not part of the alignment file
+                                      {3, "chr21", 41975000}};
+    std::vector<size_t> const reference_support =
+        count_reference_support(DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam", sites, 30, 20);
+
+    // The sites are sorted by position.
+    ASSERT_EQ(sites.size(), 3u);
+    EXPECT_EQ(sites[0].cluster_id, 1u);
+    EXPECT_EQ(sites[1].cluster_id, 3u);
+    EXPECT_EQ(sites[2].cluster_id, 0u);
+    // The read with the insertion and the reads starting at the insertion do not support the reference.
+    EXPECT_EQ(reference_support, (std::vector<size_t>{0, 4, 2}));
+}
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
 
 #include <fstream>
+#include <iterator>
 
 #include <seqan3/io/exception.hpp>
+#include <seqan3/utility/views/to.hpp>
 
+#include "structures/indexed_fasta.hpp"            // for class IndexedFasta
+#include "structures/read_ahead_stream.hpp"        // for class ReadAheadStream
 #include "variant_detection/variant_detection.hpp"  // for detect_junctions_in_long_reads_sam_file()
 
 using seqan3::operator""_dna5;
@@ -165,6 +169,56 @@ TEST(input_file, detect_junctions_in_long_reads_sam_file)
     }
 }
 
+TEST(input_file, detect_junctions_in_long_reads_sam_file_pipelined)
+{
+    std::vector<Junction> junctions_sequential{};
+    detect_junctions_in_long_reads_sam_file(junctions_sequential,
+                                            default_alignment_long_reads_file_path,
+                                            default_methods,
+                                            sv_default_length);
+
+    // The junctions of the batches are appended in order, so the detector threads give the same result.
+    for (uint16_t threads : {2, 4})
+    {
+        std::vector<Junction> junctions_pipelined{};
+        detect_junctions_in_long_reads_sam_file(junctions_pipelined,
+                                                default_alignment_long_reads_file_path,
+                                                default_methods,
+                                                sv_default_length,
+                                                threads);
+
+        ASSERT_EQ(junctions_sequential.size(), junctions_pipelined.size());
+        for (size_t i = 0; i < junctions_sequential.size(); ++i)
+        {
+            EXPECT_EQ(junctions_sequential[i].get_read_name(), junctions_pipelined[i].get_read_name());
+            EXPECT_TRUE(junctions_sequential[i] == junctions_pipelined[i]);
+        }
+    }
+}
+
+TEST(input_file, detect_junctions_in_long_reads_sam_file_method_subsets)
+{
+    std::vector<detection_methods> const long_read_methods{cigar_string, split_read, read_depth, soft_clips};
+    std::vector<Junction> junctions_all_methods{};
+    detect_junctions_in_long_reads_sam_file(junctions_all_methods,
+                                            default_alignment_long_reads_file_path,
+                                            long_read_methods,
+                                            sv_default_length);
+
+    // Every set of methods decodes its own fields, the methods are independent of each other.
+    size_t number_of_junctions = 0;
+    for (detection_methods method : long_read_methods)
+    {
+        std::vector<Junction> junctions_of_method{};
+        detect_junctions_in_long_reads_sam_file(junctions_of_method,
+                                                default_alignment_long_reads_file_path,
+                                                {method, method},
+                                                sv_default_length);
+        number_of_junctions += junctions_of_method.size();
+    }
+    EXPECT_EQ(junctions_all_methods.size(), number_of_junctions);
+}
+
 TEST(input_file, long_read_sam_file_unsorted)
 {
     std::vector<Junction> junctions_res{};
@@ -184,3 +238,215 @@ TEST(input_file, long_read_sam_file_unsorted)
 
     std::filesystem::remove(unsorted_sam_path);
 }
+
+TEST(input_file, indexed_fasta_without_index)
+{
+    // The index of the reference is computed from the file.
+    IndexedFasta const reference{DATADIR"mini_example_reference.fasta"};
+
+    ASSERT_EQ(reference.size(), 1u);
+    EXPECT_EQ(reference.get_id("chr1"), std::optional<size_t>{0});
+    EXPECT_EQ(reference.get_id("chr2"), std::nullopt);
+    FastaIndexEntry const & entry = reference.get_entry(0);
+    EXPECT_EQ(entry.name, "chr1");
+    EXPECT_EQ(entry.length, 368u);
+    EXPECT_EQ(entry.offset, 6u);
+    EXPECT_EQ(entry.line_bases, 50u);
+    EXPECT_EQ(entry.line_width, 51u);
+
+    // The view skips the line break after the 50th base.
+    EXPECT_EQ(reference.sequence(0, 45, 55) | seqan3::views::to<std::string>, "ATGCGGCGGC");
+    EXPECT_EQ(reference.base(0, 0), 'C');
+    EXPECT_EQ(reference.base(0, 367), 'A');
+    EXPECT_THROW(reference.base(0, 368), std::out_of_range);
+    EXPECT_THROW(reference.sequence(1, 0, 1), std::out_of_range);
+}
+
+TEST(input_file, indexed_fasta_with_index)
+{
+    std::filesystem::path const tmp_dir = std::filesystem::temp_directory_path();     // get the temp directory
+    std::filesystem::path const fasta_path{tmp_dir/"indexed.fasta"};
+    std::filesystem::path const index_path{tmp_dir/"indexed.fasta.fai"};
+    {
+        std::ofstream fasta{fasta_path.c_str()};
+        fasta << ">seq1 first sequence\nACGT\nacgt\nAC\n>seq2\nTTTT\nGG\n";
+        std::ofstream index{index_path.c_str()};
+        index << "seq1\t10\t21\t4\t5\nseq2\t6\t38\t4\t5\n";
+    }
+
+    IndexedFasta const reference{fasta_path};
+    ASSERT_EQ(reference.size(), 2u);
+    EXPECT_EQ(reference.get_id("seq2"), std::optional<size_t>{1});
+    EXPECT_EQ(reference.sequence(0, 2, 10) | seqan3::views::to<std::string>, "GTacgtAC");
+    EXPECT_EQ(reference.sequence(1, 0, 6) | seqan3::views::to<std::string>, "TTTTGG");
+    EXPECT_EQ(reference.sequence(1, 3, 3) | seqan3::views::to<std::string>, "");
+
+    // An index that points behind the end of the file is rejected.
+    {
+        std::ofstream index{index_path.c_str()};
+        index << "seq1\t10\t21\t4\t5\nseq2\t60\t38\t4\t5\n";
+    }
+    EXPECT_THROW(IndexedFasta{fasta_path}, std::runtime_error);
+
+    std::filesystem::remove(fasta_path);
+    std::filesystem::remove(index_path);
+}
+
+TEST(input_file, interval_index_from_bed_file)
+{
+    std::filesystem::path const bed_path = std::filesystem::temp_directory_path() / "excluded_regions.bed";
+    {
+        std::ofstream bed{bed_path.c_str()};
+        bed << "track name=excluded\n"
+            << "# centromere\n"
+            << "chr1\t500\t600\tcen\n"
+            << "chr1\t100\t200\n"
+            << "chr1\t150\t300\n"
+            << "\n"
+            << "chr2 0 10\n";
+    }
+    IntervalIndex const excluded_regions{bed_path};
+
+    // Overlapping intervals are merged, the ends are exclusive.
+    EXPECT_FALSE(excluded_regions.contains("chr1", 99));
+    EXPECT_TRUE(excluded_regions.contains("chr1", 100));
+    EXPECT_TRUE(excluded_regions.contains("chr1", 250));
+    EXPECT_FALSE(excluded_regions.contains("chr1", 300));
+    EXPECT_TRUE(excluded_regions.contains(Breakend{"chr1", 599, strand::forward}));
+    EXPECT_TRUE(excluded_regions.contains("chr2", 0));
+    EXPECT_FALSE(excluded_regions.contains("chr3", 0));
+    EXPECT_TRUE(IntervalIndex{}.empty());
+
+    {
+        std::ofstream bed{bed_path.c_str()};
+        bed << "chr1\t600\t500\n";
+    }
+    EXPECT_THROW(IntervalIndex{bed_path}, std::runtime_error);
+
+    std::filesystem::remove(bed_path);
+}
+
+TEST(input_file, detect_junctions_in_samples_with_excluded_regions)
+{
+    std::vector<AlignmentSample> const samples{AlignmentSample{"sample", {}, default_alignment_long_reads_file_path}};
+    std::vector<detection_methods> const methods{cigar_string, split_read};
+
+    std::vector<Junction> junctions{};
+    detect_junctions_in_samples(junctions, samples, methods, sv_default_length, 1);
+    // Two of the four junctions are identical and merged.
+    ASSERT_EQ(junctions.size(), 3u);
+    EXPECT_EQ(junctions[2].get_weight(), 2u);
+
+    // A junction is dropped if its second breakend is excluded.
+    std::vector<Junction> junctions_without_mate2{};
+    detect_junctions_in_samples(junctions_without_mate2,
+                                samples,
+                                methods,
+                                sv_default_length,
+                                1,
+                                IntervalIndex{{GenomicInterval{"chr22", 17458417, 17458418}}});
+    EXPECT_EQ(junctions_without_mate2.size(), 2u);
+    for (Junction const & junction : junctions_without_mate2)
+        EXPECT_NE(junction.get_mate2(), (Breakend{"chr22", 17458417, strand::reverse}));
+
+    // All junctions have their first breakend at the insertion.
+    std::vector<Junction> junctions_without_mate1{};
+    detect_junctions_in_samples(junctions_without_mate1,
+                                samples,
+                                methods,
+                                sv_default_length,
+                                1,
+                                IntervalIndex{{GenomicInterval{"chr21", 41972600, 41972700}}});
+    EXPECT_TRUE(junctions_without_mate1.empty());
+}
+
+TEST(input_file, samples_from_arguments)
+{
+    cmd_arguments args{};
+    args.alignment_long_reads_file_path = "data/NA12878.bam";
+    args.sample_short_reads_file_paths = {"short/HG002.bam", "short/HG003.sam"};
+    args.sample_long_reads_file_paths = {"long/HG004.bam", "long/HG002.bam"};
+
+    // The short and long reads of HG002 form one sample.
+    std::vector<AlignmentSample> const samples = get_samples(args);
+    ASSERT_EQ(samples.size(), 4u);
+    EXPECT_EQ(samples[0].name, "NA12878");
+    EXPECT_EQ(samples[1].name, "HG002");
+    EXPECT_EQ(samples[1].short_reads_file_path, "short/HG002.bam");
+    EXPECT_EQ(samples[1].long_reads_file_path, "long/HG002.bam");
+    EXPECT_EQ(samples[2].name, "HG003");
+    EXPECT_EQ(samples[2].long_reads_file_path, "");
+    EXPECT_EQ(samples[3].name, "HG004");
+    EXPECT_EQ(samples[3].short_reads_file_path, "");
+
+    // Other files with the same name are rejected.
+    cmd_arguments same_short_reads{args};
+    same_short_reads.sample_short_reads_file_paths.push_back("other/HG003.bam");
+    EXPECT_THROW(get_samples(same_short_reads), std::runtime_error);
+
+    cmd_arguments same_long_reads{args};
+    same_long_reads.sample_long_reads_file_paths.push_back("other/HG002.bam");
+    EXPECT_THROW(get_samples(same_long_reads), std::runtime_error);
+
+    cmd_arguments same_as_first_sample{args};
+    same_as_first_sample.sample_long_reads_file_paths.push_back("other/NA12878.bam");
+    EXPECT_THROW(get_samples(same_as_first_sample), std::runtime_error);
+}
+
+TEST(input_file, read_ahead_stream)
+{
+    std::ifstream file{default_alignment_long_reads_file_path};
+    std::string const expected_content{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+
+    // Blocks smaller than a line and a queue of one block still give the whole file in order.
+    for (ReadAheadOptions const options : {ReadAheadOptions{1, 7}, ReadAheadOptions{4, 1 << 20}})
+    {
+        ReadAheadStream stream{default_alignment_long_reads_file_path, options};
+        std::string const content{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+        EXPECT_EQ(expected_content, content);
+    }
+
+    // The stream can be destroyed before the file is read to the end.
+    {
+        ReadAheadStream stream{default_alignment_long_reads_file_path, ReadAheadOptions{2, 16}};
+        EXPECT_EQ(stream.get(), '@');
+    }
+
+    EXPECT_THROW((ReadAheadStream{DATADIR"does_not_exist.sam", ReadAheadOptions{1, 16}}), std::runtime_error);
+}
+
+TEST(input_file, detect_junctions_with_read_ahead)
+{
+    ReadAheadOptions const read_ahead{2, 4096};
+
+    std::vector<Junction> short_read_junctions{};
+    detect_junctions_in_short_reads_sam_file(short_read_junctions,
+                                             default_alignment_short_reads_file_path,
+                                             default_methods,
+                                             sv_default_length);
+    std::vector<Junction> short_read_junctions_read_ahead{};
+    detect_junctions_in_short_reads_sam_file(short_read_junctions_read_ahead,
+                                             default_alignment_short_reads_file_path,
+                                             default_methods,
+                                             sv_default_length,
+                                             IntervalIndex{},
+                                             0,
+                                             read_ahead);
+    EXPECT_EQ(short_read_junctions, short_read_junctions_read_ahead);
+
+    std::vector<Junction> long_read_junctions{};
+    detect_junctions_in_long_reads_sam_file(long_read_junctions,
+                                            default_alignment_long_reads_file_path,
+                                            default_methods,
+                                            sv_default_length);
+    std::vector<Junction> long_read_junctions_read_ahead{};
+    detect_junctions_in_long_reads_sam_file(long_read_junctions_read_ahead,
+                                            default_alignment_long_reads_file_path,
+                                            default_methods,
+                                            sv_default_length,
+                                            2,
+                                            IntervalIndex{},
+                                            0,
+                                            read_ahead);
+    EXPECT_EQ(long_read_junctions, long_read_junctions_read_ahead);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "variant_detection/variant_output.hpp"     // for find_and_output_variants()
+
+using seqan3::operator""_dna5;
+
+/* -------- variant output tests -------- */
+
+TEST(variant_output, threads_byte_identical)
+{
+    // Several ranges of clusters that alternate between deletions, insertions and clusters that are not output.
+    std::vector<Cluster> clusters{};
+    for (int32_t cluster = 0; cluster < 5000; ++cluster)
+    {
+        int32_t const position = cluster * 1000;
+        Breakend const mate1{"chr1", position, strand::forward};
+        switch (cluster % 3)
+        {
+            case 0: // Deletion
+                clusters.emplace_back(std::vector<Junction>{Junction{mate1,
+                                                                     Breakend{"chr1", position + 100, strand::forward},
+                                                                     ""_dna5,
+                                                                     "read"}});
+                break;
+            case 1: // Insertion
+                clusters.emplace_back(std::vector<Junction>{Junction{mate1,
+                                                                     Breakend{"chr1", position + 1, strand::forward},
+                                                                     seqan3::dna5_vector(40 + cluster % 7, 'A'_dna5),
+                                                                     "read"}});
+                break;
+            case 2: // Translocation
+                clusters.emplace_back(std::vector<Junction>{Junction{mate1,
+                                                                     Breakend{"chr2", position, strand::forward},
+                                                                     ""_dna5,
+                                                                     "read"}});
+                break;
+        }
+    }
+
+    cmd_arguments args{};
+    std::ostringstream single_threaded{};
+    find_and_output_variants(clusters, args, single_threaded);
+
+    for (uint16_t threads : {2, 3, 8})
+    {
+        args.threads = threads;
+        std::ostringstream multi_threaded{};
+        find_and_output_variants(clusters, args, multi_threaded);
+        EXPECT_EQ(single_threaded.str(), multi_threaded.str()) << "With " << threads << " threads";
+    }
+
+    // The header and one record per deletion and insertion are written.
+    std::string const output = single_threaded.str();
+    EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 6 + 1667 + 1667);
+}
@@ -1,19 +1,222 @@
 #include <gtest/gtest.h>
 
-// #include "modules/refinment/sViper_refinement_method.hpp"  // for the sViper refinement method
+#include <seqan3/alphabet/views/char_to.hpp>
+#include <seqan3/utility/views/to.hpp>
+
+#include "modules/refinement/insertion_consensus.hpp"       // for the consensus of inserted sequences
+#include "modules/refinement/sViper_refinement_method.hpp"  // for the sViper refinement method
+#include "modules/refinement/sVirl_refinement_method.hpp"   // for the sVirl refinement method
+#include "structures/arena.hpp"                             // for class Arena and ArenaAllocator
+
+using seqan3::operator""_cigar_operation;
+using seqan3::operator""_dna5;
 
 /* -------- refinement methods tests -------- */
 
-// TODO (irallia): these tests should be implemented when the associated refinement methods are implemented
+TEST(refinement, query_interval)
+{
+    // aligned to [100, 200), the query has 95 bases
+    std::vector<seqan3::cigar> const cigar = {{10, 'S'_cigar_operation},
+                                              {50, 'M'_cigar_operation},
+                                              {20, 'D'_cigar_operation},
+                                              {30, 'M'_cigar_operation},
+                                              {5, 'S'_cigar_operation}}; //10S50M20D30M5S
+
+    // The interval starts before the alignment and is extended into the left soft clip.
+    EXPECT_EQ(query_interval(100, cigar, 90, 200), (std::pair<int32_t, int32_t>{0, 90}));
+    // The interval starts inside the deletion.
+    EXPECT_EQ(query_interval(100, cigar, 160, 180), (std::pair<int32_t, int32_t>{60, 70}));
+    // The interval ends after the alignment and is extended into the right soft clip.
+    EXPECT_EQ(query_interval(100, cigar, 120, 250), (std::pair<int32_t, int32_t>{30, 95}));
+    // The interval does not overlap the alignment.
+    EXPECT_EQ(query_interval(100, cigar, 0, 100), (std::pair<int32_t, int32_t>{0, 0}));
+    EXPECT_EQ(query_interval(100, cigar, 200, 300), (std::pair<int32_t, int32_t>{0, 0}));
+
+    // The inserted bases inside the interval belong to it.
+    std::vector<seqan3::cigar> const cigar_with_insertion = {{20, 'M'_cigar_operation},
+                                                             {10, 'I'_cigar_operation},
+                                                             {20, 'M'_cigar_operation}}; //20M10I20M
+    EXPECT_EQ(query_interval(0, cigar_with_insertion, 10, 30), (std::pair<int32_t, int32_t>{10, 40}));
+}
+
+std::string const deletion_window{"GCTAAAGACAATTACATAACATACACGTCAGCACGAAACTTGTTGGCCCAGTGTGAATCGCTTAAGGGTTAAGTAAGTGTG"
+                                  "ATGCATACGCCTTTACTTGCTGTGTCCACCCCATCGGACTGGCATTTTTATTACACTCAGAAACAGAACTCGGGTAATTT"
+                                  "TGACAGGTCACGCAGAGGCGCGCCCTCCTGAAGTGCGTGGACACTCGCTATGAATCTCTGATTTACCCACTCTGCCAAAC"
+                                  "TCCAGCGCGGTCAGTTCCA"};
+std::string const insertion_window{"TCACCCTAAGTAACCGAATAATGCGTTCGCTCTATTGACTACGACGCGCTCATTCCCTTGTCGGAGAGTTATGGAACA"
+                                   "AGGACGCTGTCTGAGACTAGAAGACAGATAGTGCACACGACCGGCGTCGGAGAAACTCTATTTGCCGCCTGACAAGTC"
+                                   "AATGCGATCCGTAGGGGCAGCGCAGTATGCCAAGACTATAGGCA"};
+std::string const inserted_sequence{"CTGTCGCATCACAAACGATTAACTGATAAATGAGCCCTTT"};
+
+seqan3::dna5_vector to_dna5(std::string const & sequence)
+{
+    return sequence | seqan3::views::char_to<seqan3::dna5> | seqan3::views::to<seqan3::dna5_vector>;
+}
+
+TEST(refinement, realign_read_segments)
+{
+    std::vector<RefinementWindow> const windows{{0, "chr1", 1000, false, 50, to_dna5(deletion_window)},
+                                                {1, "chr1", 5000, true, 45, to_dna5(insertion_window)}};
+    std::vector<ReadSegment> read_segments
+    {
+        // 60 bp are deleted after 100 bp of the window.
+        {0, to_dna5(deletion_window.substr(0, 100) + deletion_window.substr(160))},
+        // The read does not contain the deletion.
+        {0, to_dna5(deletion_window.substr(50, 200))},
+        // 40 bp are inserted after 100 bp of the window, the read starts inside the window.
+        {1, to_dna5(insertion_window.substr(20, 80) + inserted_sequence + insertion_window.substr(100))}
+    };
+
+    std::vector<RealignedBreakpoint> breakpoints = realign_read_segments(windows, read_segments, 2);
+    std::sort(breakpoints.begin(), breakpoints.end(), [] (auto const & lhs, auto const & rhs)
+    {
+        return lhs.window_id < rhs.window_id;
+    });
+
+    ASSERT_EQ(breakpoints.size(), 2u);
+    EXPECT_EQ(breakpoints[0].window_id, 0u);
+    EXPECT_EQ(breakpoints[0].position, 1100);
+    EXPECT_EQ(breakpoints[0].length, 60);
+    EXPECT_EQ(breakpoints[1].window_id, 1u);
+    EXPECT_EQ(breakpoints[1].position, 5100);
+    EXPECT_EQ(breakpoints[1].length, 40);
+}
+
+TEST(refinement, refined_cluster)
+{
+    Cluster cluster{{Junction{Breakend{"chr1", 1098, strand::forward},
+                              Breakend{"chr1", 1162, strand::forward},
+                              ""_dna5,
+                              "read1"},
+                     Junction{Breakend{"chr1", 1100, strand::forward},
+                              Breakend{"chr1", 1164, strand::forward},
+                              ""_dna5,
+                              "read2"}}};
+    EXPECT_FALSE(cluster.is_refined());
+    EXPECT_EQ(cluster.get_refined_mate1(), (Breakend{"chr1", 1099, strand::forward}));
+    EXPECT_EQ(cluster.get_refined_mate2(), (Breakend{"chr1", 1163, strand::forward}));
+
+    cluster.set_refined_mates(Breakend{"chr1", 1099, strand::forward}, Breakend{"chr1", 1160, strand::forward});
+    EXPECT_TRUE(cluster.is_refined());
+    EXPECT_EQ(cluster.get_refined_mate1(), (Breakend{"chr1", 1099, strand::forward}));
+    EXPECT_EQ(cluster.get_refined_mate2(), (Breakend{"chr1", 1160, strand::forward}));
+    // The average mates are not changed by the refinement.
+    EXPECT_EQ(cluster.get_average_mate2(), (Breakend{"chr1", 1163, strand::forward}));
+}
+
+TEST(refinement, arena)
+{
+    Arena arena{1024};
+    EXPECT_EQ(arena.capacity(), 0u);
+
+    void * const first = arena.allocate(100, 8);
+    void * const second = arena.allocate(100, 16);
+    EXPECT_EQ(arena.capacity(), 1024u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 16, 0u);
+    EXPECT_GE(static_cast<std::byte *>(second) - static_cast<std::byte *>(first), 100);
+
+    // A full block is followed by a block of twice its size, larger allocations get a block of their own.
+    arena.allocate(1000, 8);
+    EXPECT_EQ(arena.capacity(), 3072u);
+    arena.allocate(5000, 8);
+    EXPECT_EQ(arena.capacity(), 8072u);
+
+    // After a reset, the blocks are reused.
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100, 8), first);
+    arena.allocate(1000, 8);
+    arena.allocate(5000, 8);
+    EXPECT_EQ(arena.capacity(), 8072u);
+
+    std::vector<int32_t, ArenaAllocator<int32_t>> values{ArenaAllocator<int32_t>{arena}};
+    for (int32_t value = 0; value < 1000; ++value)
+        values.push_back(value);
+    EXPECT_EQ(values[999], 999);
+}
+
+TEST(refinement, local_assembly)
+{
+    LocalAssembler assembler{};
+
+    // 60 bp are deleted after 100 bp of the window, one read does not contain the deletion.
+    RefinementWindow const window_with_deletion{0, "chr1", 1000, false, 50, to_dna5(deletion_window)};
+    std::vector<ReadSegment> const reads_with_deletion
+    {
+        {0, to_dna5(deletion_window.substr(0, 100) + deletion_window.substr(160))},
+        {0, to_dna5(deletion_window.substr(10, 90) + deletion_window.substr(160, 70))},
+        {0, to_dna5(deletion_window.substr(30, 70) + deletion_window.substr(160))},
+        {0, to_dna5(deletion_window.substr(50, 200))}
+    };
+    std::optional<AssembledVariant> deletion = assembler.assemble(window_with_deletion, reads_with_deletion);
+    ASSERT_TRUE(deletion.has_value());
+    EXPECT_EQ(deletion->position, 1100);
+    EXPECT_EQ(deletion->deleted_length, 60);
+    EXPECT_TRUE(deletion->inserted_sequence.empty());
+    size_t const arena_capacity = assembler.get_arena_capacity();
+
+    // 40 bp are inserted after 100 bp of the window.
+    RefinementWindow const window_with_insertion{1, "chr1", 5000, true, 45, to_dna5(insertion_window)};
+    std::vector<ReadSegment> const reads_with_insertion
+    {
+        {1, to_dna5(insertion_window.substr(0, 100) + inserted_sequence + insertion_window.substr(100))},
+        {1, to_dna5(insertion_window.substr(20, 80) + inserted_sequence + insertion_window.substr(100, 80))},
+        {1, to_dna5(insertion_window.substr(40, 60) + inserted_sequence + insertion_window.substr(100))},
+        {1, to_dna5(insertion_window.substr(0, 150))}
+    };
+    std::optional<AssembledVariant> insertion = assembler.assemble(window_with_insertion, reads_with_insertion);
+    ASSERT_TRUE(insertion.has_value());
+    EXPECT_EQ(insertion->position, 5100);
+    EXPECT_EQ(insertion->deleted_length, 0);
+    EXPECT_EQ(insertion->inserted_sequence, to_dna5(inserted_sequence));
+    // The arena of the first window is reused.
+    EXPECT_EQ(assembler.get_arena_capacity(), arena_capacity);
 
-// TEST(junction_detection, refinement_method_sViper)
-// {
-//     testing::internal::CaptureStdout();
+    // Without the variant in the reads, the contig is the reference.
+    std::vector<ReadSegment> const reference_reads{{0, to_dna5(deletion_window.substr(0, 200))},
+                                                   {0, to_dna5(deletion_window.substr(50, 200))}};
+    EXPECT_FALSE(assembler.assemble(window_with_deletion, reference_reads).has_value());
+}
 
-//     std::vector<Junction> junctions{};
-//     std::vector<Cluster> resulting_clusters{};
-//     sViper_refinement_method(junctions, clusters);
+TEST(refinement, insertion_consensus)
+{
+    // Every sequence but two has a different error.
+    std::vector<seqan3::dna5_vector> const inserted_sequences
+    {
+        to_dna5(inserted_sequence),
+        to_dna5(inserted_sequence.substr(0, 5) + "A" + inserted_sequence.substr(6)),    // substitution
+        to_dna5(inserted_sequence.substr(0, 20) + inserted_sequence.substr(21)),        // deletion
+        to_dna5(inserted_sequence.substr(0, 30) + "G" + inserted_sequence.substr(30)),  // insertion
+        to_dna5(inserted_sequence),
+        seqan3::dna5_vector{}                                                           // no inserted sequence
+    };
+    EXPECT_EQ(insertion_consensus(inserted_sequences, 10), to_dna5(inserted_sequence));
+    // With a single member, the sequence with the median length is the consensus.
+    EXPECT_EQ(insertion_consensus(inserted_sequences, 1).size(), inserted_sequence.size());
+    EXPECT_TRUE(insertion_consensus({}, 10).empty());
 
-//     std::vector<Cluster> expected_clusters{};
-//     EXPECT_EQ(expected_clusters, resulting_clusters);
-// }
+    std::vector<Cluster> clusters
+    {
+        Cluster{{Junction{Breakend{"chr1", 100, strand::forward},
+                          Breakend{"chr1", 101, strand::forward},
+                          inserted_sequences[1],
+                          "read1"},
+                 Junction{Breakend{"chr1", 100, strand::forward},
+                          Breakend{"chr1", 101, strand::forward},
+                          inserted_sequences[0],
+                          "read2"},
+                 Junction{Breakend{"chr1", 100, strand::forward},
+                          Breakend{"chr1", 101, strand::forward},
+                          inserted_sequences[2],
+                          "read3"}}},
+        // A deletion has no consensus.
+        Cluster{{Junction{Breakend{"chr1", 1099, strand::forward},
+                          Breakend{"chr1", 1160, strand::forward},
+                          ""_dna5,
+                          "read4"}}}
+    };
+    compute_insertion_consensus(clusters, 30, 10, 2);
+    ASSERT_TRUE(clusters[0].get_refined_inserted_sequence().has_value());
+    EXPECT_EQ(*clusters[0].get_refined_inserted_sequence(), to_dna5(inserted_sequence));
+    EXPECT_EQ(clusters[0].get_refined_inserted_sequence_size(), 40);
+    EXPECT_FALSE(clusters[1].get_refined_inserted_sequence().has_value());
+}
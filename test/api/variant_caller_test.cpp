@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <seqan3/io/sam_file/input.hpp>
+
+#include "modules/clustering/simple_clustering_method.hpp"  // for the simple clustering method
+#include "variant_detection/variant_caller.hpp"             // for class VariantCaller
+
+using seqan3::operator""_cigar_operation;
+using seqan3::operator""_dna5;
+using seqan3::operator""_tag;
+
+std::string const default_alignment_long_reads_file_path = DATADIR"simulated.minimap2.hg19.coordsorted_cutoff.sam";
+std::vector<detection_methods> const long_read_methods{cigar_string, split_read, read_depth, soft_clips};
+constexpr uint64_t sv_default_length = 30;
+
+//!\brief Returns an alignment of 100 bases, a deletion and another 100 bases.
+AlignmentRecord deletion_alignment(std::string const & ref_name, int32_t const ref_pos, uint32_t const deletion_length)
+{
+    return AlignmentRecord{"read",
+                           seqan3::sam_flag{},
+                           ref_name,
+                           ref_pos,
+                           60,
+                           {{100, 'M'_cigar_operation},
+                            {deletion_length, 'D'_cigar_operation},
+                            {100, 'M'_cigar_operation}},
+                           seqan3::dna5_vector(200, 'A'_dna5),
+                           ""};
+}
+
+/* -------- variant caller tests -------- */
+
+TEST(variant_caller, same_clusters_as_alignment_file)
+{
+    // Reference: detect the junctions of the whole file and cluster them at once.
+    std::vector<Junction> junctions{};
+    detect_junctions_in_long_reads_sam_file(junctions,
+                                            default_alignment_long_reads_file_path,
+                                            long_read_methods,
+                                            sv_default_length);
+    // The variant caller merges identical junctions, like the detection of a sample.
+    merge_identical_junctions(junctions);
+    std::vector<Cluster> expected_clusters = simple_clustering_method(junctions);
+    std::sort(expected_clusters.begin(), expected_clusters.end());
+
+    using my_fields = seqan3::fields<seqan3::field::id,
+                                     seqan3::field::flag,
+                                     seqan3::field::ref_id,
+                                     seqan3::field::ref_offset,
+                                     seqan3::field::mapq,
+                                     seqan3::field::cigar,
+                                     seqan3::field::seq,
+                                     seqan3::field::tags,
+                                     seqan3::field::header_ptr>;
+    std::vector<AlignmentRecord> alignments{};
+    seqan3::sam_file_input alignment_file{default_alignment_long_reads_file_path, my_fields{}};
+    for (auto & record : alignment_file)
+    {
+        if (!record.reference_id() || !record.reference_position())
+            continue;
+        alignments.push_back(AlignmentRecord{record.id(),
+                                             record.flag(),
+                                             record.header_ptr()->ref_ids()[*record.reference_id()],
+                                             *record.reference_position(),
+                                             record.mapping_quality(),
+                                             record.cigar_sequence(),
+                                             record.sequence(),
+                                             record.tags().get<"SA"_tag>()});
+    }
+
+    // The alignments are pushed one by one and in batches, with a small closing distance to close many regions.
+    for (uint16_t threads : {1, 3})
+    {
+        VariantCallerConfig config{};
+        config.methods = long_read_methods;
+        config.threads = threads;
+        config.closing_distance = 1000;
+        std::vector<Cluster> clusters{};
+        VariantCaller caller{config, [&] (Cluster cluster) { clusters.push_back(std::move(cluster)); }};
+        if (threads == 1)
+        {
+            for (AlignmentRecord const & alignment : alignments)
+                caller.push(alignment);
+        }
+        else
+        {
+            for (size_t begin = 0; begin < alignments.size(); begin += 300)
+                caller.push(std::vector<AlignmentRecord>(alignments.begin() + begin,
+                                                         alignments.begin() + std::min(begin + 300, alignments.size())));
+        }
+        caller.finish();
+
+        std::sort(clusters.begin(), clusters.end());
+        ASSERT_EQ(expected_clusters.size(), clusters.size()) << "With " << threads << " threads";
+        for (size_t i = 0; i < clusters.size(); ++i)
+        {
+            EXPECT_TRUE(expected_clusters[i] == clusters[i]) << "With " << threads << " threads";
+            EXPECT_EQ(expected_clusters[i].get_cluster_size(), clusters[i].get_cluster_size());
+        }
+    }
+}
+
+TEST(variant_caller, clusters_before_finish)
+{
+    VariantCallerConfig config{};
+    config.methods = {cigar_string};
+    std::vector<Cluster> clusters{};
+    VariantCaller caller{config, [&] (Cluster cluster) { clusters.push_back(std::move(cluster)); }};
+
+    for (int32_t read = 0; read < 3; ++read)
+        caller.push(deletion_alignment("chr1", 1000, 50));
+    EXPECT_TRUE(clusters.empty());
+
+    // The first deletion is more than the closing distance behind these alignments.
+    caller.push(std::vector<AlignmentRecord>{deletion_alignment("chr1", 500000, 60),
+                                             deletion_alignment("chr1", 500000, 60)});
+    ASSERT_EQ(clusters.size(), 1u);
+    // The three reads give the same junction, which is merged.
+    EXPECT_EQ(clusters[0].get_members().size(), 1u);
+    EXPECT_EQ(clusters[0].get_cluster_size(), 3u);
+    EXPECT_EQ(clusters[0].get_average_mate1(), (Breakend{"chr1", 1099, strand::forward}));
+
+    // Another reference closes the whole previous reference.
+    caller.push(deletion_alignment("chr2", 0, 70));
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[1].get_cluster_size(), 2u);
+
+    caller.finish();
+    ASSERT_EQ(clusters.size(), 3u);
+    EXPECT_EQ(clusters[2].get_average_mate1().seq_name, "chr2");
+    EXPECT_THROW(caller.push(deletion_alignment("chr2", 100, 70)), std::runtime_error);
+}
+
+TEST(variant_caller, unsorted_alignments)
+{
+    VariantCaller caller{VariantCallerConfig{}, [] (Cluster) {}};
+    caller.push(deletion_alignment("chr1", 1000, 50));
+    EXPECT_THROW(caller.push(deletion_alignment("chr1", 10, 50)), std::runtime_error);
+
+    caller.push(deletion_alignment("chr2", 1000, 50));
+    EXPECT_THROW(caller.push(deletion_alignment("chr1", 2000, 50)), std::runtime_error);
+
+    VariantCallerConfig config{};
+    config.clustering_method = candidate_selection_based_on_voting;
+    EXPECT_THROW((VariantCaller{config, [] (Cluster) {}}), std::runtime_error);
+}
+
+TEST(variant_caller, rejected_batch)
+{
+    VariantCallerConfig config{};
+    config.methods = {cigar_string};
+    std::vector<Cluster> clusters{};
+    VariantCaller caller{config, [&] (Cluster cluster) { clusters.push_back(std::move(cluster)); }};
+    caller.push(deletion_alignment("chr1", 1000, 50));
+
+    // The second alignment of the batch is unsorted, so neither is accepted and the caller continues at 1000.
+    std::vector<AlignmentRecord> batch{};
+    batch.push_back(deletion_alignment("chr1", 1500, 50));
+    batch.push_back(deletion_alignment("chr1", 1200, 50));
+    EXPECT_THROW(caller.push(std::move(batch)), std::runtime_error);
+
+    caller.push(deletion_alignment("chr1", 1100, 50));
+    caller.finish();
+    ASSERT_EQ(clusters.size(), 2u);
+    EXPECT_EQ(clusters[0].get_average_mate1(), (Breakend{"chr1", 1099, strand::forward}));
+    EXPECT_EQ(clusters[1].get_average_mate1(), (Breakend{"chr1", 1199, strand::forward}));
+}
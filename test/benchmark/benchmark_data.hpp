@@ -0,0 +1,193 @@
+#pragma once
+
+#include <ostream>      // for std::ostream
+#include <random>       // for std::mt19937
+#include <streambuf>    // for std::streambuf
+
+#include <seqan3/alphabet/cigar/cigar.hpp>
+#include <seqan3/alphabet/nucleotide/dna5.hpp>
+
+#include "structures/cluster.hpp"   // for class Cluster
+#include "structures/junction.hpp"  // for class Junction
+
+using seqan3::operator""_cigar_operation;
+
+// A stream buffer that formats everything it gets but discards the result. Used to measure the output functions
+// without the cost of actual I/O and to silence the debug output of the detection methods.
+class discard_buffer : public std::streambuf
+{
+protected:
+    std::streamsize xsputn(char const *, std::streamsize count) override
+    {
+        return count;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        return traits_type::not_eof(c);
+    }
+};
+
+// Provides an output stream that discards everything written to it.
+inline std::ostream & discard_stream()
+{
+    static discard_buffer buffer{};
+    static std::ostream stream{&buffer};
+    return stream;
+}
+
+// Generates a random DNA sequence of the given length.
+inline seqan3::dna5_vector generate_sequence(size_t const length, std::mt19937 & generator)
+{
+    std::uniform_int_distribution<int> base_distribution{0, 3};
+    seqan3::dna5_vector sequence(length);
+    for (seqan3::dna5 & base : sequence)
+        base.assign_rank(base_distribution(generator));
+    return sequence;
+}
+
+// Generates a CIGAR string of a long read with the given number of operations. Matches alternate with small insertions
+// and deletions (1-5 bp); every 16th indel is large (100-1000 bp) and gives rise to a junction.
+inline std::vector<seqan3::cigar> generate_long_read_cigar(size_t const number_of_operations,
+                                                           std::mt19937 & generator)
+{
+    std::uniform_int_distribution<uint32_t> match_distribution{10, 200};
+    std::uniform_int_distribution<uint32_t> small_indel_distribution{1, 5};
+    std::uniform_int_distribution<uint32_t> large_indel_distribution{100, 1000};
+    std::bernoulli_distribution insertion_distribution{0.5};
+
+    std::vector<seqan3::cigar> cigar_string{};
+    cigar_string.reserve(number_of_operations + 2);
+    cigar_string.emplace_back(100, 'S'_cigar_operation);
+    for (size_t i = 0; i < number_of_operations; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            cigar_string.emplace_back(match_distribution(generator), 'M'_cigar_operation);
+        }
+        else
+        {
+            uint32_t const length = (i % 32 == 1) ? large_indel_distribution(generator)
+                                                  : small_indel_distribution(generator);
+            cigar_string.emplace_back(length, insertion_distribution(generator) ? 'I'_cigar_operation
+                                                                                : 'D'_cigar_operation);
+        }
+    }
+    cigar_string.emplace_back(100, 'S'_cigar_operation);
+    return cigar_string;
+}
+
+// Returns the number of query bases a CIGAR string consumes.
+inline size_t query_length(std::vector<seqan3::cigar> const & cigar_string)
+{
+    size_t length = 0;
+    for (auto [count, operation] : cigar_string)
+    {
+        char const op = operation.to_char();
+        if (op == 'M' || op == '=' || op == 'X' || op == 'I' || op == 'S')
+            length += count;
+    }
+    return length;
+}
+
+// Generates an SA tag with the given number of supplementary segments of a read with 100 bases per segment.
+inline std::string generate_sa_tag(size_t const number_of_segments, std::mt19937 & generator)
+{
+    std::uniform_int_distribution<int32_t> chromosome_distribution{1, 22};
+    std::uniform_int_distribution<int32_t> position_distribution{1, 100'000'000};
+    std::bernoulli_distribution strand_distribution{0.5};
+
+    size_t const read_length = (number_of_segments + 1) * 100;
+    std::string sa_tag{};
+    for (size_t i = 1; i <= number_of_segments; ++i)
+    {
+        size_t const left_clip = i * 100;
+        size_t const right_clip = read_length - left_clip - 100;
+        sa_tag += "chr" + std::to_string(chromosome_distribution(generator)) + ","
+                + std::to_string(position_distribution(generator)) + ","
+                + (strand_distribution(generator) ? "+" : "-") + ","
+                + std::to_string(left_clip) + "S100M" + std::to_string(right_clip) + "S,60,0;";
+    }
+    return sa_tag;
+}
+
+// Generates random junctions spread over three chromosomes.
+inline std::vector<Junction> generate_junctions(size_t const number_of_junctions, uint32_t const seed = 42)
+{
+    std::mt19937 generator{seed};
+    std::uniform_int_distribution<int32_t> chromosome_distribution{1, 3};
+    std::uniform_int_distribution<int32_t> position_distribution{0, 10'000'000};
+    std::uniform_int_distribution<size_t> inserted_length_distribution{0, 10};
+    std::bernoulli_distribution strand_distribution{0.5};
+
+    std::vector<Junction> junctions{};
+    junctions.reserve(number_of_junctions);
+    for (size_t i = 0; i < number_of_junctions; ++i)
+    {
+        Breakend mate1{"chr" + std::to_string(chromosome_distribution(generator)),
+                       position_distribution(generator),
+                       strand_distribution(generator) ? strand::forward : strand::reverse};
+        Breakend mate2{"chr" + std::to_string(chromosome_distribution(generator)),
+                       position_distribution(generator),
+                       strand_distribution(generator) ? strand::forward : strand::reverse};
+        junctions.emplace_back(std::move(mate1),
+                               std::move(mate2),
+                               generate_sequence(inserted_length_distribution(generator), generator),
+                               "read" + std::to_string(i));
+    }
+    return junctions;
+}
+
+// Generates sorted deletion junctions that form `number_of_partitions` partitions (see partition_junctions()) of
+// `partition_size` junctions each.
+inline std::vector<Junction> generate_partitioned_junctions(size_t const number_of_partitions,
+                                                            size_t const partition_size,
+                                                            uint32_t const seed = 42)
+{
+    std::mt19937 generator{seed};
+    std::uniform_int_distribution<int32_t> offset_distribution{0, 40};
+
+    std::vector<Junction> junctions{};
+    junctions.reserve(number_of_partitions * partition_size);
+    for (size_t partition = 0; partition < number_of_partitions; ++partition)
+    {
+        int32_t const center = static_cast<int32_t>(partition) * 10'000;
+        for (size_t i = 0; i < partition_size; ++i)
+        {
+            junctions.emplace_back(Breakend{"chr1", center + offset_distribution(generator), strand::forward},
+                                   Breakend{"chr1", center + 500 + offset_distribution(generator), strand::forward},
+                                   seqan3::dna5_vector{},
+                                   "read" + std::to_string(partition) + "_" + std::to_string(i));
+        }
+    }
+    std::sort(junctions.begin(), junctions.end());
+    return junctions;
+}
+
+// Generates sorted clusters of three members each that alternate between deletions and insertions.
+inline std::vector<Cluster> generate_clusters(size_t const number_of_clusters, uint32_t const seed = 42)
+{
+    std::mt19937 generator{seed};
+    std::uniform_int_distribution<int32_t> length_distribution{50, 5'000};
+
+    std::vector<Cluster> clusters{};
+    clusters.reserve(number_of_clusters);
+    for (size_t cluster = 0; cluster < number_of_clusters; ++cluster)
+    {
+        int32_t const position = static_cast<int32_t>(cluster) * 10'000;
+        int32_t const length = length_distribution(generator);
+        bool const is_deletion = (cluster % 2 == 0);
+        seqan3::dna5_vector const inserted_sequence = is_deletion ? seqan3::dna5_vector{}
+                                                                  : generate_sequence(length, generator);
+        std::vector<Junction> members{};
+        for (size_t i = 0; i < 3; ++i)
+        {
+            members.emplace_back(Breakend{"chr1", position, strand::forward},
+                                 Breakend{"chr1", is_deletion ? position + length : position + 1, strand::forward},
+                                 inserted_sequence,
+                                 "read" + std::to_string(cluster) + "_" + std::to_string(i));
+        }
+        clusters.emplace_back(std::move(members));
+    }
+    return clusters;
+}
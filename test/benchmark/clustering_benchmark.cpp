@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_data.hpp"
+#include "structures/arena.hpp"                                      // for class Arena, class ArenaAllocator
+#include "modules/clustering/hierarchical_clustering_method.hpp"    // for the hierarchical clustering method
+#include "modules/clustering/simple_clustering_method.hpp"          // for the simple clustering method
+
+/* -------- clustering methods benchmarks -------- */
+
+// Argument: number of junctions.
+static void junction_sort_benchmark(benchmark::State & state)
+{
+    std::vector<Junction> const junctions = generate_junctions(state.range(0));
+    std::vector<Junction> sorted_junctions{};
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sorted_junctions = junctions;
+        state.ResumeTiming();
+        std::sort(sorted_junctions.begin(), sorted_junctions.end());
+        benchmark::DoNotOptimize(sorted_junctions.data());
+    }
+
+    state.counters["junctions/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                       benchmark::Counter::kIsRate);
+}
+BENCHMARK(junction_sort_benchmark)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+// Argument: number of junctions.
+static void simple_clustering_benchmark(benchmark::State & state)
+{
+    std::vector<Junction> junctions = generate_junctions(state.range(0));
+    std::sort(junctions.begin(), junctions.end());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(simple_clustering_method(junctions));
+
+    state.counters["junctions/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                       benchmark::Counter::kIsRate);
+}
+BENCHMARK(simple_clustering_benchmark)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+// Arguments: number of partitions, partition size.
+static void partition_junctions_benchmark(benchmark::State & state)
+{
+    std::vector<Junction> const junctions = generate_partitioned_junctions(state.range(0), state.range(1));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(partition_junctions(junctions));
+
+    state.counters["junctions/s"] = benchmark::Counter(state.iterations() * junctions.size(),
+                                                       benchmark::Counter::kIsRate);
+}
+BENCHMARK(partition_junctions_benchmark)->Args({4096, 4})->Args({1024, 16})->Args({256, 64})->Args({64, 256});
+
+// Argument: partition size. The total number of junctions is kept constant at 4096 so that the quadratic cost of the
+// distance matrix shows up in the results.
+static void hierarchical_clustering_benchmark(benchmark::State & state)
+{
+    size_t const partition_size = state.range(0);
+    std::vector<Junction> const junctions = generate_partitioned_junctions(4096 / partition_size, partition_size);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(hierarchical_clustering_method(junctions, 10.0));
+
+    state.counters["junctions/s"] = benchmark::Counter(state.iterations() * junctions.size(),
+                                                       benchmark::Counter::kIsRate);
+}
+BENCHMARK(hierarchical_clustering_benchmark)->RangeMultiplier(4)->Range(2, 2048);
+
+// Argument: partition size. Allocates the per-partition buffers of the hierarchical clustering (condensed distance
+// matrix, merge steps, heights and labels) for 4096 junctions in partitions of the given size, once from the heap
+// and once from an arena that is reset after every partition. This isolates the allocator from the clustering.
+template <bool use_arena>
+static void partition_buffers_benchmark(benchmark::State & state)
+{
+    size_t const partition_size = state.range(0);
+    size_t const partition_count = 4096 / partition_size;
+    Arena arena{};
+
+    for (auto _ : state)
+    {
+        for (size_t partition = 0; partition < partition_count; ++partition)
+        {
+            size_t const distance_count = partition_size * (partition_size - 1) / 2;
+            if constexpr (use_arena)
+            {
+                std::vector<double, ArenaAllocator<double>> distances(distance_count, arena);
+                std::vector<int, ArenaAllocator<int>> merges(2 * partition_size, arena);
+                std::vector<double, ArenaAllocator<double>> heights(partition_size, arena);
+                std::vector<int, ArenaAllocator<int>> labels(partition_size, arena);
+                benchmark::DoNotOptimize(distances.data());
+                benchmark::DoNotOptimize(merges.data());
+                benchmark::DoNotOptimize(heights.data());
+                benchmark::DoNotOptimize(labels.data());
+                arena.reset();
+            }
+            else
+            {
+                std::vector<double> distances(distance_count);
+                std::vector<int> merges(2 * partition_size);
+                std::vector<double> heights(partition_size);
+                std::vector<int> labels(partition_size);
+                benchmark::DoNotOptimize(distances.data());
+                benchmark::DoNotOptimize(merges.data());
+                benchmark::DoNotOptimize(heights.data());
+                benchmark::DoNotOptimize(labels.data());
+            }
+        }
+    }
+
+    state.counters["partitions/s"] = benchmark::Counter(state.iterations() * partition_count,
+                                                        benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(partition_buffers_benchmark, false)->RangeMultiplier(4)->Range(2, 2048);
+BENCHMARK_TEMPLATE(partition_buffers_benchmark, true)->RangeMultiplier(4)->Range(2, 2048);
+
+BENCHMARK_MAIN();
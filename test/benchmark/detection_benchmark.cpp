@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <seqan3/core/debug_stream.hpp>
+#include <seqan3/io/sam_file/sam_flag.hpp>
+
+#include "benchmark_data.hpp"
+#include "legacy_sa_tag_parser.hpp"                                 // for retrieve_aligned_segments_legacy()
+#include "modules/sv_detection_methods/analyze_cigar_method.hpp"    // for the cigar string method
+#include "modules/sv_detection_methods/analyze_sa_tag_method.hpp"   // for the split read method
+#include "structures/aligned_segment.hpp"                           // for struct AlignedSegment
+
+/* -------- detection methods benchmarks -------- */
+
+// Argument: number of CIGAR operations of the read.
+static void analyze_cigar_benchmark(benchmark::State & state)
+{
+    seqan3::debug_stream.set_underlying_stream(discard_stream());
+    std::mt19937 generator{42};
+    std::vector<seqan3::cigar> cigar_string = generate_long_read_cigar(state.range(0), generator);
+    seqan3::dna5_vector const query_sequence = generate_sequence(query_length(cigar_string), generator);
+    std::vector<Junction> junctions{};
+
+    for (auto _ : state)
+    {
+        junctions.clear();
+        analyze_cigar("read", "chr1", 10'000, cigar_string, query_sequence, junctions, 30);
+        benchmark::DoNotOptimize(junctions.data());
+    }
+
+    state.counters["junctions"] = junctions.size();
+    state.counters["operations/s"] = benchmark::Counter(state.iterations() * cigar_string.size(),
+                                                        benchmark::Counter::kIsRate);
+}
+BENCHMARK(analyze_cigar_benchmark)->RangeMultiplier(4)->Range(16, 4096);
+
+// Argument: number of supplementary segments in the SA tag.
+static void retrieve_aligned_segments_benchmark(benchmark::State & state)
+{
+    std::mt19937 generator{42};
+    std::string const sa_tag = generate_sa_tag(state.range(0), generator);
+    std::vector<AlignedSegment> aligned_segments{};
+
+    for (auto _ : state)
+    {
+        aligned_segments.clear();
+        retrieve_aligned_segments(sa_tag, aligned_segments);
+        benchmark::DoNotOptimize(aligned_segments.data());
+    }
+
+    state.counters["segments/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                      benchmark::Counter::kIsRate);
+}
+BENCHMARK(retrieve_aligned_segments_benchmark)->RangeMultiplier(2)->Range(1, 64);
+
+// Argument: number of supplementary segments in the SA tag.
+static void retrieve_aligned_segments_legacy_benchmark(benchmark::State & state)
+{
+    std::mt19937 generator{42};
+    std::string const sa_tag = generate_sa_tag(state.range(0), generator);
+    std::vector<AlignedSegment> aligned_segments{};
+
+    for (auto _ : state)
+    {
+        aligned_segments.clear();
+        retrieve_aligned_segments_legacy(sa_tag, aligned_segments);
+        benchmark::DoNotOptimize(aligned_segments.data());
+    }
+
+    state.counters["segments/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                      benchmark::Counter::kIsRate);
+}
+BENCHMARK(retrieve_aligned_segments_legacy_benchmark)->RangeMultiplier(2)->Range(1, 64);
+
+// Argument: number of supplementary segments in the SA tag.
+static void analyze_sa_tag_benchmark(benchmark::State & state)
+{
+    seqan3::debug_stream.set_underlying_stream(discard_stream());
+    std::mt19937 generator{42};
+    std::string const sa_tag = generate_sa_tag(state.range(0), generator);
+    size_t const read_length = (state.range(0) + 1) * 100;
+    std::vector<seqan3::cigar> const cigar_string{{100, 'M'_cigar_operation},
+                                                  {static_cast<uint32_t>(read_length - 100), 'S'_cigar_operation}};
+    seqan3::dna5_vector const query_sequence = generate_sequence(read_length, generator);
+    std::vector<Junction> junctions{};
+
+    for (auto _ : state)
+    {
+        junctions.clear();
+        analyze_sa_tag("read", seqan3::sam_flag{0u}, "chr1", 10'000, 60, cigar_string, query_sequence, sa_tag,
+                       junctions);
+        benchmark::DoNotOptimize(junctions.data());
+    }
+
+    state.counters["segments/s"] = benchmark::Counter(state.iterations() * (state.range(0) + 1),
+                                                      benchmark::Counter::kIsRate);
+}
+BENCHMARK(analyze_sa_tag_benchmark)->RangeMultiplier(2)->Range(1, 64);
+
+// Argument: number of CIGAR operations of the segment.
+static void aligned_segment_construction_benchmark(benchmark::State & state)
+{
+    std::mt19937 generator{42};
+    std::vector<seqan3::cigar> const cigar_string = generate_long_read_cigar(state.range(0), generator);
+
+    for (auto _ : state)
+    {
+        AlignedSegment const aligned_segment{strand::forward, "chr1", 10'000, 60, cigar_string};
+        benchmark::DoNotOptimize(aligned_segment.get_reference_end());
+    }
+
+    state.counters["operations/s"] = benchmark::Counter(state.iterations() * cigar_string.size(),
+                                                        benchmark::Counter::kIsRate);
+}
+BENCHMARK(aligned_segment_construction_benchmark)->RangeMultiplier(4)->Range(16, 4096);
+
+BENCHMARK_MAIN();
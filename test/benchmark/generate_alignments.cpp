@@ -0,0 +1,647 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string_view>
+#include <tuple>
+
+#include <seqan3/argument_parser/all.hpp>
+#include <seqan3/std/filesystem>
+
+/* -------- synthetic alignment generator -------- */
+
+// Writes a random reference, coordinate-sorted long-read and paired short-read alignments of a diploid donor genome
+// with planted deletions and insertions, and the truth set of the planted variants as VCF. The output only depends on
+// the arguments, so that large benchmark inputs can be reproduced locally instead of being downloaded.
+//
+// Long reads are aligned through the variants with D and I operations; deletions of at least --split_length bases are
+// represented as split alignments (primary and supplementary records with SA tags). Short reads are soft clipped at
+// variants, keeping the longer aligned part, as a short-read aligner would do.
+
+struct generator_arguments
+{
+    std::filesystem::path output_prefix{};
+    uint64_t genome_size{10'000'000};
+    uint32_t number_of_chromosomes{2};
+    double sv_density{10.0};
+    uint32_t min_sv_length{50};
+    uint32_t max_sv_length{5'000};
+    double long_read_coverage{10.0};
+    uint32_t long_read_length{10'000};
+    uint32_t split_length{1'000};
+    double short_read_coverage{30.0};
+    uint32_t short_read_length{150};
+    uint32_t fragment_length{400};
+    uint32_t fragment_sd{50};
+    double error_rate{0.0};
+    uint32_t seed{42};
+};
+
+struct planted_variant
+{
+    int32_t position{};     // 0-based: first deleted base or the base the sequence is inserted before
+    int32_t length{};
+    bool is_insertion{};
+    bool is_homozygous{};
+    std::string inserted_sequence{};
+};
+
+struct chromosome
+{
+    std::string name{};
+    std::string sequence{};
+    std::vector<planted_variant> variants{};
+};
+
+// A stretch of a haplotype that is either copied from the reference or inserted before `ref_start`.
+struct haplotype_piece
+{
+    int32_t hap_start{};
+    int32_t ref_start{};
+    int32_t length{};
+    bool is_inserted{};
+};
+
+struct haplotype
+{
+    std::string sequence{};
+    std::vector<haplotype_piece> pieces{};
+};
+
+// The alignment of a stretch of a read to the reference. Operations are M, I or D.
+struct alignment_segment
+{
+    int32_t ref_start{-1};
+    int32_t left_clip{};
+    int32_t right_clip{};
+    std::vector<std::pair<char, int32_t>> operations{};
+
+    int32_t aligned_bases() const
+    {
+        int32_t count = 0;
+        for (auto const & [operation, length] : operations)
+            if (operation != 'D')
+                count += length;
+        return count;
+    }
+
+    int32_t ref_end() const
+    {
+        int32_t position = ref_start;
+        for (auto const & [operation, length] : operations)
+            if (operation != 'I')
+                position += length;
+        return position;
+    }
+
+    std::string cigar() const
+    {
+        std::string result{};
+        if (left_clip > 0)
+            result += std::to_string(left_clip) + 'S';
+        for (auto const & [operation, length] : operations)
+            result += std::to_string(length) + operation;
+        if (right_clip > 0)
+            result += std::to_string(right_clip) + 'S';
+        return result;
+    }
+};
+
+// Buffers records and writes them sorted by position. Records can be added out of order as long as they are not
+// before the position given to the last call of flush_before().
+class sorted_sam_writer
+{
+public:
+    sorted_sam_writer(std::filesystem::path const & file_path, std::string const & header)
+    {
+        out_file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        out_file.open(file_path);
+        if (!out_file.good() || !out_file.is_open())
+            throw std::runtime_error{"Could not open file '" + file_path.string() + "' for writing."};
+        out_file << header;
+    }
+
+    void add(int32_t const position, std::string line)
+    {
+        pending.push(entry{position, order++, std::move(line)});
+    }
+
+    void flush_before(int32_t const position)
+    {
+        while (!pending.empty() && pending.top().position < position)
+        {
+            out_file << pending.top().line;
+            pending.pop();
+        }
+    }
+
+    void flush_all()
+    {
+        flush_before(std::numeric_limits<int32_t>::max());
+    }
+
+private:
+    struct entry
+    {
+        int32_t position{};
+        uint64_t order{};
+        std::string line{};
+
+        bool operator>(entry const & other) const
+        {
+            return std::tie(position, order) > std::tie(other.position, other.order);
+        }
+    };
+
+    std::vector<char> buffer = std::vector<char>(1 << 20);
+    std::ofstream out_file{};
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> pending{};
+    uint64_t order{};
+};
+
+std::string random_sequence(size_t const length, std::mt19937 & generator)
+{
+    static constexpr std::string_view bases{"ACGT"};
+    std::uniform_int_distribution<int> base_distribution{0, 3};
+    std::string sequence(length, 'N');
+    for (char & base : sequence)
+        base = bases[base_distribution(generator)];
+    return sequence;
+}
+
+// Substitutes bases with the given rate.
+void add_errors(std::string & sequence, double const error_rate, std::mt19937 & generator)
+{
+    if (error_rate <= 0)
+        return;
+    static constexpr std::string_view bases{"ACGT"};
+    std::bernoulli_distribution error_distribution{error_rate};
+    std::uniform_int_distribution<size_t> offset_distribution{1, 3};
+    for (char & base : sequence)
+        if (error_distribution(generator))
+            base = bases[(bases.find(base) + offset_distribution(generator)) % 4];
+}
+
+// Places the variants into equally sized bins, one per bin, so that they never overlap.
+std::vector<planted_variant> plant_variants(std::string const & sequence,
+                                            generator_arguments const & args,
+                                            std::mt19937 & generator)
+{
+    int32_t const margin = 1'000;
+    int32_t const bin_width = 2 * margin + args.max_sv_length;
+    if (sequence.size() < static_cast<size_t>(2 * margin + bin_width))
+        return {};
+    int64_t const wanted = std::llround(sequence.size() / 1e6 * args.sv_density);
+    int64_t const number_of_variants = std::min<int64_t>(wanted, (sequence.size() - 2 * margin) / bin_width);
+    if (number_of_variants <= 0)
+        return {};
+
+    int64_t const step = (sequence.size() - 2 * margin) / number_of_variants;
+    std::uniform_real_distribution<double> log_length_distribution{std::log(args.min_sv_length),
+                                                                   std::log(args.max_sv_length)};
+    std::uniform_int_distribution<int64_t> offset_distribution{0, step - bin_width};
+    std::bernoulli_distribution half{0.5};
+
+    std::vector<planted_variant> variants{};
+    for (int64_t i = 0; i < number_of_variants; ++i)
+    {
+        planted_variant variant{};
+        variant.position = margin + i * step + margin + offset_distribution(generator);
+        variant.length = std::clamp<int32_t>(std::lround(std::exp(log_length_distribution(generator))),
+                                             args.min_sv_length, args.max_sv_length);
+        variant.is_insertion = half(generator);
+        variant.is_homozygous = half(generator);
+        if (variant.is_insertion)
+            variant.inserted_sequence = random_sequence(variant.length, generator);
+        variants.push_back(std::move(variant));
+    }
+    return variants;
+}
+
+// Builds a haplotype with all homozygous and optionally all heterozygous variants of the chromosome.
+haplotype build_haplotype(chromosome const & chrom, bool const with_heterozygous)
+{
+    haplotype hap{};
+    auto add_piece = [&hap] (int32_t const ref_start, std::string_view const bases, bool const is_inserted)
+    {
+        if (bases.empty())
+            return;
+        hap.pieces.push_back(haplotype_piece{static_cast<int32_t>(hap.sequence.size()),
+                                             ref_start,
+                                             static_cast<int32_t>(bases.size()),
+                                             is_inserted});
+        hap.sequence.append(bases);
+    };
+
+    std::string_view const reference{chrom.sequence};
+    int32_t ref_pos = 0;
+    for (planted_variant const & variant : chrom.variants)
+    {
+        if (!variant.is_homozygous && !with_heterozygous)
+            continue;
+        add_piece(ref_pos, reference.substr(ref_pos, variant.position - ref_pos), false);
+        ref_pos = variant.position;
+        if (variant.is_insertion)
+            add_piece(ref_pos, variant.inserted_sequence, true);
+        else
+            ref_pos += variant.length;
+    }
+    add_piece(ref_pos, reference.substr(ref_pos), false);
+    return hap;
+}
+
+// Returns the haplotype position of the first reference base at or after the given reference position.
+int32_t haplotype_position(haplotype const & hap, int32_t const ref_pos)
+{
+    auto it = std::upper_bound(hap.pieces.begin(), hap.pieces.end(), ref_pos,
+                               [] (int32_t const pos, haplotype_piece const & piece) { return pos < piece.ref_start; });
+    if (it != hap.pieces.begin())
+    {
+        haplotype_piece const & previous = *(it - 1);
+        if (!previous.is_inserted && ref_pos < previous.ref_start + previous.length)
+            return previous.hap_start + ref_pos - previous.ref_start;
+    }
+    while (it != hap.pieces.end() && it->is_inserted)
+        ++it;
+    return it == hap.pieces.end() ? hap.sequence.size() : it->hap_start;
+}
+
+// Aligns the haplotype interval [begin, end) to the reference.
+alignment_segment align_interval(haplotype const & hap, int32_t const begin, int32_t const end)
+{
+    alignment_segment segment{};
+    auto it = std::upper_bound(hap.pieces.begin(), hap.pieces.end(), begin,
+                               [] (int32_t const pos, haplotype_piece const & piece) { return pos < piece.hap_start; });
+    --it;
+
+    int32_t ref_end = 0;
+    for (int32_t pos = begin; pos < end; ++it)
+    {
+        int32_t const overlap = std::min(end, it->hap_start + it->length) - pos;
+        int32_t const ref_pos = it->ref_start + pos - it->hap_start;
+        if (it->is_inserted)
+        {
+            if (segment.ref_start < 0)
+                segment.left_clip += overlap;  // an alignment does not start with an insertion
+            else
+                segment.operations.emplace_back('I', overlap);
+        }
+        else
+        {
+            if (segment.ref_start < 0)
+                segment.ref_start = ref_pos;
+            else if (ref_pos > ref_end)
+                segment.operations.emplace_back('D', ref_pos - ref_end);
+            segment.operations.emplace_back('M', overlap);
+            ref_end = ref_pos + overlap;
+        }
+        pos += overlap;
+    }
+
+    if (!segment.operations.empty() && segment.operations.back().first == 'I')
+    {
+        segment.right_clip += segment.operations.back().second;
+        segment.operations.pop_back();
+    }
+    return segment;
+}
+
+// Splits an alignment at deletions and insertions of at least the given lengths. The parts are soft clipped.
+std::vector<alignment_segment> split_alignment(alignment_segment const & alignment,
+                                               int32_t const min_deletion_length,
+                                               int32_t const min_insertion_length)
+{
+    int32_t const query_length = alignment.left_clip + alignment.aligned_bases() + alignment.right_clip;
+    std::vector<alignment_segment> parts{};
+    alignment_segment current{alignment.ref_start, alignment.left_clip, 0, {}};
+    int32_t query_pos = alignment.left_clip;
+    int32_t ref_pos = alignment.ref_start;
+    for (auto const & [operation, length] : alignment.operations)
+    {
+        if ((operation == 'D' && length >= min_deletion_length) ||
+            (operation == 'I' && length >= min_insertion_length))
+        {
+            parts.push_back(std::move(current));
+            if (operation == 'D')
+                ref_pos += length;
+            else
+                query_pos += length;
+            current = alignment_segment{ref_pos, query_pos, 0, {}};
+            continue;
+        }
+        current.operations.emplace_back(operation, length);
+        if (operation != 'D')
+            query_pos += length;
+        if (operation != 'I')
+            ref_pos += length;
+    }
+    parts.push_back(std::move(current));
+
+    for (alignment_segment & part : parts)
+        part.right_clip = query_length - part.left_clip - part.aligned_bases();
+    return parts;
+}
+
+std::string format_record(std::string const & name,
+                          uint16_t const flag,
+                          std::string const & reference_name,
+                          alignment_segment const & segment,
+                          int32_t const mate_position,
+                          int32_t const template_length,
+                          std::string const & sequence,
+                          std::string const & tags)
+{
+    std::string line{};
+    line.reserve(sequence.size() + 200);
+    line += name + '\t' + std::to_string(flag) + '\t' + reference_name + '\t'
+          + std::to_string(segment.ref_start + 1) + "\t60\t" + segment.cigar() + '\t'
+          + (mate_position < 0 ? "*\t0\t0\t" : "=\t" + std::to_string(mate_position + 1) + '\t'
+                                                     + std::to_string(template_length) + '\t');
+    line += sequence;
+    line += "\t*\t";
+    line += tags;
+    line += '\n';
+    return line;
+}
+
+std::string sam_header(std::vector<chromosome> const & chromosomes, std::string const & read_group)
+{
+    std::string header{"@HD\tVN:1.6\tSO:coordinate\n"};
+    for (chromosome const & chrom : chromosomes)
+        header += "@SQ\tSN:" + chrom.name + "\tLN:" + std::to_string(chrom.sequence.size()) + '\n';
+    header += "@RG\tID:" + read_group + "\tSM:synthetic\n";
+    header += "@PG\tID:generate_alignments\tPN:generate_alignments\n";
+    return header;
+}
+
+void generate_long_reads(chromosome const & chrom,
+                         std::array<haplotype, 2> const & haplotypes,
+                         generator_arguments const & args,
+                         std::mt19937 & generator,
+                         sorted_sam_writer & writer)
+{
+    std::exponential_distribution<double> step_distribution{args.long_read_coverage / args.long_read_length};
+    std::bernoulli_distribution half{0.5};
+    size_t read_number = 0;
+
+    for (double sampled = step_distribution(generator); sampled < chrom.sequence.size();
+         sampled += step_distribution(generator))
+    {
+        int32_t const ref_pos = static_cast<int32_t>(sampled);
+        writer.flush_before(ref_pos);
+
+        haplotype const & hap = haplotypes[half(generator)];
+        int32_t const begin = haplotype_position(hap, ref_pos);
+        int32_t const end = std::min<int64_t>(begin + args.long_read_length, hap.sequence.size());
+        if (end - begin < static_cast<int32_t>(args.long_read_length / 2))
+            continue;
+        alignment_segment const alignment = align_interval(hap, begin, end);
+        if (alignment.ref_start < 0)
+            continue;
+
+        std::string sequence = hap.sequence.substr(begin, end - begin);
+        add_errors(sequence, args.error_rate, generator);
+        bool const is_reverse = half(generator);
+        std::string const name = "long_" + chrom.name + "_" + std::to_string(read_number++);
+
+        std::vector<alignment_segment> const parts = split_alignment(alignment,
+                                                                     args.split_length,
+                                                                     std::numeric_limits<int32_t>::max());
+        size_t const primary = std::max_element(parts.begin(), parts.end(), [] (auto const & lhs, auto const & rhs)
+        {
+            return lhs.aligned_bases() < rhs.aligned_bases();
+        }) - parts.begin();
+
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            std::string tags{"RG:Z:long"};
+            if (parts.size() > 1)
+            {
+                tags += "\tSA:Z:";
+                for (size_t j = 0; j < parts.size(); ++j)
+                {
+                    if (j == i)
+                        continue;
+                    tags += chrom.name + ',' + std::to_string(parts[j].ref_start + 1) + ',' + (is_reverse ? '-' : '+')
+                          + ',' + parts[j].cigar() + ",60,0;";
+                }
+            }
+            uint16_t const flag = (is_reverse ? 16 : 0) | (i == primary ? 0 : 2048);
+            writer.add(parts[i].ref_start, format_record(name, flag, chrom.name, parts[i], -1, 0, sequence, tags));
+        }
+    }
+}
+
+void generate_short_read_pairs(chromosome const & chrom,
+                               std::array<haplotype, 2> const & haplotypes,
+                               generator_arguments const & args,
+                               std::mt19937 & generator,
+                               sorted_sam_writer & writer)
+{
+    int32_t const read_length = args.short_read_length;
+    std::exponential_distribution<double> step_distribution{args.short_read_coverage / (2.0 * read_length)};
+    std::normal_distribution<double> fragment_distribution{static_cast<double>(args.fragment_length),
+                                                           static_cast<double>(args.fragment_sd)};
+    std::bernoulli_distribution half{0.5};
+    size_t pair_number = 0;
+
+    // Short-read aligners cannot align through the variants: keep the longest part of the read.
+    auto align_read = [&] (haplotype const & hap, int32_t const begin)
+    {
+        std::vector<alignment_segment> parts = split_alignment(align_interval(hap, begin, begin + read_length), 1, 1);
+        return *std::max_element(parts.begin(), parts.end(), [] (auto const & lhs, auto const & rhs)
+        {
+            return lhs.aligned_bases() < rhs.aligned_bases();
+        });
+    };
+
+    for (double sampled = step_distribution(generator); sampled < chrom.sequence.size();
+         sampled += step_distribution(generator))
+    {
+        int32_t const ref_pos = static_cast<int32_t>(sampled);
+        writer.flush_before(ref_pos);
+
+        haplotype const & hap = haplotypes[half(generator)];
+        int32_t const begin = haplotype_position(hap, ref_pos);
+        int32_t const fragment_length = std::max<int32_t>(read_length, std::lround(fragment_distribution(generator)));
+        if (begin + fragment_length > static_cast<int64_t>(hap.sequence.size()))
+            continue;
+
+        alignment_segment const left = align_read(hap, begin);
+        alignment_segment const right = align_read(hap, begin + fragment_length - read_length);
+        if (left.ref_start < 0 || right.ref_start < 0)
+            continue;
+
+        std::string left_sequence = hap.sequence.substr(begin, read_length);
+        std::string right_sequence = hap.sequence.substr(begin + fragment_length - read_length, read_length);
+        add_errors(left_sequence, args.error_rate, generator);
+        add_errors(right_sequence, args.error_rate, generator);
+
+        int32_t const template_start = std::min(left.ref_start, right.ref_start);
+        int32_t const template_length = std::max(left.ref_end(), right.ref_end()) - template_start;
+        bool const is_proper = left.left_clip + left.right_clip + right.left_clip + right.right_clip == 0 &&
+                               std::abs(template_length - static_cast<int32_t>(args.fragment_length)) <=
+                               3 * static_cast<int32_t>(args.fragment_sd);
+        bool const left_is_first = half(generator);
+        uint16_t const pair_flags = 1 | (is_proper ? 2 : 0);
+        uint16_t const left_flag = pair_flags | 32 | (left_is_first ? 64 : 128);
+        uint16_t const right_flag = pair_flags | 16 | (left_is_first ? 128 : 64);
+        int32_t const left_tlen = left.ref_start <= right.ref_start ? template_length : -template_length;
+
+        std::string const name = "short_" + chrom.name + "_" + std::to_string(pair_number++);
+        writer.add(left.ref_start, format_record(name, left_flag, chrom.name, left, right.ref_start, left_tlen,
+                                                 left_sequence, "RG:Z:short"));
+        writer.add(right.ref_start, format_record(name, right_flag, chrom.name, right, left.ref_start, -left_tlen,
+                                                  right_sequence, "RG:Z:short"));
+    }
+}
+
+void write_reference(std::vector<chromosome> const & chromosomes, std::filesystem::path const & file_path)
+{
+    std::ofstream out_file{file_path};
+    if (!out_file.good() || !out_file.is_open())
+        throw std::runtime_error{"Could not open file '" + file_path.string() + "' for writing."};
+    for (chromosome const & chrom : chromosomes)
+    {
+        out_file << '>' << chrom.name << '\n';
+        for (size_t i = 0; i < chrom.sequence.size(); i += 80)
+            out_file << std::string_view{chrom.sequence}.substr(i, 80) << '\n';
+    }
+}
+
+// Writes the planted variants with the same coordinates as iGenVar reports them.
+void write_truth(std::vector<chromosome> const & chromosomes, std::filesystem::path const & file_path)
+{
+    std::ofstream out_file{file_path};
+    if (!out_file.good() || !out_file.is_open())
+        throw std::runtime_error{"Could not open file '" + file_path.string() + "' for writing."};
+    out_file << "##fileformat=VCFv4.3\n##source=generate_alignments\n";
+    for (chromosome const & chrom : chromosomes)
+        out_file << "##contig=<ID=" << chrom.name << ",length=" << chrom.sequence.size() << ">\n";
+    out_file << "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of SV.\">\n"
+             << "##INFO=<ID=SVLEN,Number=1,Type=Integer,Description=\"Length of SV.\">\n"
+             << "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of SV.\">\n"
+             << "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+             << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tsynthetic\n";
+    for (chromosome const & chrom : chromosomes)
+    {
+        for (planted_variant const & variant : chrom.variants)
+        {
+            // POS is the 1-based position of the base before the variant.
+            out_file << chrom.name << '\t' << variant.position << '\t' << ".\t" << chrom.sequence[variant.position - 1]
+                     << '\t' << (variant.is_insertion ? "<INS>" : "<DEL>") << "\t.\tPASS\t";
+            if (variant.is_insertion)
+                out_file << "END=" << variant.position << ";SVLEN=" << variant.length << ";SVTYPE=INS";
+            else
+                out_file << "END=" << variant.position + variant.length << ";SVLEN=-" << variant.length
+                         << ";SVTYPE=DEL";
+            out_file << "\tGT\t" << (variant.is_homozygous ? "1/1" : "0/1") << '\n';
+        }
+    }
+}
+
+void initialize_argument_parser(seqan3::argument_parser & parser, generator_arguments & args)
+{
+    parser.info.app_name = "generate_alignments";
+    parser.info.short_description = "Generate coordinate-sorted alignments with planted structural variants.";
+    parser.info.description.push_back("Writes PREFIX.fasta (reference), PREFIX_long_reads.sam, "
+                                      "PREFIX_short_reads.sam and PREFIX_truth.vcf (planted variants). The output is "
+                                      "fully determined by the arguments and the seed.");
+
+    parser.add_option(args.output_prefix, 'o', "output_prefix", "Prefix of the output files.",
+                      seqan3::option_spec::required);
+    parser.add_option(args.genome_size, 'g', "genome_size", "Total size of the reference in bp.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{10'000, 2'000'000'000});
+    parser.add_option(args.number_of_chromosomes, '\0', "chromosomes", "Number of chromosomes.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{1, 1'000});
+    parser.add_option(args.sv_density, 'd', "sv_density", "Planted variants per Mbp.");
+    parser.add_option(args.min_sv_length, '\0', "min_sv_length", "Minimum length of the planted variants.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{1, 1'000'000});
+    parser.add_option(args.max_sv_length, '\0', "max_sv_length", "Maximum length of the planted variants.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{1, 1'000'000});
+    parser.add_option(args.long_read_coverage, '\0', "long_read_coverage", "Coverage of the long reads, 0 disables.");
+    parser.add_option(args.long_read_length, '\0', "long_read_length", "Length of the long reads.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{100, 1'000'000});
+    parser.add_option(args.split_length, '\0', "split_length",
+                      "Deletions of at least this length split long-read alignments into records with SA tags.");
+    parser.add_option(args.short_read_coverage, '\0', "short_read_coverage",
+                      "Coverage of the short reads, 0 disables.");
+    parser.add_option(args.short_read_length, '\0', "short_read_length", "Length of the short reads.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{20, 1'000});
+    parser.add_option(args.fragment_length, '\0', "fragment_length", "Mean fragment length of the short read pairs.");
+    parser.add_option(args.fragment_sd, '\0', "fragment_sd", "Standard deviation of the fragment length.");
+    parser.add_option(args.error_rate, 'e', "error_rate", "Substitution rate of the reads.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{0, 1});
+    parser.add_option(args.seed, 's', "seed", "Seed of the random number generator.");
+}
+
+int main(int argc, char ** argv)
+{
+    seqan3::argument_parser parser{"generate_alignments", argc, argv, seqan3::update_notifications::off};
+    generator_arguments args{};
+    initialize_argument_parser(parser, args);
+
+    try
+    {
+        parser.parse();
+        if (args.min_sv_length > args.max_sv_length)
+            throw seqan3::argument_parser_error{"The minimum SV length must not exceed the maximum SV length."};
+    }
+    catch (seqan3::argument_parser_error const & ext)
+    {
+        std::cerr << "[Error] " << ext.what() << '\n';
+        return -1;
+    }
+
+    try
+    {
+        std::mt19937 generator{args.seed};
+        std::vector<chromosome> chromosomes(args.number_of_chromosomes);
+        for (size_t i = 0; i < chromosomes.size(); ++i)
+        {
+            chromosomes[i].name = "chr" + std::to_string(i + 1);
+            chromosomes[i].sequence = random_sequence(args.genome_size / args.number_of_chromosomes, generator);
+            chromosomes[i].variants = plant_variants(chromosomes[i].sequence, args, generator);
+        }
+
+        std::string const prefix = args.output_prefix.string();
+        write_reference(chromosomes, prefix + ".fasta");
+        write_truth(chromosomes, prefix + "_truth.vcf");
+
+        std::optional<sorted_sam_writer> long_reads_writer{};
+        std::optional<sorted_sam_writer> short_reads_writer{};
+        if (args.long_read_coverage > 0)
+            long_reads_writer.emplace(prefix + "_long_reads.sam", sam_header(chromosomes, "long"));
+        if (args.short_read_coverage > 0)
+            short_reads_writer.emplace(prefix + "_short_reads.sam", sam_header(chromosomes, "short"));
+
+        for (chromosome const & chrom : chromosomes)
+        {
+            std::array<haplotype, 2> const haplotypes{build_haplotype(chrom, true), build_haplotype(chrom, false)};
+            if (long_reads_writer)
+            {
+                generate_long_reads(chrom, haplotypes, args, generator, *long_reads_writer);
+                long_reads_writer->flush_all();
+            }
+            if (short_reads_writer)
+            {
+                generate_short_read_pairs(chrom, haplotypes, args, generator, *short_reads_writer);
+                short_reads_writer->flush_all();
+            }
+            std::cerr << "Generated " << chrom.name << " with " << chrom.variants.size() << " variants.\n";
+        }
+    }
+    catch (std::exception const & ext)
+    {
+        std::cerr << "[Error] " << ext.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
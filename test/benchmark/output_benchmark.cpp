@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include "benchmark_data.hpp"
+#include "variant_detection/variant_output.hpp"     // for find_and_output_variants()
+
+/* -------- variant output benchmarks -------- */
+
+// Argument: number of clusters.
+static void find_and_output_variants_benchmark(benchmark::State & state)
+{
+    std::vector<Cluster> const clusters = generate_clusters(state.range(0));
+    cmd_arguments const args{};
+
+    for (auto _ : state)
+        find_and_output_variants(clusters, args, discard_stream());
+
+    state.counters["clusters/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                      benchmark::Counter::kIsRate);
+}
+BENCHMARK(find_and_output_variants_benchmark)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+
+// Arguments: number of clusters, number of threads that format the records.
+static void find_and_output_variants_threads_benchmark(benchmark::State & state)
+{
+    std::vector<Cluster> const clusters = generate_clusters(state.range(0));
+    cmd_arguments args{};
+    args.threads = state.range(1);
+
+    for (auto _ : state)
+        find_and_output_variants(clusters, args, discard_stream());
+
+    state.counters["clusters/s"] = benchmark::Counter(state.iterations() * state.range(0),
+                                                      benchmark::Counter::kIsRate);
+}
+BENCHMARK(find_and_output_variants_threads_benchmark)->Args({1 << 15, 1})->Args({1 << 15, 2})->Args({1 << 15, 4})
+                                                     ->Args({1 << 15, 8})->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "modules/refinement/sViper_refinement_method.hpp"  // for realign_read_segments()
+
+/* -------- sViper refinement benchmarks -------- */
+
+// Generates refinement windows of 400 bp + deletion length and for each window reads with the deletion in the middle.
+static std::vector<RefinementWindow> generate_windows(size_t const number_of_windows,
+                                                      size_t const reads_per_window,
+                                                      std::vector<ReadSegment> & read_segments)
+{
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<int> base_distribution{0, 3};
+    std::uniform_int_distribution<int32_t> length_distribution{50, 500};
+    std::vector<RefinementWindow> windows(number_of_windows);
+    for (size_t window_id = 0; window_id < number_of_windows; ++window_id)
+    {
+        RefinementWindow & window = windows[window_id];
+        window.cluster_id = window_id;
+        window.ref_name = "chr1";
+        window.start = window_id * 10'000;
+        window.expected_length = length_distribution(generator);
+        window.sequence.resize(400 + window.expected_length);
+        for (seqan3::dna5 & base : window.sequence)
+            base.assign_rank(base_distribution(generator));
+
+        seqan3::dna5_vector sequence{window.sequence.begin(), window.sequence.begin() + 200};
+        sequence.insert(sequence.end(),
+                        window.sequence.begin() + 200 + window.expected_length,
+                        window.sequence.end());
+        for (size_t read = 0; read < reads_per_window; ++read)
+            read_segments.push_back(ReadSegment{window_id, sequence});
+    }
+    return windows;
+}
+
+// Arguments: number of alignments, number of threads. Reports the number of alignments per second.
+static void realign_read_segments_benchmark(benchmark::State & state)
+{
+    size_t const number_of_alignments = state.range(0);
+    uint16_t const threads = state.range(1);
+    std::vector<ReadSegment> read_segments{};
+    std::vector<RefinementWindow> const windows = generate_windows(number_of_alignments / 10, 10, read_segments);
+
+    size_t number_of_breakpoints = 0;
+    for (auto _ : state)
+    {
+        number_of_breakpoints = realign_read_segments(windows, read_segments, threads).size();
+        benchmark::DoNotOptimize(number_of_breakpoints);
+    }
+
+    state.counters["found"] = static_cast<double>(number_of_breakpoints) / read_segments.size();
+    state.counters["alignments/s"] = benchmark::Counter(state.iterations() * read_segments.size(),
+                                                        benchmark::Counter::kIsRate);
+}
+BENCHMARK(realign_read_segments_benchmark)->Args({1 << 12, 1})->Args({1 << 12, 2})->Args({1 << 12, 4})
+                                          ->Args({1 << 12, 8})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,484 @@
+#include <fcntl.h>          // for open
+#include <sys/resource.h>   // for rusage
+#include <sys/wait.h>       // for wait4
+#include <unistd.h>         // for fork, execv, pipe
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <seqan3/argument_parser/all.hpp>
+#include <seqan3/io/sam_file/input.hpp>
+#include <seqan3/std/filesystem>
+
+/* -------- end-to-end scaling benchmark -------- */
+
+// Runs the iGenVar binary on inputs of increasing size and with different numbers of threads. For each run the wall
+// time, CPU time and peak memory of the process are recorded. Binaries with a --timings option additionally write the
+// wall time of each stage to a tab-separated file, which is read after each run. The progress messages of iGenVar are
+// not parsed, they are no stable interface.
+
+struct scaling_arguments
+{
+    std::filesystem::path binary{BINDIR"iGenVar"};
+    std::vector<std::string> short_reads_inputs{};
+    std::vector<std::string> long_reads_inputs{};
+    std::vector<uint32_t> threads{1};
+    uint32_t repetitions{3};
+    std::filesystem::path output_file_path{};
+    std::filesystem::path baseline_file_path{};
+    double tolerance{0.1};
+};
+
+struct run_result
+{
+    std::string input{};
+    uintmax_t file_size{};
+    size_t records{};
+    uint32_t threads{};
+    double wall_seconds{};
+    double user_seconds{};
+    double system_seconds{};
+    long max_rss_kb{};
+    std::map<std::string, double> stage_seconds{};  // empty if the binary has no --timings option
+};
+
+// The stages in the timings file of iGenVar, each has a column "<stage>_s".
+std::vector<std::string> const stages{"detection", "clustering", "refinement", "consensus", "genotyping", "output"};
+
+std::vector<std::string> const columns{"input", "file_size", "records", "threads", "wall_s", "user_s", "sys_s",
+                                       "cpu_s", "max_rss_kb", "records_per_s", "detection_s", "clustering_s",
+                                       "refinement_s", "consensus_s", "genotyping_s", "output_s"};
+
+// Resolves an input file name relative to the data directory of the tests if it does not exist as given.
+std::filesystem::path resolve_input(std::string const & input)
+{
+    std::filesystem::path const path{input};
+    if (std::filesystem::exists(path))
+        return path;
+    return std::filesystem::path{std::string{DATADIR}} / path;
+}
+
+// Counts the alignment records of a SAM/BAM file.
+size_t count_records(std::filesystem::path const & path)
+{
+    seqan3::sam_file_input input{path, seqan3::fields<seqan3::field::flag>{}};
+    size_t records = 0;
+    for (auto && record : input)
+    {
+        (void) record;
+        ++records;
+    }
+    return records;
+}
+
+double to_seconds(timeval const & time)
+{
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+// Executes the binary with the given arguments and returns its standard output. The standard error is discarded.
+std::string capture_output(std::filesystem::path const & binary, std::vector<std::string> const & arguments)
+{
+    std::array<int, 2> pipe_fds{};
+    if (pipe(pipe_fds.data()) != 0)
+        throw std::runtime_error{"Could not create a pipe for the stdout of iGenVar."};
+
+    pid_t const pid = fork();
+    if (pid < 0)
+        throw std::runtime_error{"Could not fork the benchmark process."};
+
+    if (pid == 0) // child: stdout is forwarded to the parent, stderr is discarded
+    {
+        int const null_fd = open("/dev/null", O_WRONLY);
+        dup2(pipe_fds[1], STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        close(null_fd);
+        close(pipe_fds[0]);
+        close(pipe_fds[1]);
+
+        std::vector<char *> argv{const_cast<char *>(binary.c_str())};
+        for (std::string const & argument : arguments)
+            argv.push_back(const_cast<char *>(argument.c_str()));
+        argv.push_back(nullptr);
+
+        setenv("SEQAN3_NO_VERSION_CHECK", "1", 1);
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+    close(pipe_fds[1]);
+
+    std::string output{};
+    std::array<char, 1 << 16> chunk{};
+    while (true)
+    {
+        ssize_t const count = read(pipe_fds[0], chunk.data(), chunk.size());
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            break;
+        output.append(chunk.data(), count);
+    }
+    close(pipe_fds[0]);
+
+    int status{};
+    if (waitpid(pid, &status, 0) < 0)
+        throw std::runtime_error{"Could not wait for the iGenVar process."};
+    return output;
+}
+
+// Returns whether the binary lists the option in its advanced help page, e.g. "--threads", which older versions of
+// iGenVar do not have.
+bool supports_option(std::filesystem::path const & binary, std::string const & option)
+{
+    return capture_output(binary, {"-hh"}).find("    " + option + " ") != std::string::npos;
+}
+
+// Reads the timings file written by iGenVar with --timings and returns the seconds by stage.
+std::map<std::string, double> read_timings(std::filesystem::path const & timings_file_path)
+{
+    std::ifstream timings_file{timings_file_path};
+    if (!timings_file.good())
+        throw std::runtime_error{"Could not open timings file '" + timings_file_path.string() + "' for reading."};
+
+    std::string line{};
+    std::getline(timings_file, line); // header "stage\tseconds"
+    std::map<std::string, double> stage_seconds{};
+    while (std::getline(timings_file, line))
+    {
+        size_t const tab = line.find('\t');
+        if (tab == std::string::npos)
+            throw std::runtime_error{"Malformed line in timings file: '" + line + "'."};
+        stage_seconds[line.substr(0, tab)] = std::stod(line.substr(tab + 1));
+    }
+    return stage_seconds;
+}
+
+// Executes the binary once and measures it.
+run_result execute(std::filesystem::path const & binary, std::vector<std::string> const & arguments)
+{
+    auto const start = std::chrono::steady_clock::now();
+    pid_t const pid = fork();
+    if (pid < 0)
+        throw std::runtime_error{"Could not fork the benchmark process."};
+
+    if (pid == 0) // child: stdout and stderr are discarded
+    {
+        int const null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        close(null_fd);
+
+        std::vector<char *> argv{const_cast<char *>(binary.c_str())};
+        for (std::string const & argument : arguments)
+            argv.push_back(const_cast<char *>(argument.c_str()));
+        argv.push_back(nullptr);
+
+        setenv("SEQAN3_NO_VERSION_CHECK", "1", 1);
+        execv(binary.c_str(), argv.data());
+        _exit(127);
+    }
+
+    int status{};
+    rusage usage{};
+    if (wait4(pid, &status, 0, &usage) < 0)
+        throw std::runtime_error{"Could not wait for the iGenVar process."};
+    double const wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw std::runtime_error{"iGenVar did not finish successfully (status " + std::to_string(status) + ")."};
+
+    run_result result{};
+    result.wall_seconds = wall_seconds;
+    result.user_seconds = to_seconds(usage.ru_utime);
+    result.system_seconds = to_seconds(usage.ru_stime);
+#ifdef __APPLE__
+    result.max_rss_kb = usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    result.max_rss_kb = usage.ru_maxrss;        // kilobytes on Linux
+#endif
+    return result;
+}
+
+// Returns the values of a result in the order of `columns`.
+std::vector<std::string> to_row(run_result const & result)
+{
+    auto fixed = [] (double const value)
+    {
+        std::ostringstream stream{};
+        stream << std::fixed << std::setprecision(4) << value;
+        return stream.str();
+    };
+    double const cpu_seconds = result.user_seconds + result.system_seconds;
+    std::vector<std::string> row{result.input,
+                                 std::to_string(result.file_size),
+                                 std::to_string(result.records),
+                                 std::to_string(result.threads),
+                                 fixed(result.wall_seconds),
+                                 fixed(result.user_seconds),
+                                 fixed(result.system_seconds),
+                                 fixed(cpu_seconds),
+                                 std::to_string(result.max_rss_kb),
+                                 fixed(result.wall_seconds > 0 ? result.records / result.wall_seconds : 0)};
+    for (std::string const & stage : stages)
+    {
+        auto const it = result.stage_seconds.find(stage);
+        row.push_back(it != result.stage_seconds.end() ? fixed(it->second) : "NA");
+    }
+    return row;
+}
+
+void print_table(std::vector<run_result> const & results, std::ostream & out_stream)
+{
+    for (size_t i = 0; i < columns.size(); ++i)
+        out_stream << columns[i] << (i + 1 < columns.size() ? '\t' : '\n');
+    for (run_result const & result : results)
+    {
+        std::vector<std::string> const row = to_row(result);
+        for (size_t i = 0; i < row.size(); ++i)
+            out_stream << row[i] << (i + 1 < row.size() ? '\t' : '\n');
+    }
+}
+
+// Reads a table written by print_table() and returns the rows by (input, threads).
+std::map<std::pair<std::string, std::string>, std::map<std::string, std::string>>
+read_baseline(std::filesystem::path const & baseline_file_path)
+{
+    std::ifstream baseline_file{baseline_file_path};
+    if (!baseline_file.good())
+        throw std::runtime_error{"Could not open baseline file '" + baseline_file_path.string() + "' for reading."};
+
+    auto split = [] (std::string const & line)
+    {
+        std::vector<std::string> fields{};
+        std::stringstream stream{line};
+        std::string field{};
+        while (std::getline(stream, field, '\t'))
+            fields.push_back(field);
+        return fields;
+    };
+
+    std::string line{};
+    std::getline(baseline_file, line);
+    std::vector<std::string> const header = split(line);
+    std::map<std::pair<std::string, std::string>, std::map<std::string, std::string>> baseline{};
+    while (std::getline(baseline_file, line))
+    {
+        std::vector<std::string> const fields = split(line);
+        std::map<std::string, std::string> row{};
+        for (size_t i = 0; i < std::min(header.size(), fields.size()); ++i)
+            row[header[i]] = fields[i];
+        baseline[{row["input"], row["threads"]}] = std::move(row);
+    }
+    return baseline;
+}
+
+// Compares wall time, CPU time and peak memory with the baseline. Returns false if any value got worse by more than
+// the tolerance.
+bool compare_with_baseline(std::vector<run_result> const & results,
+                           std::filesystem::path const & baseline_file_path,
+                           double const tolerance,
+                           std::ostream & out_stream)
+{
+    auto const baseline = read_baseline(baseline_file_path);
+    std::vector<std::string> const compared_columns{"wall_s", "cpu_s", "max_rss_kb"};
+    bool passed = true;
+
+    out_stream << "input\tthreads\tmetric\tbaseline\tcurrent\tratio\tstatus\n";
+    for (run_result const & result : results)
+    {
+        std::vector<std::string> const row = to_row(result);
+        auto const it = baseline.find({result.input, std::to_string(result.threads)});
+        if (it == baseline.end())
+        {
+            out_stream << result.input << '\t' << result.threads << "\t-\t-\t-\t-\tno baseline\n";
+            continue;
+        }
+        for (std::string const & column : compared_columns)
+        {
+            size_t const index = std::find(columns.begin(), columns.end(), column) - columns.begin();
+            auto const baseline_value = it->second.find(column);
+            if (baseline_value == it->second.end())
+                continue;
+            double const before = std::stod(baseline_value->second);
+            double const after = std::stod(row[index]);
+            double const ratio = before > 0 ? after / before : 1.0;
+            std::string status{"ok"};
+            if (ratio > 1.0 + tolerance)
+            {
+                status = "REGRESSION";
+                passed = false;
+            }
+            else if (ratio < 1.0 - tolerance)
+            {
+                status = "improved";
+            }
+            out_stream << result.input << '\t' << result.threads << '\t' << column << '\t' << baseline_value->second
+                       << '\t' << row[index] << '\t' << std::fixed << std::setprecision(3) << ratio << '\t' << status
+                       << '\n';
+        }
+    }
+    return passed;
+}
+
+void initialize_argument_parser(seqan3::argument_parser & parser, scaling_arguments & args)
+{
+    parser.info.app_name = "scaling_benchmark";
+    parser.info.short_description = "Measure how iGenVar scales with input size and number of threads.";
+    parser.info.description.push_back("Runs the iGenVar binary on each input with each number of threads and "
+                                      "reports wall time, CPU time, peak RSS, records per second and the wall "
+                                      "time of each stage as a tab-separated table. Inputs that do not exist as "
+                                      "given are looked up in the test data directory.");
+
+    parser.add_option(args.binary, '\0', "binary", "Path to the iGenVar binary.");
+    parser.add_option(args.short_reads_inputs, 'i', "input_short_reads",
+                      "Short read alignment files, passed to iGenVar with -i.");
+    parser.add_option(args.long_reads_inputs, 'j', "input_long_reads",
+                      "Long read alignment files, passed to iGenVar with -j.");
+    parser.add_option(args.threads, 't', "threads",
+                      "Numbers of threads to run iGenVar with. Values other than 1 are passed with --threads and "
+                      "skipped if the binary has no such option.");
+    parser.add_option(args.repetitions, 'r', "repetitions",
+                      "Number of repetitions per run. The run with the median wall time is reported.",
+                      seqan3::option_spec::standard, seqan3::arithmetic_range_validator{1, 1000});
+    parser.add_option(args.output_file_path, 'o', "output",
+                      "Write the table to this file instead of standard output.");
+    parser.add_option(args.baseline_file_path, 'b', "baseline",
+                      "A table of a previous run to compare the results with.");
+    parser.add_option(args.tolerance, '\0', "tolerance",
+                      "Relative slow-down that is tolerated before a value is reported as regression.");
+}
+
+int main(int argc, char ** argv)
+{
+    seqan3::argument_parser parser{"scaling_benchmark", argc, argv, seqan3::update_notifications::off};
+    scaling_arguments args{};
+    initialize_argument_parser(parser, args);
+
+    try
+    {
+        parser.parse();
+    }
+    catch (seqan3::argument_parser_error const & ext)
+    {
+        std::cerr << "[Error] " << ext.what() << '\n';
+        return -1;
+    }
+
+    // Use the registered test data if no input was given.
+    if (args.short_reads_inputs.empty() && args.long_reads_inputs.empty())
+    {
+        args.short_reads_inputs = {"paired_end_mini_example.sam"};
+        args.long_reads_inputs = {"single_end_mini_example.sam", "simulated.minimap2.hg19.coordsorted_cutoff.sam"};
+    }
+
+    std::vector<std::pair<std::string, std::string>> inputs{};  // (iGenVar option, file)
+    for (std::string const & input : args.short_reads_inputs)
+        inputs.emplace_back("-i", input);
+    for (std::string const & input : args.long_reads_inputs)
+        inputs.emplace_back("-j", input);
+
+    // Measure inputs of increasing size.
+    std::sort(inputs.begin(), inputs.end(), [] (auto const & lhs, auto const & rhs)
+    {
+        return std::filesystem::file_size(resolve_input(lhs.second)) <
+               std::filesystem::file_size(resolve_input(rhs.second));
+    });
+
+    std::filesystem::path const vcf_path = std::filesystem::temp_directory_path() /
+                                           ("scaling_benchmark_" + std::to_string(getpid()) + ".vcf");
+    std::filesystem::path const timings_path = std::filesystem::temp_directory_path() /
+                                               ("scaling_benchmark_" + std::to_string(getpid()) + ".tsv");
+    std::vector<run_result> results{};
+    try
+    {
+        bool const has_timings = supports_option(args.binary, "--timings");
+        if (!has_timings)
+            std::cerr << "The binary has no --timings option, the stage columns are NA.\n";
+
+        // Older binaries run single-threaded only, the sweep is restricted to the options they have.
+        bool const is_multi_threaded = std::any_of(args.threads.begin(),
+                                                   args.threads.end(),
+                                                   [] (uint32_t const threads) { return threads != 1; });
+        if (is_multi_threaded && !supports_option(args.binary, "--threads"))
+        {
+            std::cerr << "The binary has no --threads option, only runs with 1 thread are measured.\n";
+            args.threads = {1};
+        }
+
+        for (auto const & [option, input] : inputs)
+        {
+            std::filesystem::path const input_path = resolve_input(input);
+            size_t const records = count_records(input_path);
+
+            for (uint32_t const threads : args.threads)
+            {
+                std::vector<std::string> arguments{option, input_path.string(), "-o", vcf_path.string()};
+                if (threads != 1)
+                {
+                    arguments.push_back("--threads");
+                    arguments.push_back(std::to_string(threads));
+                }
+                if (has_timings)
+                {
+                    arguments.push_back("--timings");
+                    arguments.push_back(timings_path.string());
+                }
+
+                std::vector<run_result> repetitions{};
+                for (uint32_t repetition = 0; repetition < args.repetitions; ++repetition)
+                {
+                    repetitions.push_back(execute(args.binary, arguments));
+                    if (has_timings)
+                        repetitions.back().stage_seconds = read_timings(timings_path);
+                }
+                std::sort(repetitions.begin(), repetitions.end(), [] (auto const & lhs, auto const & rhs)
+                {
+                    return lhs.wall_seconds < rhs.wall_seconds;
+                });
+
+                run_result result = repetitions[repetitions.size() / 2];
+                result.input = input_path.filename().string();
+                result.file_size = std::filesystem::file_size(input_path);
+                result.records = records;
+                result.threads = threads;
+                results.push_back(std::move(result));
+                std::cerr << "Measured " << input << " with " << threads << " thread(s).\n";
+            }
+        }
+    }
+    catch (std::exception const & ext)
+    {
+        std::cerr << "[Error] " << ext.what() << '\n';
+        std::filesystem::remove(vcf_path);
+        std::filesystem::remove(timings_path);
+        return -1;
+    }
+    std::filesystem::remove(vcf_path);
+    std::filesystem::remove(timings_path);
+
+    if (args.output_file_path.empty())
+    {
+        print_table(results, std::cout);
+    }
+    else
+    {
+        std::ofstream out_file{args.output_file_path};
+        print_table(results, out_file);
+    }
+
+    if (!args.baseline_file_path.empty())
+    {
+        std::cout << '\n';
+        if (!compare_with_baseline(results, args.baseline_file_path, args.tolerance, std::cout))
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "structures/quantile_sketch.hpp"   // for class QuantileSketch
+
+/* -------- insert size sketch benchmarks -------- */
+
+// Generates normally distributed insert sizes (mean 400 bp, standard deviation 50 bp).
+static std::vector<uint64_t> generate_insert_sizes(size_t const number_of_pairs)
+{
+    std::mt19937 generator{42};
+    std::normal_distribution<double> insert_size_distribution{400.0, 50.0};
+    std::vector<uint64_t> insert_sizes(number_of_pairs);
+    for (uint64_t & insert_size : insert_sizes)
+        insert_size = std::max<int64_t>(0, std::llround(insert_size_distribution(generator)));
+    return insert_sizes;
+}
+
+// Argument: number of pairs. Reports the memory of the sketch and the largest relative error of the quartiles and the
+// 1st and 99th percentile.
+static void quantile_sketch_add_benchmark(benchmark::State & state)
+{
+    std::vector<uint64_t> const insert_sizes = generate_insert_sizes(state.range(0));
+    QuantileSketch sketch{};
+
+    for (auto _ : state)
+    {
+        sketch = QuantileSketch{};
+        for (uint64_t const insert_size : insert_sizes)
+            sketch.add(insert_size);
+        benchmark::DoNotOptimize(sketch.size());
+    }
+
+    std::vector<uint64_t> sorted_insert_sizes{insert_sizes};
+    std::sort(sorted_insert_sizes.begin(), sorted_insert_sizes.end());
+    double max_relative_error = 0;
+    for (double const q : {0.01, 0.25, 0.5, 0.75, 0.99})
+    {
+        double const exact = sorted_insert_sizes[static_cast<size_t>(q * (sorted_insert_sizes.size() - 1))];
+        max_relative_error = std::max(max_relative_error, std::abs(sketch.quantile(q) - exact) / exact);
+    }
+
+    state.counters["sketch_bytes"] = sketch.memory_usage();
+    state.counters["exact_bytes"] = insert_sizes.size() * sizeof(uint64_t);
+    state.counters["max_rel_error"] = max_relative_error;
+    state.counters["pairs/s"] = benchmark::Counter(state.iterations() * insert_sizes.size(),
+                                                   benchmark::Counter::kIsRate);
+}
+BENCHMARK(quantile_sketch_add_benchmark)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+// Argument: number of pairs.
+static void quantile_sketch_quantile_benchmark(benchmark::State & state)
+{
+    QuantileSketch sketch{};
+    for (uint64_t const insert_size : generate_insert_sizes(state.range(0)))
+        sketch.add(insert_size);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sketch.quantile(0.25));
+        benchmark::DoNotOptimize(sketch.quantile(0.75));
+    }
+}
+BENCHMARK(quantile_sketch_quantile_benchmark)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_MAIN();
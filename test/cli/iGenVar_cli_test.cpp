@@ -37,6 +37,31 @@ std::string const help_page_part_1
     "          Input long read alignments in SAM or BAM format (PacBio, Oxford\n"
     "          Nanopore, ...). Default: \"\". The input file must exist and read\n"
     "          permissions must be granted. Valid file extensions are: [sam, bam].\n"
+    "    --sample_short_reads (List of std::filesystem::path)\n"
+    "          Input short read alignments of a further sample in SAM or BAM\n"
+    "          format. Can be given several times, once per sample. All samples are\n"
+    "          called jointly. A sample is named after its file, a long read file\n"
+    "          with the same name belongs to the same sample. Default: []. The\n"
+    "          input file must exist and read permissions must be granted. Valid\n"
+    "          file extensions are: [sam, bam].\n"
+    "    --sample_long_reads (List of std::filesystem::path)\n"
+    "          Input long read alignments of a further sample in SAM or BAM format.\n"
+    "          Can be given several times, once per sample. All samples are called\n"
+    "          jointly. A sample is named after its file, a short read file with\n"
+    "          the same name belongs to the same sample. Default: []. The input\n"
+    "          file must exist and read permissions must be granted. Valid file\n"
+    "          extensions are: [sam, bam].\n"
+    "    -g, --genome (std::filesystem::path)\n"
+    "          Reference genome in FASTA format, optionally indexed with samtools\n"
+    "          faidx. It is used for the REF column of the vcf output file.\n"
+    "          Default: \"\". The input file must exist and read permissions must be\n"
+    "          granted. Valid file extensions are: [fa, fasta, fna].\n"
+    "    --exclude (std::filesystem::path)\n"
+    "          Regions in BED format, e.g. centromeres and satellite arrays.\n"
+    "          Alignments that start in these regions are not analyzed and\n"
+    "          junctions with a breakend in them are dropped. Default: \"\". The\n"
+    "          input file must exist and read permissions must be granted. Valid\n"
+    "          file extensions are: [bed].\n"
     "    -o, --output (std::filesystem::path)\n"
     "          The path of the vcf output file. If no path is given, will output to\n"
     "          standard output. Default: \"\". Write permissions must be granted.\n"
@@ -69,7 +94,7 @@ std::string const help_page_advanced
     "          Choose the detection method(s) to be used. Default:\n"
     "          [cigar_string,split_read,read_pairs,read_depth]. Value must be one\n"
     "          of (method name or number)\n"
-    "          [cigar_string,0,split_read,1,read_pairs,2,read_depth,3].\n"
+    "          [cigar_string,0,split_read,1,read_pairs,2,read_depth,3,4,soft_clips].\n"
     "    -c, --clustering_method (clustering_methods)\n"
     "          Choose the clustering method to be used. Default: simple_clustering.\n"
     "          Value must be one of (method name or number)\n"
@@ -88,6 +113,45 @@ std::string const help_page_advanced
     "    -t, --max_tol_inserted_length (unsigned 64 bit integer)\n"
     "          Specify what should be the longest tolerated inserted sequence at\n"
     "          sites of non-INS SVs (default 5 bp). Default: 5.\n"
+    "    --max_consensus_members (unsigned 64 bit integer)\n"
+    "          Specify the maximum number of inserted sequences of an insertion\n"
+    "          that are aligned to compute its sequence for the ALT column. If 0,\n"
+    "          no consensus is computed and the ALT column is <INS>. Default: 0.\n"
+    "          Value must be in range [0,1000].\n"
+    "    --max_insert_size (unsigned 64 bit integer)\n"
+    "          Specify the maximum insert size of the read pairs of a read group\n"
+    "          during its warm-up. Read pairs whose mates lie further apart are\n"
+    "          discordant. Default: 1000.\n"
+    "    --warm_up_pairs (unsigned 64 bit integer)\n"
+    "          Specify the number of proper read pairs of a read group after which\n"
+    "          its maximum insert size is learned from their template lengths.\n"
+    "          Default: 10000.\n"
+    "    --genotype\n"
+    "          Count the reads that span the breakpoints without supporting the\n"
+    "          variant and output the genotype of the sample.\n"
+    "    --max_depth (unsigned 32 bit integer)\n"
+    "          Specify the read depth above which the alignments are downsampled\n"
+    "          deterministically by a hash of their read names. The read support of\n"
+    "          the variants is rescaled in the output. If 0, no alignments are\n"
+    "          downsampled. Default: 1000.\n"
+    "    --threads (unsigned 16 bit integer)\n"
+    "          Specify the number of threads used for the detection and clustering\n"
+    "          of junctions, the refinement methods, the insertion consensus and\n"
+    "          the output. Default: 1. Value must be in range [1,1024].\n"
+    "    --read_ahead_blocks (unsigned 32 bit integer)\n"
+    "          Specify the number of blocks of each alignment file that are read\n"
+    "          ahead by an additional thread, e.g. for files on network-attached\n"
+    "          storage. The time spent waiting for the blocks is reported. If 0,\n"
+    "          the files are read without read-ahead. Default: 0. Value must be in\n"
+    "          range [0,1024].\n"
+    "    --read_ahead_block_size (unsigned 32 bit integer)\n"
+    "          Specify the size of the blocks that are read ahead in KiB. Default:\n"
+    "          4096. Value must be in range [4,1048576].\n"
+    "    --timings (std::filesystem::path)\n"
+    "          The path of a tab-separated file to which the wall time of each\n"
+    "          stage (detection, clustering, refinement, consensus, genotyping and\n"
+    "          output) is written in seconds, e.g. for benchmarks. Default: \"\".\n"
+    "          Write permissions must be granted. Valid file extensions are: [tsv].\n"
 };
 
 // std::string expected_res_default
@@ -227,13 +291,9 @@ TEST_F(iGenVar_cli_test, with_default_arguments)
     {
         "Detect junctions in long reads...\n"
         "INS: chr21\t41972615\tForward\tchr21\t41972616\tForward\t1681\tm2257/8161/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "BND: chr21\t41972615\tReverse\tchr22\t17458417\tReverse\t2\tm41327/11677/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "BND: chr21\t41972616\tReverse\tchr22\t17458418\tReverse\t0\tm21263/13017/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "BND: chr21\t41972616\tReverse\tchr22\t17458418\tReverse\t0\tm38637/7161/CCS\n"
-        "The read depth method for long reads is not yet implemented.\n"
         "Start clustering...\n"
         "Done with clustering. Found 3 junction clusters.\n"
         "No refinement was selected.\n"
@@ -268,6 +328,84 @@ TEST_F(iGenVar_cli_test, with_detection_method_arguments)
     EXPECT_EQ(result.err, expected_err_default_no_err);
 }
 
+TEST_F(iGenVar_cli_test, test_genotype)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "-m 0 -m 1 --genotype");
+    // The only read at the insertion supports it.
+    std::string expected_res
+    {
+        "##fileformat=VCFv4.3\n"
+        "##source=iGenVarCaller\n"
+        "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=SVLEN,Number=1,Type=Integer,Description=\"Length of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+        "##FORMAT=<ID=DR,Number=1,Type=Integer,Description=\"Number of reads supporting the reference\">\n"
+        "##FORMAT=<ID=DV,Number=1,Type=Integer,Description=\"Number of reads supporting the variant\">\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tsimulated.minimap2.hg19.coordsorted_cutoff\n"
+        "chr21\t41972616\t.\tN\t<INS>\t1\tPASS\tEND=41972616;SVLEN=1681;SVTYPE=INS\tGT:DR:DV\t1/1:0:1\n"
+    };
+    std::string expected_err = expected_err_default_no_err
+                             + "Counted the reads supporting the reference at 1 breakpoints.\n";
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, expected_res);
+    EXPECT_EQ(result.err, expected_err);
+}
+
+TEST_F(iGenVar_cli_test, test_joint_samples)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data("single_end_mini_example.sam"),
+                                         "--sample_long_reads", data("refinement_mini_example.sam"),
+                                         "-l 8 -m 0 -m 1");
+    // The deletion at 297 and the insertion at 1004 are only found in the reads of the second sample.
+    std::string expected_res
+    {
+        "##fileformat=VCFv4.3\n"
+        "##source=iGenVarCaller\n"
+        "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=SVLEN,Number=1,Type=Integer,Description=\"Length of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##FORMAT=<ID=DV,Number=1,Type=Integer,Description=\"Number of reads supporting the variant\">\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\tsingle_end_mini_example\trefinement_mini_example\n"
+        "chr1\t57\t.\tN\t<DEL>\t9\tPASS\tEND=70;SVLEN=-13;SVTYPE=DEL\tDV\t9\t0\n"
+        "chr1\t99\t.\tN\t<DEL>\t1\tPASS\tEND=125;SVLEN=-26;SVTYPE=DEL\tDV\t1\t0\n"
+        "chr1\t125\t.\tN\t<INS>\t3\tPASS\tEND=125;SVLEN=15;SVTYPE=INS\tDV\t3\t0\n"
+        "chr1\t180\t.\tN\t<INS>\t1\tPASS\tEND=180;SVLEN=8;SVTYPE=INS\tDV\t1\t0\n"
+        "chr1\t266\t.\tN\t<DEL>\t2\tPASS\tEND=286;SVLEN=-20;SVTYPE=DEL\tDV\t2\t0\n"
+        "chr1\t267\t.\tN\t<DEL>\t2\tPASS\tEND=287;SVLEN=-20;SVTYPE=DEL\tDV\t2\t0\n"
+        "chr1\t282\t.\tN\t<DEL>\t1\tPASS\tEND=299;SVLEN=-17;SVTYPE=DEL\tDV\t1\t0\n"
+        "chr1\t297\t.\tN\t<DEL>\t3\tPASS\tEND=317;SVLEN=-20;SVTYPE=DEL\tDV\t0\t3\n"
+        "chr1\t336\t.\tN\t<DEL>\t4\tPASS\tEND=350;SVLEN=-14;SVTYPE=DEL\tDV\t4\t0\n"
+        "chr1\t1004\t.\tN\t<INS>\t3\tPASS\tEND=1004;SVLEN=15;SVTYPE=INS\tDV\t0\t3\n"
+    };
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, expected_res);
+    EXPECT_NE(result.err.find("Detect junctions in long reads of sample single_end_mini_example...\n"),
+              std::string::npos);
+    EXPECT_NE(result.err.find("Detect junctions in long reads of sample refinement_mini_example...\n"),
+              std::string::npos);
+}
+
+TEST_F(iGenVar_cli_test, fail_joint_samples_with_the_same_name)
+{
+    // The samples are named after their files, so the same file can not be given for two samples.
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "--sample_long_reads", data(default_alignment_long_reads_file_path),
+                                         "-m 0 -m 1");
+    std::string expected_err
+    {
+        "[Error] Two samples would be named 'simulated.minimap2.hg19.coordsorted_cutoff'. The samples are named after "
+        "their alignment files, only the short and long reads of a further sample may share their name.\n"
+    };
+    EXPECT_NE(result.exit_code, 0);
+    EXPECT_EQ(result.out, std::string{});
+    EXPECT_EQ(result.err, expected_err);
+}
+
 TEST_F(iGenVar_cli_test, with_detection_method_duplicate_arguments)
 {
     cli_test_result result = execute_app("iGenVar",
@@ -293,6 +431,27 @@ TEST_F(iGenVar_cli_test, test_direct_methods_input)
     EXPECT_EQ(result.err, expected_err_default_no_err);
 }
 
+TEST_F(iGenVar_cli_test, test_sViper_refinement_without_genome)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data(default_alignment_long_reads_file_path),
+                                         "-m 0 -m 1 -r 1 --threads 2");
+    std::string expected_err
+    {
+        "Detect junctions in long reads...\n"
+        "INS: chr21\t41972615\tForward\tchr21\t41972616\tForward\t1681\tm2257/8161/CCS\n"
+        "BND: chr21\t41972615\tReverse\tchr22\t17458417\tReverse\t2\tm41327/11677/CCS\n"
+        "BND: chr21\t41972616\tReverse\tchr22\t17458418\tReverse\t0\tm21263/13017/CCS\n"
+        "BND: chr21\t41972616\tReverse\tchr22\t17458418\tReverse\t0\tm38637/7161/CCS\n"
+        "Start clustering...\n"
+        "Done with clustering. Found 3 junction clusters.\n"
+        "The sViper refinement method needs a reference genome (-g). No refinement was done.\n"
+    };
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, expected_res_default);
+    EXPECT_EQ(result.err, expected_err);
+}
+
 TEST_F(iGenVar_cli_test, test_unknown_argument)
 {
     cli_test_result result = execute_app("iGenVar",
@@ -301,7 +460,7 @@ TEST_F(iGenVar_cli_test, test_unknown_argument)
     std::string expected_err
     {
         "[Error] You have chosen an invalid input value: 9. "
-        "Please use one of: [0,cigar_string,1,split_read,2,read_pairs,3,read_depth]\n"
+        "Please use one of: [0,cigar_string,1,split_read,2,read_pairs,3,read_depth,4,soft_clips]\n"
     };
     EXPECT_EQ(result.exit_code, 65280);
     EXPECT_EQ(result.out, std::string{});
@@ -324,42 +483,6 @@ TEST_F(iGenVar_cli_test, dataset_paired_end_mini_example)
     std::string expected_err
     {
         "Detect junctions in short reads...\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
-        "The read pair method is not yet implemented.\n"
         "Start clustering...\n"
         "No junctions found...\n"
         "Done with clustering. Found 0 junction clusters.\n"
@@ -394,3 +517,67 @@ TEST_F(iGenVar_cli_test, dataset_single_end_mini_example)
     EXPECT_EQ(result.err, output_err_str);
     seqan3::debug_stream << "done. " << '\n';
 }
+
+TEST_F(iGenVar_cli_test, dataset_single_end_mini_example_with_genome)
+{
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data("single_end_mini_example.sam"),
+                                         "-g", data("mini_example_reference.fasta"),
+                                         "-l 8 -m 0 -m 1");
+
+    // The REF column contains the base before each variant.
+    std::string expected_res
+    {
+        "##fileformat=VCFv4.3\n"
+        "##source=iGenVarCaller\n"
+        "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=SVLEN,Number=1,Type=Integer,Description=\"Length of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n"
+        "chr1\t57\t.\tT\t<DEL>\t9\tPASS\tEND=70;SVLEN=-13;SVTYPE=DEL\n"
+        "chr1\t99\t.\tG\t<DEL>\t1\tPASS\tEND=125;SVLEN=-26;SVTYPE=DEL\n"
+        "chr1\t125\t.\tG\t<INS>\t3\tPASS\tEND=125;SVLEN=15;SVTYPE=INS\n"
+        "chr1\t180\t.\tG\t<INS>\t1\tPASS\tEND=180;SVLEN=8;SVTYPE=INS\n"
+        "chr1\t266\t.\tT\t<DEL>\t2\tPASS\tEND=286;SVLEN=-20;SVTYPE=DEL\n"
+        "chr1\t267\t.\tC\t<DEL>\t2\tPASS\tEND=287;SVLEN=-20;SVTYPE=DEL\n"
+        "chr1\t282\t.\tA\t<DEL>\t1\tPASS\tEND=299;SVLEN=-17;SVTYPE=DEL\n"
+        "chr1\t336\t.\tT\t<DEL>\t4\tPASS\tEND=350;SVLEN=-14;SVTYPE=DEL\n"
+    };
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, expected_res);
+}
+
+TEST_F(iGenVar_cli_test, dataset_refinement_mini_example)
+{
+    // The CIGAR strings place the deletion 3 bases left and the insertion 4 bases right of their true positions.
+    std::string const header
+    {
+        "##fileformat=VCFv4.3\n"
+        "##source=iGenVarCaller\n"
+        "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=SVLEN,Number=1,Type=Integer,Description=\"Length of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of SV called.\",Source=\"iGenVarCaller\",Version=\"1.0\">\n"
+        "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n"
+    };
+
+    cli_test_result result = execute_app("iGenVar",
+                                         "-j", data("refinement_mini_example.sam"),
+                                         "-g", data("refinement_mini_example_reference.fasta"),
+                                         "-l 10 -m 0");
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, header +
+                          "chr1\t297\t.\tG\t<DEL>\t3\tPASS\tEND=317;SVLEN=-20;SVTYPE=DEL\n"
+                          "chr1\t1004\t.\tA\t<INS>\t3\tPASS\tEND=1004;SVLEN=15;SVTYPE=INS\n");
+
+    // Realigning the reads moves both variants to their true positions.
+    result = execute_app("iGenVar",
+                         "-j", data("refinement_mini_example.sam"),
+                         "-g", data("refinement_mini_example_reference.fasta"),
+                         "-l 10 -m 0 -r 1");
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_EQ(result.out, header +
+                          "chr1\t300\t.\tA\t<DEL>\t3\tPASS\tEND=320;SVLEN=-20;SVTYPE=DEL\n"
+                          "chr1\t1000\t.\tC\t<INS>\t3\tPASS\tEND=1000;SVLEN=15;SVTYPE=INS\n");
+    EXPECT_NE(result.err.find("Refined 2 of 2 deletion and insertion clusters by realigning the reads.\n"),
+              std::string::npos);
+}
@@ -21,6 +21,11 @@ declare_datasource (FILE single_end_mini_example.sam
                     URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/single_end_mini_example.sam
                     URL_HASH SHA256=ea89fb00c802e5136ca8dd32362648c8192652a34078bfa25b8ae78695a27cd6)
 
+# copies file to <build>/data/mini_example_reference.fasta
+declare_datasource (FILE mini_example_reference.fasta
+                    URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/mini_example_reference.fasta
+                    URL_HASH SHA256=023c42f7f9a73e578f1dc2dc95795b0d6bbdc10b16763c2be7d2d6d155f85bc4)
+
 # copies file to <build>/data/output_err.txt
 declare_datasource (FILE output_err.txt
                     URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/output_err.txt
@@ -30,3 +35,14 @@ declare_datasource (FILE output_err.txt
 declare_datasource (FILE output_res.txt
                     URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/output_res.txt
                     URL_HASH SHA256=cb5d391e58a8ffecf3bed3470bfc2f62c40d490c9270c55832e16cbfe2a5bbb1)
+
+# copies file to <build>/data/refinement_mini_example.sam
+# A deletion and an insertion whose CIGAR strings place them a few bases off their true position.
+declare_datasource (FILE refinement_mini_example.sam
+                    URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/refinement_mini_example.sam
+                    URL_HASH SHA256=96b87687f45dabc48ca72a226f77e2327c430e71a124255785f94a86483cc6e9)
+
+# copies file to <build>/data/refinement_mini_example_reference.fasta
+declare_datasource (FILE refinement_mini_example_reference.fasta
+                    URL ${CMAKE_SOURCE_DIR}/test/data/mini_example/refinement_mini_example_reference.fasta
+                    URL_HASH SHA256=8fc4743c7673e4745e2c590a1dc4c8099510a5d0c4a91e28cc738f45da258eaf)
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>   // for std::string
+#include <tuple>    // for std::get
+#include <vector>   // for std::vector
+
+#include "modules/sv_detection_methods/analyze_sa_tag_method.hpp"   // for split_string()
+#include "structures/aligned_segment.hpp"                           // for struct AlignedSegment
+#include "variant_detection/bam_functions.hpp"                      // for parse_cigar()
+
+/*! \brief The stringstream based SA tag parser that was used before retrieve_aligned_segments() parsed in a single
+ *         pass. It is kept as reference for the equivalence tests and the detection benchmark.
+ *
+ * \param[in]       sa_string           - "SA" tag string
+ * \param[in, out]  aligned_segments    - vector of [aligned_segments](\ref AlignedSegment)
+ */
+inline void retrieve_aligned_segments_legacy(std::string const & sa_string,
+                                             std::vector<AlignedSegment> & aligned_segments)
+{
+    std::vector<std::string> sa_tags{};
+    split_string(sa_string, sa_tags, ';');
+    for (std::string sa_tag : sa_tags)
+    {
+        std::vector<std::string> fields {};
+        split_string(sa_tag, fields, ',');
+        if (fields.size() == 6)
+        {
+            strand orientation;
+            if (fields[2] == "+")
+                orientation = strand::forward;
+            else if (fields[2] == "-")
+                orientation = strand::reverse;
+            else
+                continue;
+            std::vector<seqan3::cigar> cigar_vector = std::get<0>(parse_cigar(fields[3]));
+            aligned_segments.push_back(AlignedSegment{orientation, fields[0], std::stoi(fields[1]),
+                                                      std::stoi(fields[4]), cigar_vector});
+        }
+    }
+}